@@ -9,6 +9,8 @@
 #include "Modules.hpp"
 #include "Processes.hpp"
 
+#include <unistd.h>
+
 using namespace apostol;
 
 class CSApp final : public Application
@@ -16,9 +18,18 @@ class CSApp final : public Application
 public:
     CSApp() : Application("cs") {}
 
+    ~CSApp()
+    {
+        // Forked workers inherit master_ but do not own the shared state
+        if (master_ == ::getpid())
+            cleanup_workers(*this);
+    }
+
 protected:
     void create_custom_processes() override
     {
+        master_ = ::getpid();
+        prepare_workers(*this);
         create_processes(*this);
     }
 
@@ -38,6 +49,9 @@ protected:
         start_http_server(loop, settings().server_port);
         logger().info("worker ready (pid={}, port={})", ::getpid(), http_port());
     }
+
+private:
+    pid_t master_ = 0;
 };
 
 int main(int argc, char* argv[])
@@ -17,8 +17,13 @@
 #include "ocpp/time_utils.hpp"
 
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
-#include <unordered_set>
+#include <iterator>
+
+#include <sys/ioctl.h>
+#include <sys/socket.h>
 
 namespace apostol
 {
@@ -27,11 +32,56 @@ using json = nlohmann::json;
 
 static constexpr auto kCleanupInterval = std::chrono::milliseconds(5000);
 
+// Extra time a forwarding worker waits beyond the owner's own call timeout
+static constexpr auto kForwardGrace = std::chrono::seconds(5);
+
+// How long a REST caller waits for the station's answer to a command
+static constexpr std::chrono::milliseconds kDefaultCommandTimeout = std::chrono::seconds(30);
+
+// Most entries one journal export returns, and journal bytes it may scan: the
+// export runs on the worker's event loop
+static constexpr std::size_t kJournalExportLimit = 100000;
+static constexpr std::size_t kJournalExportScan  = 64 * 1024 * 1024;
+
+// Most messages in one ocpp.parse() batch statement
+static constexpr std::size_t kMaxParseBatch = 1000;
+
+// Built-in per-action timeouts; commands.timeouts overrides them
+static constexpr std::pair<ocpp::Action, std::chrono::milliseconds> kCommandTimeouts[] = {
+    {ocpp::Action::GetDiagnostics, std::chrono::seconds(120)},
+    {ocpp::Action::GetLog,         std::chrono::seconds(120)},
+    {ocpp::Action::TriggerMessage, std::chrono::seconds(10)},
+};
+
 // ── Helpers ─────────────────────────────────────────────────────────────────
 
 namespace
 {
 
+// ["Heartbeat", "MeterValues", ...] -> ActionSet; unknown names are skipped
+void load_action_set(const json& list, std::string_view section, ocpp::ActionSet& actions)
+{
+    actions.reset();
+    for (const auto& a : list) {
+        auto action = ocpp::action_from_string(a.get<std::string>());
+        if (action == ocpp::Action::Unknown)
+            global_logger().warn("{}: unknown action '{}'", section, a.get<std::string>());
+        else
+            actions.set(ocpp::action_index(action));
+    }
+}
+
+// Batching section shared by postgres.batch and webhook.batch:
+// {"enable": true, "window": 10, "size": 50, "actions": [...]}
+void load_batch_config(const json& batch, std::string_view section, BatchConfig& config)
+{
+    config.enabled = batch.value("enable", false);
+    config.window  = std::chrono::milliseconds(batch.value("window", 10));
+    config.size    = std::max<std::size_t>(1, batch.value("size", std::size_t{50}));
+    if (batch.contains("actions") && batch["actions"].is_array())
+        load_action_set(batch["actions"], section, config.actions);
+}
+
 // Split path into components: "/a/b/c" -> ["a", "b", "c"]
 std::vector<std::string_view> split_path(std::string_view path)
 {
@@ -47,6 +97,174 @@ std::vector<std::string_view> split_path(std::string_view path)
     return parts;
 }
 
+#ifdef WITH_POSTGRESQL
+
+// Append @p value as a SQL string literal (single pass, same rules as
+// PQescapeLiteral: quotes doubled, E'' form when backslashes are present).
+void append_pg_literal(std::string& sql, std::string_view value)
+{
+    if (value.find('\\') != std::string_view::npos)
+        sql += 'E';
+
+    sql += '\'';
+    for (char c : value) {
+        if (c == '\0') continue;
+        if (c == '\'' || c == '\\') sql += c;
+        sql += c;
+    }
+    sql += '\'';
+}
+
+// Append @p value dollar-quoted ($ocpp$...$ocpp$). The body is copied as-is —
+// no escaping pass — so large JSON payloads are copied exactly once. The tag is
+// extended until it occurs neither in the value nor across its end and the
+// closing tag (a value ending in "$ocpp" would close at "$ocpp$ocpp$"), which
+// rules out injection.
+void append_pg_dollar_quoted(std::string& sql, std::string_view value)
+{
+    auto clashes = [value](const std::string& tag) {
+        if (value.find(tag) != std::string_view::npos)
+            return true;
+        const auto keep = std::min(value.size(), tag.size() - 1);
+        std::string tail(value.substr(value.size() - keep));
+        tail += tag;
+        return tail.find(tag) != keep;
+    };
+
+    std::string tag = "$ocpp$";
+    for (int n = 1; clashes(tag); ++n)
+        tag = fmt::format("$ocpp{}$", n);
+
+    sql += tag;
+    if (value.find('\0') == std::string_view::npos) {
+        sql += value;
+    } else {
+        for (char c : value)
+            if (c != '\0') sql += c;
+    }
+    sql += tag;
+}
+
+// ocpp.parse(identity, uniqueId, action, payload::jsonb, account, version)
+std::string make_parse_call(std::string_view identity, std::string_view unique_id,
+                           std::string_view action, std::string_view payload,
+                           std::string_view account, std::string_view version)
+{
+    std::string sql;
+    sql.reserve(payload.size() + identity.size() + unique_id.size() + action.size() +
+                account.size() + 64);
+
+    sql += "ocpp.parse(";
+    append_pg_literal(sql, identity);
+    sql += ", ";
+    append_pg_literal(sql, unique_id);
+    sql += ", ";
+    append_pg_literal(sql, action);
+    sql += ", ";
+    append_pg_dollar_quoted(sql, payload);
+    sql += "::jsonb, ";
+    append_pg_literal(sql, account);
+    sql += ", ";
+    append_pg_literal(sql, version);
+    sql += ')';
+
+    return sql;
+}
+
+#endif // WITH_POSTGRESQL
+
+
+// OCPP 1.6 CS→CP operations accepted by the REST API (whitelist)
+constexpr bool is_command_16(ocpp::Action action)
+{
+    using ocpp::Action;
+    switch (action) {
+    case Action::CancelReservation:
+    case Action::ChangeAvailability:
+    case Action::ChangeConfiguration:
+    case Action::ClearCache:
+    case Action::ClearChargingProfile:
+    case Action::DataTransfer:
+    case Action::GetCompositeSchedule:
+    case Action::GetConfiguration:
+    case Action::GetDiagnostics:
+    case Action::GetLocalListVersion:
+    case Action::RemoteStartTransaction:
+    case Action::RemoteStopTransaction:
+    case Action::ReserveNow:
+    case Action::Reset:
+    case Action::SendLocalList:
+    case Action::SetChargingProfile:
+    case Action::TriggerMessage:
+    case Action::UnlockConnector:
+    case Action::UpdateFirmware:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Supported OCPP 2.0.1 CSMS→CS operations
+constexpr bool is_command_201(ocpp::Action action)
+{
+    using ocpp::Action;
+    switch (action) {
+    case Action::RequestStartTransaction:
+    case Action::RequestStopTransaction:
+    case Action::Reset:
+    case Action::SetVariables:
+    case Action::GetVariables:
+    case Action::ChangeAvailability:
+    case Action::DataTransfer:
+    case Action::GetBaseReport:
+    case Action::GetReport:
+    case Action::UnlockConnector:
+    case Action::TriggerMessage:
+    case Action::ClearCache:
+    case Action::GetTransactionStatus:
+    case Action::SendLocalList:
+    case Action::GetLocalListVersion:
+    case Action::CancelReservation:
+    case Action::ReserveNow:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Multi-worker routing: on by default with more than one worker
+struct ClusterConfig {
+    bool        enabled = false;
+    std::size_t capacity = 65536;
+};
+
+ClusterConfig cluster_config(const nlohmann::json& cfg)
+{
+    std::size_t workers = cfg.value("workers", std::size_t{1});
+    if (cfg.contains("main"))
+        workers = cfg["main"].value("workers", workers);
+
+    ClusterConfig cluster;
+    cluster.enabled = workers > 1;
+    if (cfg.contains("cluster")) {
+        cluster.enabled  = cfg["cluster"].value("enable", cluster.enabled);
+        cluster.capacity = cfg["cluster"].value("capacity", cluster.capacity);
+    }
+    return cluster;
+}
+
+// Bytes the kernel can still take for @p fd before send() would block and
+// the WebSocket layer start buffering in user space. Unknown: no limit.
+std::size_t socket_room(int fd)
+{
+    int sndbuf = 0;
+    int unsent = 0;
+    socklen_t len = sizeof(sndbuf);
+    if (::getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, &len) != 0 || ::ioctl(fd, TIOCOUTQ, &unsent) != 0)
+        return SIZE_MAX;
+    return sndbuf > unsent ? static_cast<std::size_t>(sndbuf - unsent) : 0;
+}
+
 } // namespace
 
 // ── Constructor / Destructor ─────────────────────────────────────────────────
@@ -70,6 +288,151 @@ CSService::CSService(Application& app)
         webhook_.username    = wh.value("username", "");
         webhook_.password    = wh.value("password", "");
         webhook_.token       = wh.value("token", "");
+        webhook_.connections = wh.value("connections", webhook_.connections);
+        webhook_.pipeline    = wh.value("pipeline", webhook_.pipeline);
+        webhook_.queue       = wh.value("queue", webhook_.queue);
+        webhook_.timeout     = wh.value("timeout", webhook_.timeout);
+        if (wh.contains("batch"))
+            load_batch_config(wh["batch"], "webhook.batch", webhook_.batch);
+
+        if (wh.contains("breaker")) {
+            const auto& br = wh["breaker"];
+            auto& options = webhook_.breaker_options;
+            webhook_.breaker    = br.value("enable", true);
+            options.error_rate  = br.value("error_rate", options.error_rate);
+            options.latency     = std::chrono::milliseconds(br.value("latency", int64_t{5000}));
+            options.min_samples = br.value("min_samples", options.min_samples);
+            options.open_for    = std::chrono::seconds(br.value("open", int64_t{10}));
+            options.probes      = std::max<std::size_t>(1, br.value("probes", options.probes));
+            webhook_.deferred   = br.value("deferred", webhook_.deferred);
+            if (br.contains("fallback") && br["fallback"].is_array())
+                load_action_set(br["fallback"], "webhook.breaker.fallback", webhook_.fallback);
+        }
+    }
+    webhook_breaker_ = ocpp::CircuitBreaker(webhook_.breaker_options);
+
+#ifdef WITH_POSTGRESQL
+    // Load PostgreSQL batching configuration
+    if (cfg.contains("postgres") && cfg["postgres"].contains("batch"))
+        load_batch_config(cfg["postgres"]["batch"], "postgres.batch", pg_batch_);
+    pg_batch_.size = std::min(pg_batch_.size, kMaxParseBatch);
+
+    // Coalesced connection-state updates
+    if (cfg.contains("postgres") && cfg["postgres"].contains("connection")) {
+        const auto& cs = cfg["postgres"]["connection"];
+        pg_connected_window_ = std::chrono::milliseconds(cs.value("window", int64_t{250}));
+        pg_connected_size_   = std::max<std::size_t>(1, cs.value("size", pg_connected_size_));
+    }
+
+    // Local Heartbeat answers with write-behind last-seen
+    if (cfg.contains("postgres") && cfg["postgres"].contains("heartbeat")) {
+        const auto& hb = cfg["postgres"]["heartbeat"];
+        pg_heartbeat_local_ = hb.value("local", false);
+        pg_heartbeat_flush_ = std::chrono::seconds(std::max<int64_t>(1, hb.value("flush", int64_t{10})));
+    }
+
+    if (pool_ && pg_heartbeat_local_)
+        app_.worker_loop().add_timer(pg_heartbeat_flush_, [this] { flush_heartbeats(); }, true);
+#endif
+
+    // Outbound command timeouts: built-in per-action defaults, then config
+    // ("commands": {"timeout": 30, "timeouts": {"GetDiagnostics": 120}}, seconds)
+    std::chrono::milliseconds default_timeout = kDefaultCommandTimeout;
+    if (cfg.contains("commands"))
+        default_timeout = std::chrono::seconds(cfg["commands"].value("timeout", int64_t{30}));
+
+    command_timeouts_.fill(default_timeout);
+    for (const auto& [action, timeout] : kCommandTimeouts)
+        command_timeouts_[ocpp::action_index(action)] = timeout;
+
+    if (cfg.contains("commands") && cfg["commands"].contains("timeouts") &&
+        cfg["commands"]["timeouts"].is_object()) {
+        for (const auto& [name, value] : cfg["commands"]["timeouts"].items()) {
+            auto action = ocpp::action_from_string(name);
+            if (action == ocpp::Action::Unknown || !value.is_number()) {
+                app_.logger().warn("commands.timeouts: ignoring '{}'", name);
+                continue;
+            }
+            command_timeouts_[ocpp::action_index(action)] = std::chrono::seconds(value.get<int64_t>());
+        }
+    }
+
+    // Authorize result cache ("authorize_cache": {"enable", "ttl" seconds, "size"})
+    if (cfg.contains("authorize_cache")) {
+        const auto& ac = cfg["authorize_cache"];
+        ocpp::AuthorizationCache::Options options;
+        authorize_cache_enabled_ = ac.value("enable", false);
+        options.ttl      = std::chrono::seconds(ac.value("ttl", int64_t{300}));
+        options.capacity = ac.value("size", options.capacity);
+        authorize_cache_ = ocpp::AuthorizationCache(options);
+    }
+
+    // Admission control for reconnect storms
+    if (cfg.contains("admission") && cfg["admission"].value("enable", false)) {
+        const auto& ad = cfg["admission"];
+        ocpp::AdmissionController::Options options;
+        options.upgrade_rate    = ad.value("upgrade_rate", options.upgrade_rate);
+        options.upgrade_burst   = std::max<std::size_t>(1, ad.value("upgrade_burst", options.upgrade_burst));
+        options.boot_in_flight  = ad.value("boot_in_flight", options.boot_in_flight);
+        options.queue_threshold = ad.value("queue_threshold", options.queue_threshold);
+        options.pending_min     = std::chrono::seconds(ad.value("pending_min", int64_t{30}));
+        options.pending_max     = std::chrono::seconds(ad.value("pending_max", int64_t{300}));
+        admission_ = std::make_unique<ocpp::AdmissionController>(options);
+    }
+
+    // Per-connection outbound queues (bytes)
+    if (cfg.contains("outbound")) {
+        const auto& ob = cfg["outbound"];
+        outbound_options_.high_water = ob.value("high_water", outbound_options_.high_water);
+        outbound_options_.low_water  = std::min(outbound_options_.high_water,
+                                                ob.value("low_water", outbound_options_.low_water));
+    }
+
+    // Binary traffic journal ("journal": {"enable", "dir", "segment_size" bytes, "segments"})
+    if (cfg.contains("journal") && cfg["journal"].value("enable", false)) {
+        const auto& jr = cfg["journal"];
+        ocpp::TrafficJournal::Options options;
+        options.dir          = jr.value("dir", std::string("logs/journal"));
+        options.segment_size = jr.value("segment_size", options.segment_size);
+        options.segments     = jr.value("segments", options.segments);
+        if (!options.dir.starts_with('/'))
+            options.dir = app.settings().prefix + options.dir;
+        journal_dir_ = options.dir;
+        // Segments are opened on the first frame, in the worker process
+        journal_ = std::make_unique<ocpp::TrafficJournal>(std::move(options));
+    }
+
+    // Asynchronous traffic log ("message_log": {"enable", "file", "queue", "sample": {"MeterValues": 100}})
+    if (cfg.contains("message_log") && cfg["message_log"].value("enable", false)) {
+        const auto& ml = cfg["message_log"];
+        ocpp::MessageLog::Options options;
+        options.file  = ml.value("file", std::string("logs/messages.log"));
+        options.queue = std::max<std::size_t>(2, ml.value("queue", options.queue));
+        if (!options.file.starts_with('/'))
+            options.file = app.settings().prefix + options.file;
+
+        if (ml.contains("sample") && ml["sample"].is_object()) {
+            for (const auto& [name, value] : ml["sample"].items()) {
+                // "*": messages without an action, i.e. replies from the stations
+                auto action = name == "*" ? ocpp::Action::Unknown : ocpp::action_from_string(name);
+                if ((action == ocpp::Action::Unknown && name != "*") || !value.is_number_unsigned()) {
+                    app_.logger().warn("message_log.sample: ignoring '{}'", name);
+                    continue;
+                }
+                options.sample[ocpp::action_index(action)] = value.get<uint32_t>();
+            }
+        }
+        message_log_ = std::make_unique<ocpp::MessageLog>(std::move(options));
+
+        // The writer thread is started in the worker process, after fork
+        app_.worker_loop().add_timer(std::chrono::milliseconds(0), [this] {
+            try {
+                message_log_->start();
+            } catch (const std::exception& e) {
+                app_.logger().error("Message log disabled: {}", e.what());
+                message_log_.reset();
+            }
+        }, false);
     }
 
     // Load API auth configuration
@@ -106,14 +469,78 @@ CSService::CSService(Application& app)
     if (const char* v = std::getenv("WEBHOOK_PASSWORD")) webhook_.password = v;
     if (const char* v = std::getenv("WEBHOOK_TOKEN"))    webhook_.token = v;
 
+    // Multi-worker routing: stations are owned by the worker holding their WebSocket,
+    // REST commands accepted by any other worker are forwarded to the owner.
+    if (const auto cluster = cluster_config(cfg); cluster.enabled) {
+        // Started from the loop so it runs in the worker process, after fork
+        app_.worker_loop().add_timer(std::chrono::milliseconds(0), [this, directory_capacity = cluster.capacity] {
+            auto router = std::make_unique<WorkerRouter>(app_.worker_loop(), APP_NAME);
+            try {
+                router->start(directory_capacity,
+                    [this](const std::string& identity, const std::string& operation,
+                           const std::string& body, WorkerRouter::Reply reply) {
+                        if (identity.empty()) {
+                            // Notice broadcast by another worker
+                            if (operation == "AuthorizationCache")
+                                invalidate_authorization_cache(body);
+                            return;
+                        }
+                        on_forwarded_command(identity, operation, body, std::move(reply));
+                    });
+            } catch (const std::exception& e) {
+                app_.logger().error("Worker routing disabled: {}", e.what());
+                return;
+            }
+            router_ = std::move(router);
+
+            // Stations that connected before the router was up
+            point_manager_.for_each([this](const ocpp::CSChargingPoint& point) {
+                if (point.connected())
+                    router_->claim(point.identity());
+            });
+        }, false);
+    }
+
     // Register WS handler
     app_.set_ws_handler([this](EventLoop& loop, WsConnection ws, const HttpRequest& req) {
         on_ws_upgrade(loop, std::move(ws), req);
     });
 
-    // Periodic cleanup of expired pending calls (every 5 seconds)
-    app_.worker_loop().add_timer(kCleanupInterval,
-        [this] { cleanup_expired_calls(); }, true);
+    // Periodic cleanup of expired forwarded commands (every 5 seconds)
+    app_.worker_loop().add_timer(kCleanupInterval, [this] {
+        const auto now = std::chrono::steady_clock::now();
+        if (router_)
+            router_->expire(now);
+        if (webhook_client_) {
+            webhook_client_->expire(now);
+            drain_webhook_deferred();
+        }
+        if (admission_)
+            log_admission();
+        if (message_log_)
+            log_message_counters();
+    }, true);
+}
+
+// A directory left by an earlier run may have another size, or entries of
+// workers whose pids are reused: every master starts from an empty one.
+void CSService::prepare_master(Application& app)
+{
+    const auto cluster = cluster_config(app.config().json());
+    if (!cluster.enabled)
+        return;
+
+    try {
+        WorkerRouter::create_directory(APP_NAME, cluster.capacity);
+    } catch (const std::exception& e) {
+        app.logger().error("Worker directory: {}", e.what());
+    }
+}
+
+void CSService::cleanup_master(Application& app)
+{
+    if (cluster_config(app.config().json()).enabled)
+        WorkerRouter::remove_directory(APP_NAME);
 }
 
 // ── check_location ──────────────────────────────────────────────────────────
@@ -194,18 +621,20 @@ void CSService::do_post(const HttpRequest& req, HttpResponse& resp)
 
 // ── WebSocket Upgrade (OCPP 1.6 JSON) ───────────────────────────────────────
 
-void CSService::broadcast_log(const nlohmann::json& entry)
-{
-    if (log_subscribers_.empty()) return;
-    auto msg = entry.dump();
-    std::vector<int> fds;
-    fds.reserve(log_subscribers_.size());
-    for (auto& [fd, _] : log_subscribers_) fds.push_back(fd);
-    for (int fd : fds) {
-        auto it = log_subscribers_.find(fd);
-        if (it != log_subscribers_.end()) {
-            it->second.send_text(msg);
+// The entry is serialized once, on the first subscriber whose filter matches,
+// and the same frame goes to all of them. Subscriber queues only drop frames,
+// never close the connection, so the map is stable while iterating.
+void CSService::broadcast_log(const ocpp::LogEvent& event)
+{
+    bool rendered = false;
+    for (auto& [fd, sub] : log_subscribers_) {
+        if (!sub.filter.matches(event)) continue;
+        if (!rendered) {
+            log_entry_.clear();
+            ocpp::append_log_event(log_entry_, event);
+            rendered = true;
         }
+        ws_send(fd, sub.ws, log_entry_);
     }
 }
 
@@ -216,29 +645,14 @@ void CSService::on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpReques
     // Browser log subscriber: /ws/log
     if (parts.size() >= 2 && parts[0] == "ws" && parts[1] == "log") {
         int fd = ws.fd();
-        log_subscribers_.emplace(fd, std::move(ws));
+        log_subscribers_.emplace(fd, LogSubscriber{std::move(ws), {}});
 
         app_.logger().notice("[ws/log] subscriber connected (fd={})", fd);
 
+        outbound_.try_emplace(fd, WsOutbound{ocpp::OutboundQueue(outbound_options(ocpp::OutboundQueue::Policy::DropOldest))});
+
         loop.remove_io(fd);
-        loop.add_io(fd, EPOLLIN, [this, fd](uint32_t) {
-            auto ws_it = log_subscribers_.find(fd);
-            if (ws_it == log_subscribers_.end()) return;
-
-            bool alive = ws_it->second.on_readable(
-                [](uint8_t, const std::string&) { /* ignore incoming messages */ },
-                [this, fd]() {
-                    app_.logger().notice("[ws/log] subscriber disconnected (fd={})", fd);
-                    app_.worker_loop().remove_io(fd);
-                    log_subscribers_.erase(fd);
-                }
-            );
-            if (!alive) {
-                app_.logger().notice("[ws/log] subscriber disconnected (fd={})", fd);
-                app_.worker_loop().remove_io(fd);
-                log_subscribers_.erase(fd);
-            }
-        });
+        watch_log_io(fd, EPOLLIN);
         return;
     }
 
@@ -248,6 +662,12 @@ void CSService::on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpReques
         return;
     }
 
+    // Reconnect storm: the station retries the upgrade later
+    if (admission_ && !admission_->admit_upgrade(std::chrono::steady_clock::now())) {
+        ws.send_close(1013, "Try again later");
+        return;
+    }
+
     std::string identity;
     std::string account;
 
@@ -262,15 +682,9 @@ void CSService::on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpReques
 
     // Clean up stale connection if station reconnects with same identity
     if (point.ws_connection()) {
-        int old_fd = point.ws_connection()->fd();
-        app_.logger().notice("[{}] reconnecting — closing stale fd={}", identity, old_fd);
-        loop.remove_io(old_fd);
-        ws_connections_.erase(old_fd);
-        point.set_ws_connection(nullptr);
-#ifdef WITH_POSTGRESQL
-        if (pool_)
-            set_point_connected(identity, false, json::object());
-#endif
+        app_.logger().notice("[{}] reconnecting — closing stale fd={}", identity,
+            point.ws_connection()->fd());
+        drop_connection(point);
     }
 
     point.set_protocol_type(ocpp::ProtocolType::JSON);
@@ -284,6 +698,7 @@ void CSService::on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpReques
     point.set_ocpp_version(ocpp_version);
 
     point.set_address(get_host(req));
+    point.set_account(std::move(account));
     point.set_connected_at(ocpp::CSChargingPoint::clock::now());
     point.touch();
 
@@ -293,11 +708,22 @@ void CSService::on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpReques
     auto [it, inserted] = ws_connections_.emplace(fd, std::move(ws));
     auto* ws_ptr = &it->second;
 
-    point.set_ws_connection(ws_ptr);
+    point_manager_.bind_connection(point, ws_ptr);
+
+    // Frames to the station pass its bounded outbound queue
+    outbound_.insert_or_assign(fd, WsOutbound{ocpp::OutboundQueue(outbound_options(ocpp::OutboundQueue::Policy::Disconnect))});
+    point.set_frame_sink([this, fd, ws_ptr, identity](std::string_view frame) {
+        if (journal_)
+            journal_outbound(identity, frame);
+        ws_send(fd, *ws_ptr, frame);
+    });
 
     app_.logger().notice("[{}] connected (fd={}, address={}, OCPP {})",
         identity, fd, point.address(), point.ocpp_version());
 
+    if (router_)
+        router_->claim(identity);
+
 #ifdef WITH_POSTGRESQL
     // Notify database
     if (pool_)
@@ -307,62 +733,255 @@ void CSService::on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpReques
     // Remove HTTP epoll registration before adding WS handler
     loop.remove_io(fd);
 
-    // Register read handler
-    loop.add_io(fd, EPOLLIN, [this, fd, identity_copy = identity](uint32_t /*events*/) {
+    // Register read handler (the handle resolves the point without hashing the identity)
+    watch_station_io(fd, point.handle(), EPOLLIN);
+}
+
+// ── WebSocket I/O ───────────────────────────────────────────────────────────
+
+void CSService::watch_log_io(int fd, uint32_t events)
+{
+    app_.worker_loop().add_io(fd, events, [this, fd](uint32_t ready) {
+        if (ready & EPOLLOUT)
+            on_ws_writable(fd);
+        if (!(ready & ~static_cast<uint32_t>(EPOLLOUT)))
+            return;
+
+        auto sub = log_subscribers_.find(fd);
+        if (sub == log_subscribers_.end()) return;
+
+        // A text message replaces the subscriber's filter
+        bool alive = sub->second.ws.on_readable(
+            [this, fd](uint8_t, const std::string& text) { set_log_filter(fd, text); },
+            [this, fd]() { close_log_subscriber(fd); }
+        );
+        if (!alive)
+            close_log_subscriber(fd);
+    });
+}
+
+void CSService::set_log_filter(int fd, const std::string& text)
+{
+    auto it = log_subscribers_.find(fd);
+    if (it == log_subscribers_.end()) return;
+
+    try {
+        it->second.filter = ocpp::LogFilter::parse(json::parse(text));
+        app_.logger().notice("[ws/log] subscriber filter set (fd={}): {}", fd, text);
+    } catch (const std::exception& e) {
+        app_.logger().warn("[ws/log] invalid filter ignored (fd={}): {}", fd, e.what());
+    }
+}
+
+void CSService::close_log_subscriber(int fd)
+{
+    auto it = log_subscribers_.find(fd);
+    if (it == log_subscribers_.end()) return;
+
+    auto out = outbound_.find(fd);
+    if (out != outbound_.end() && out->second.queue.counters().dropped_frames > 0) {
+        const auto& counters = out->second.queue.counters();
+        app_.logger().notice("[ws/log] subscriber disconnected (fd={}, {} entries dropped, {} bytes)",
+            fd, counters.dropped_frames, counters.dropped_bytes);
+    } else {
+        app_.logger().notice("[ws/log] subscriber disconnected (fd={})", fd);
+    }
+
+    app_.worker_loop().remove_io(fd);
+    log_subscribers_.erase(it);
+    outbound_.erase(fd);
+}
+
+void CSService::watch_station_io(int fd, ocpp::PointHandle handle, uint32_t events)
+{
+    app_.worker_loop().add_io(fd, events, [this, fd, handle](uint32_t ready) {
+        if (ready & EPOLLOUT)
+            on_ws_writable(fd);
+        if (!(ready & ~static_cast<uint32_t>(EPOLLOUT)))
+            return;
+
         auto ws_it = ws_connections_.find(fd);
         if (ws_it == ws_connections_.end()) return;
 
         auto& ws_conn = ws_it->second;
         bool alive = ws_conn.on_readable(
-            [this, &identity_copy](uint8_t opcode, const std::string& payload) {
+            [this, handle](uint8_t opcode, const std::string& payload) {
                 if (opcode == WS_OP_TEXT) {
-                    auto* point = point_manager_.find_by_identity(identity_copy);
+                    auto* point = point_manager_.get(handle);
                     if (point) {
                         on_ws_message(*point, payload);
                     }
                 }
             },
-            [this, identity_copy]() {
-                on_ws_close(identity_copy);
+            [this, handle]() {
+                on_ws_close(handle);
             }
         );
 
         if (!alive) {
-            on_ws_close(identity_copy);
+            on_ws_close(handle);
         }
     });
 }
 
+ocpp::OutboundQueue::Options CSService::outbound_options(ocpp::OutboundQueue::Policy policy) const
+{
+    auto options = outbound_options_;
+    options.policy = policy;
+    return options;
+}
+
+// Send a frame through the connection's outbound queue. Queued frames wait for
+// EPOLLOUT; a station whose queue passes the high water mark is disconnected,
+// a log subscriber loses its oldest entries instead.
+void CSService::ws_send(int fd, WsConnection& ws, std::string_view frame)
+{
+    auto it = outbound_.find(fd);
+    if (it == outbound_.end()) {
+        ws.send_text(frame);
+        return;
+    }
+
+    auto& out = it->second;
+    if (out.evicting)
+        return;
+
+    switch (out.queue.send(frame, [fd] { return socket_room(fd); },
+                           [&ws](std::string_view f) { ws.send_text(f); })) {
+    case ocpp::OutboundQueue::Result::Sent:
+        break;
+    case ocpp::OutboundQueue::Result::Queued:
+        update_io(fd, out);
+        break;
+    case ocpp::OutboundQueue::Result::Evict:
+        out.evicting = true;
+        // Not from inside the send path: the connection may be mid-read
+        app_.worker_loop().add_timer(std::chrono::milliseconds(0), [this, fd] { evict_slow_station(fd); }, false);
+        break;
+    }
+}
+
+void CSService::on_ws_writable(int fd)
+{
+    auto it = outbound_.find(fd);
+    if (it == outbound_.end()) return;
+
+    WsConnection* ws = nullptr;
+    if (auto st = ws_connections_.find(fd); st != ws_connections_.end())
+        ws = &st->second;
+    else if (auto sub = log_subscribers_.find(fd); sub != log_subscribers_.end())
+        ws = &sub->second.ws;
+    if (!ws) return;
+
+    auto& out = it->second;
+    if (!out.evicting && out.queue.flush([fd] { return socket_room(fd); },
+                                         [ws](std::string_view f) { ws->send_text(f); }))
+        update_io(fd, out);
+}
+
+// Watch EPOLLOUT exactly while frames are queued. The registration is
+// changed from a zero timer, never from inside the connection's own handler.
+void CSService::update_io(int fd, WsOutbound& out)
+{
+    if (out.io_update_armed || out.watching_write == !out.queue.empty())
+        return;
+
+    out.io_update_armed = true;
+    app_.worker_loop().add_timer(std::chrono::milliseconds(0), [this, fd] {
+        auto it = outbound_.find(fd);
+        if (it == outbound_.end()) return;
+
+        auto& out = it->second;
+        out.io_update_armed = false;
+        const bool want = !out.queue.empty() && !out.evicting;
+        if (want == out.watching_write) return;
+
+        const uint32_t events = want ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        if (log_subscribers_.contains(fd)) {
+            app_.worker_loop().remove_io(fd);
+            watch_log_io(fd, events);
+        } else if (auto st = ws_connections_.find(fd); st != ws_connections_.end()) {
+            auto* point = point_manager_.find_by_connection(&st->second);
+            if (!point) return;
+            app_.worker_loop().remove_io(fd);
+            watch_station_io(fd, point->handle(), events);
+        } else {
+            return;
+        }
+        out.watching_write = want;
+    }, false);
+}
+
+void CSService::evict_slow_station(int fd)
+{
+    auto out = outbound_.find(fd);
+    auto st = ws_connections_.find(fd);
+    if (out == outbound_.end() || !out->second.evicting || st == ws_connections_.end())
+        return;
+
+    auto* point = point_manager_.find_by_connection(&st->second);
+    if (!point) return;
+
+    app_.logger().warn("[{}] slow consumer: {} bytes queued for the station, disconnecting",
+        point->identity(), out->second.queue.queued_bytes());
+    on_ws_close(point->handle());
+}
+
 void CSService::on_ws_message(ocpp::CSChargingPoint& point, const std::string& payload)
 {
     point.touch();
 
+    // Scan the envelope in place. The payload stays a view into `payload`
+    // (msg.raw_view) through dispatch; its DOM is built for Calls only, which
+    // are validated and stored, never for the answers to our own commands.
+    ocpp::OcppFrame frame;
     ocpp::OcppMessage msg;
     try {
-        msg = ocpp::parse_ocpp_json(payload);
+        frame = ocpp::parse_ocpp_frame(payload);
+        msg = frame.envelope();
+        if (msg.type == ocpp::MessageType::Call)
+            msg.payload = frame.payload_json();
+        else if (!nlohmann::json::accept(frame.payload))   // checked, not built: it is passed on as is
+            throw std::invalid_argument("payload is not valid JSON");
     } catch (const std::exception& e) {
         app_.logger().error("[{}] JSON parse error: {}", point.identity(), e.what());
         return;
     }
 
-    log_json_message(point.identity(), msg);
+    if (journal_) {
+        ocpp::TrafficJournal::Record record;
+        record.time      = ocpp::TrafficJournal::clock::now();
+        record.identity  = point.identity();
+        record.direction = ocpp::LogDirection::In;
+        record.type      = msg.type;
+        record.action    = msg.action_id;
+        record.unique_id = msg.unique_id;
+        record.payload   = frame.payload;
+        journal_append(record);
+    }
+
+    auto event = ocpp::make_log_event(point.identity(), ocpp::LogDirection::In, msg);
+    log_message(event, msg.action_id);
 
     if (msg.type == ocpp::MessageType::Call) {
         // Strip vendor-extension fields before schema validation (they are not part of the spec
-        // and would fail additionalProperties check). Restore them after validation so PG receives
-        // the full payload. Currently used for geo in BootNotification (OCPP 1.6 emulators).
+        // and would fail additionalProperties check). PG and webhook receive the original bytes
+        // (msg.raw()), so the fields are only moved back into the DOM for store_request().
+        // Currently used for geo in BootNotification (OCPP 1.6 emulators).
         nlohmann::json stripped;
-        if (msg.action == "BootNotification" && point.ocpp_version() != "2.0.1") {
+        if (msg.action_id == ocpp::Action::BootNotification && point.ocpp_version() != "2.0.1") {
             for (auto key : {"latitude", "longitude", "location", "connectors"}) {
-                if (msg.payload.contains(key)) {
-                    stripped[key] = msg.payload[key];
-                    msg.payload.erase(key);
+                auto field = msg.payload.find(key);
+                if (field != msg.payload.end()) {
+                    stripped[key] = std::move(*field);
+                    msg.payload.erase(field);
                 }
             }
         }
 
         // Validate against JSON schema
-        auto err = schema_registry_.validate(point.ocpp_version(), msg.action, "Request", msg.payload);
+        auto err = schema_registry_.validate(point.version(), msg.action_id,
+                                             ocpp::SchemaDirection::Request, msg.payload);
         if (err) {
             app_.logger().warn("[{}] Schema validation failed for {}: {}",
                                point.identity(), msg.action, *err);
@@ -372,26 +991,39 @@ void CSService::on_ws_message(ocpp::CSChargingPoint& point, const std::string& p
             return;
         }
 
-        // Restore stripped fields so PG receives the full payload
+        // Restore stripped fields for the in-memory copy
         if (!stripped.empty())
             msg.payload.update(stripped);
 
-        // Broadcast to log subscribers
-        broadcast_log({{"ts", ocpp::iso_time_now()}, {"identity", point.identity()},
-                       {"direction", "in"}, {"messageType", "Call"},
-                       {"uniqueId", msg.unique_id}, {"action", msg.action},
-                       {"payload", msg.payload}});
+        // Broadcast to log subscribers, from the original payload bytes
+        if (!log_subscribers_.empty())
+            broadcast_log(event);
 
         // Store last request
         point.store_request(msg.action, msg.payload);
 
+        if (admission_ && msg.action_id == ocpp::Action::BootNotification &&
+            !admit_boot_notification(point, msg))
+            return;
+
 #ifdef WITH_POSTGRESQL
         if (pool_) {
-            parse_json_pg(point, msg);
+            // The station's last-seen is written behind by flush_heartbeats()
+            if (pg_heartbeat_local_ && msg.action_id == ocpp::Action::Heartbeat &&
+                send_default_response(point, msg)) {
+                pg_heartbeats_.insert_or_assign(point.identity(),
+                    PgHeartbeat{msg.unique_id, point.ocpp_version()});
+                return;
+            }
+            if (authorize_cache_enabled_)
+                check_authorization_cache(point, msg);
+            parse_json_pg(point, msg, point.account());
         } else
 #endif
         if (webhook_.enabled) {
-            parse_json_webhook(point, msg);
+            if (authorize_cache_enabled_)
+                check_authorization_cache(point, msg);
+            parse_json_webhook(point, msg, point.account());
         } else {
             if (point.ocpp_version() == "2.0.1")
                 handle_action_201(point, msg);
@@ -402,8 +1034,8 @@ void CSService::on_ws_message(ocpp::CSChargingPoint& point, const std::string& p
     }
 
     // CallResult / CallError — correlate with pending outbound call
-    auto it = pending_calls_.find(msg.unique_id);
-    if (it == pending_calls_.end()) {
+    auto call = pending_calls_.take(msg.unique_id);
+    if (!call) {
         app_.logger().warn("[{}] received {} for unknown uniqueId={}",
             point.identity(),
             msg.type == ocpp::MessageType::CallResult ? "CallResult" : "CallError",
@@ -411,73 +1043,140 @@ void CSService::on_ws_message(ocpp::CSChargingPoint& point, const std::string& p
         return;
     }
 
-    auto pending = std::move(it->second);
-    pending_calls_.erase(it);
+    auto& pending = call->value;
 
     // Broadcast to log subscribers
-    broadcast_log({{"ts", ocpp::iso_time_now()}, {"identity", point.identity()},
-                   {"direction", "in"},
-                   {"messageType", msg.type == ocpp::MessageType::CallResult ? "CallResult" : "CallError"},
-                   {"uniqueId", msg.unique_id}, {"action", pending.action},
-                   {"payload", msg.payload}});
+    if (!log_subscribers_.empty()) {
+        event.action = pending.action;
+        broadcast_log(event);
+    }
 
-    json body;
+    std::string body;
     if (msg.type == ocpp::MessageType::CallError) {
-        body = {
-            {"error", true},
-            {"errorCode", msg.error_code},
-            {"errorDescription", msg.error_description},
-            {"errorDetails", msg.payload}
-        };
+        // errorDetails spliced in as received, like a CallResult payload
+        body.reserve(msg.error_code.size() + msg.error_description.size() + frame.payload.size() + 72);
+        body += R"({"error":true,"errorCode":)";
+        ocpp::append_json_string(body, msg.error_code);
+        body += R"(,"errorDescription":)";
+        ocpp::append_json_string(body, msg.error_description);
+        body += R"(,"errorDetails":)";
+        body += frame.payload;
+        body += '}';
     } else {
-        body = msg.payload;
+        // CallResult payload goes back to the REST caller as received
+        body = std::string(frame.payload);
     }
 
-    HttpResponse r;
-    r.set_status(HttpStatus::ok);
-    r.set_body(body.dump(), "application/json");
-    pending.conn->send_response(r);
+    finish_pending_call(pending, HttpStatus::ok, std::move(body), false);
 
     app_.logger().debug("[{}] pending call {} ({}) resolved",
         point.identity(), msg.unique_id, pending.action);
 }
 
-void CSService::on_ws_close(const std::string& identity)
+void CSService::on_ws_close(ocpp::PointHandle handle)
 {
-    auto* point = point_manager_.find_by_identity(identity);
+    auto* point = point_manager_.get(handle);
     if (!point || !point->ws_connection()) return;  // already cleaned up or unknown
 
-    int fd = point->ws_connection()->fd();
+    app_.logger().notice("[{}] disconnected (fd={})", point->identity(), point->ws_connection()->fd());
+
+    drop_connection(*point);
+}
+
+// Forget the station's current WebSocket: on close, and when a reconnect
+// replaces a connection that was never closed.
+void CSService::drop_connection(ocpp::CSChargingPoint& point)
+{
+    const std::string& identity = point.identity();
+    const auto handle = point.handle();
+    int fd = point.ws_connection()->fd();
+
+    point_manager_.bind_connection(point, nullptr);
 
-    app_.logger().notice("[{}] disconnected (fd={})", identity, fd);
+    // Nobody is going to answer the station's outstanding calls
+    pending_calls_.take_station(handle, [&](auto& call) {
+        finish_pending_call(call.value, HttpStatus::service_unavailable,
+            fmt::format("Charge point '{}' disconnected", identity), true);
+    });
 
-    point->set_ws_connection(nullptr);
+    if (router_)
+        router_->release(identity);
+
+    // Backend answers for this connection will not reach send_json_response()
+    if (!authorize_calls_.empty() || !boot_calls_.empty()) {
+        const std::string prefix = identity + '\x1f';
+        std::erase_if(authorize_calls_, [&](const auto& entry) { return entry.first.starts_with(prefix); });
+        std::erase_if(boot_calls_, [&](const std::string& key) {
+            if (!key.starts_with(prefix)) return false;
+            admission_->boot_finished();
+            return true;
+        });
+    }
 
 #ifdef WITH_POSTGRESQL
-    if (pool_)
+    if (pool_) {
+        pg_heartbeats_.erase(identity);  // the disconnect is more recent
         set_point_connected(identity, false, json::object());
+    }
 #endif
 
     if (fd >= 0) {
         app_.worker_loop().remove_io(fd);
         ws_connections_.erase(fd);
+        outbound_.erase(fd);
     }
 }
 
 void CSService::send_json_response(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& response)
 {
-    log_json_message(point.identity(), response);
+    if (!boot_calls_.empty() && response.type != ocpp::MessageType::Call)
+        finish_boot_call(point.identity(), response.unique_id);
+
+    if (!authorize_calls_.empty() && response.type != ocpp::MessageType::Call &&
+        settle_authorize_call(point.identity(), response, true))
+        return;
 
-    broadcast_log({{"ts", ocpp::iso_time_now()}, {"identity", point.identity()},
-                   {"direction", "out"},
-                   {"messageType", response.type == ocpp::MessageType::Call ? "Call" :
-                                   response.type == ocpp::MessageType::CallResult ? "CallResult" : "CallError"},
-                   {"uniqueId", response.unique_id}, {"action", response.action},
-                   {"payload", response.payload}});
+    auto event = ocpp::make_log_event(point.identity(), ocpp::LogDirection::Out, response);
+    log_message(event, ocpp::action_from_string(response.action));
+    if (!log_subscribers_.empty())
+        broadcast_log(event);
 
     point.send_json(response);
 }
 
+bool CSService::send_default_response(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& request)
+{
+    if (!boot_calls_.empty())
+        finish_boot_call(point.identity(), request.unique_id);
+
+    // A canned answer never overrides one from the cache, nor refreshes it
+    if (!authorize_calls_.empty()) {
+        ocpp::OcppMessage response;
+        response.type      = ocpp::MessageType::CallResult;
+        response.unique_id = request.unique_id;
+        if (settle_authorize_call(point.identity(), response, false))
+            return true;
+    }
+
+    auto frame = point.send_default_response(request);
+    if (frame.empty())
+        return false;
+
+    // The reply was rendered from a template; its payload bytes are logged as is,
+    // sampled as the request it answers
+    ocpp::LogEvent event;
+    event.identity  = point.identity();
+    event.direction = ocpp::LogDirection::Out;
+    event.type      = ocpp::MessageType::CallResult;
+    event.unique_id = request.unique_id;
+    event.payload   = ocpp::parse_ocpp_frame(frame).payload;
+    log_message(event, request.action_id);
+    if (!log_subscribers_.empty())
+        broadcast_log(event);
+
+    return true;
+}
+
 // ── SOAP (OCPP 1.5) — WITH_POSTGRESQL only ──────────────────────────────────
 
 #ifdef WITH_POSTGRESQL
@@ -697,6 +1396,16 @@ void CSService::do_api(const HttpRequest& req, HttpResponse& resp)
             return;
         }
 
+        if (command == "AuthorizationCache") {
+            do_authorization_cache(req, resp);
+            return;
+        }
+
+        if (command == "Journal") {
+            do_journal(req, resp);
+            return;
+        }
+
 #ifdef WITH_POSTGRESQL
         if (pool_) {
             if (command == "ChargePointList") {
@@ -744,7 +1453,7 @@ void CSService::do_charge_point_list(const HttpRequest& /*req*/, HttpResponse& r
     resp.set_body(list.dump(), "application/json");
 }
 
-json CSService::translate_payload(const std::string& operation,
+json CSService::translate_payload(ocpp::Action action,
                                   const json& body,
                                   const std::string& target_version)
 {
@@ -757,14 +1466,14 @@ json CSService::translate_payload(const std::string& operation,
     // that don't know evse_id fall back to the legacy connectorId-as-evseId
     // mapping which is correct for single-EVSE stations.
     if (target_version == "2.0.1") {
-        if (operation == "Reset") {
+        if (action == ocpp::Action::Reset) {
             // Hard->Immediate, Soft->OnIdle
             if (result.contains("type")) {
                 auto& t = result["type"];
                 if (t == "Hard")      t = "Immediate";
                 else if (t == "Soft") t = "OnIdle";
             }
-        } else if (operation == "RequestStartTransaction") {
+        } else if (action == ocpp::Action::RequestStartTransaction) {
             // 1.6 format {idTag, connectorId, evseId?} -> 2.0.1 {idToken, evseId, remoteStartId}
             if (result.contains("idTag") && !result.contains("idToken")) {
                 auto tag = result.value("idTag", "");
@@ -780,9 +1489,9 @@ json CSService::translate_payload(const std::string& operation,
                 if (!result.contains("remoteStartId"))
                     result["remoteStartId"] = 1;
             }
-        } else if (operation == "RequestStopTransaction") {
+        } else if (action == ocpp::Action::RequestStopTransaction) {
             // 1.6 format {transactionId: int/string} -> already handled by SQL (sends string SID)
-        } else if (operation == "UnlockConnector") {
+        } else if (action == ocpp::Action::UnlockConnector) {
             // 1.6 format {connectorId, evseId?} -> 2.0.1 {evseId, connectorId}
             if (!result.contains("operationalStatus")) {
                 int eid = result.value("evseId", 0);
@@ -791,7 +1500,7 @@ json CSService::translate_payload(const std::string& operation,
                 result["evseId"] = effective > 0 ? effective : 1;
                 result["connectorId"] = 1;
             }
-        } else if (operation == "TriggerMessage") {
+        } else if (action == ocpp::Action::TriggerMessage) {
             // 1.6 format {requestedMessage, connectorId?, evseId?} -> 2.0.1 {requestedMessage, evse?: {id}}
             int eid = result.value("evseId", 0);
             int cid = result.value("connectorId", 0);
@@ -800,7 +1509,7 @@ json CSService::translate_payload(const std::string& operation,
             result.erase("evseId");
             if (effective > 0)
                 result["evse"] = {{"id", effective}};
-        } else if (operation == "ChangeAvailability") {
+        } else if (action == ocpp::Action::ChangeAvailability) {
             // 1.6 format {connectorId, evseId?, type} -> 2.0.1 {operationalStatus, evse?}
             if (result.contains("connectorId") && !result.contains("operationalStatus")) {
                 int eid = result.value("evseId", 0);
@@ -811,7 +1520,7 @@ json CSService::translate_payload(const std::string& operation,
                 if (effective > 0)
                     result["evse"] = {{"id", effective}};
             }
-        } else if (operation == "ReserveNow") {
+        } else if (action == ocpp::Action::ReserveNow) {
             // 1.6 format {connectorId, evseId?, expiryDate, idTag, reservationId, parentIdTag?}
             // -> 2.0.1 {id, expiryDateTime, idToken, groupIdToken?, evseId?}
             if (result.contains("reservationId") && !result.contains("id")) {
@@ -833,7 +1542,7 @@ json CSService::translate_payload(const std::string& operation,
         }
     } else {
         // target is 1.6
-        if (operation == "Reset") {
+        if (action == ocpp::Action::Reset) {
             // Immediate->Hard, OnIdle->Soft
             if (result.contains("type")) {
                 auto& t = result["type"];
@@ -841,7 +1550,7 @@ json CSService::translate_payload(const std::string& operation,
                 else if (t == "OnIdle") t = "Soft";
             }
             result.erase("evseId"); // 1.6 has no evseId
-        } else if (operation == "ChangeAvailability") {
+        } else if (action == ocpp::Action::ChangeAvailability) {
             // 2.0.1 format {operationalStatus, evse?} -> 1.6 {connectorId, type}
             if (result.contains("operationalStatus") && !result.contains("connectorId")) {
                 auto status = result.value("operationalStatus", "Operative");
@@ -860,6 +1569,30 @@ void CSService::do_charge_point(const HttpRequest& req, HttpResponse& resp,
                                const std::string& identity, const std::string& operation)
 {
     auto* point = point_manager_.find_by_identity(identity);
+
+    // Station connected to another worker: forward the command to its owner
+    if (router_ && (!point || !point->connected())) {
+        if (pid_t owner = router_->remote_owner(identity)) {
+            resp.set_deferred(true);
+            auto conn = std::static_pointer_cast<HttpConnection>(req.connection_ctx);
+
+            router_->forward(owner, identity, operation, content_to_json(req).dump(),
+                std::chrono::ceil<std::chrono::seconds>(
+                    command_timeout(ocpp::action_from_string(operation))) + kForwardGrace,
+                [conn](HttpStatus status, std::string body, bool error) {
+                    HttpResponse r;
+                    if (error) {
+                        reply_error(r, status, body);
+                    } else {
+                        r.set_status(status);
+                        r.set_body(std::move(body), "application/json");
+                    }
+                    conn->send_response(r);
+                });
+            return;
+        }
+    }
+
     if (!point) {
         reply_error(resp, HttpStatus::not_found,
             fmt::format("Charge point '{}' not found", identity));
@@ -872,134 +1605,161 @@ void CSService::do_charge_point(const HttpRequest& req, HttpResponse& resp,
         return;
     }
 
-    // For 2.0.1 stations: translate and validate 2.0.1 operations
-    if (point->ocpp_version() == "2.0.1") {
-        // Translation map: 1.6 name → 2.0.1 name
-        static const std::unordered_map<std::string_view, std::string_view> translate_16_to_201 = {
-            {"RemoteStartTransaction", "RequestStartTransaction"},
-            {"RemoteStopTransaction",  "RequestStopTransaction"},
-        };
+    ChargePointCommand cmd;
+    if (auto err = prepare_command(*point, operation, content_to_json(req), cmd)) {
+        reply_error(resp, err->status, err->message);
+        return;
+    }
 
-        // Supported 2.0.1 operations
-        static const std::unordered_set<std::string_view> operations_201 = {
-            "RequestStartTransaction", "RequestStopTransaction",
-            "Reset", "SetVariables", "GetVariables",
-            "ChangeAvailability", "DataTransfer",
-            "GetBaseReport", "GetReport", "UnlockConnector",
-            "TriggerMessage", "ClearCache", "GetTransactionStatus",
-            "SendLocalList", "GetLocalListVersion",
-            "CancelReservation", "ReserveNow",
-        };
+    if (point->protocol_type() == ocpp::ProtocolType::JSON) {
+        // Defer HTTP response — will be resolved when station replies
+        resp.set_deferred(true);
+        PendingCall pending;
+        pending.conn = std::static_pointer_cast<HttpConnection>(req.connection_ctx);
+        send_command(*point, std::move(cmd), std::move(pending));
+    }
+#ifdef WITH_POSTGRESQL
+    else if (pool_) {
+        // SOAP: convert JSON to SOAP, POST to station, convert response back to JSON
+        json_to_soap(req, resp, point, std::string(ocpp::action_name(cmd.action)), cmd.payload);
+    }
+#endif
+    else {
+        reply_error(resp, HttpStatus::service_unavailable,
+            "SOAP requires PostgreSQL");
+    }
+}
 
-        // Translate 1.6 name if needed
-        std::string actual_op = operation;
-        auto tr_it = translate_16_to_201.find(operation);
-        if (tr_it != translate_16_to_201.end())
-            actual_op = std::string(tr_it->second);
+void CSService::on_forwarded_command(const std::string& identity, const std::string& operation,
+                                     const std::string& body, WorkerRouter::Reply reply)
+{
+    auto* point = point_manager_.find_by_identity(identity);
+    if (!point || !point->connected() || point->protocol_type() != ocpp::ProtocolType::JSON) {
+        reply(HttpStatus::service_unavailable,
+              fmt::format("Charge point '{}' is not connected", identity), true);
+        return;
+    }
 
-        if (!operations_201.contains(actual_op)) {
-            reply_error(resp, HttpStatus::bad_request,
+    json payload;
+    try {
+        payload = body.empty() ? json::object() : json::parse(body);
+    } catch (const std::exception& e) {
+        reply(HttpStatus::bad_request, e.what(), true);
+        return;
+    }
+
+    ChargePointCommand cmd;
+    if (auto err = prepare_command(*point, operation, std::move(payload), cmd)) {
+        reply(err->status, std::move(err->message), true);
+        return;
+    }
+
+    PendingCall pending;
+    pending.forward = std::move(reply);
+    send_command(*point, std::move(cmd), std::move(pending));
+}
+
+std::optional<CSService::ApiError> CSService::prepare_command(ocpp::CSChargingPoint& point,
+                                                              const std::string& operation,
+                                                              json body,
+                                                              ChargePointCommand& cmd)
+{
+    using ocpp::Action;
+
+    const auto& identity = point.identity();
+    const Action requested = ocpp::action_from_string(operation);
+
+    // For 2.0.1 stations: translate and validate 2.0.1 operations
+    if (point.ocpp_version() == "2.0.1") {
+        // Translate 1.6 name → 2.0.1 name if needed
+        Action action = requested;
+        if (action == Action::RemoteStartTransaction)
+            action = Action::RequestStartTransaction;
+        else if (action == Action::RemoteStopTransaction)
+            action = Action::RequestStopTransaction;
+
+        if (!is_command_201(action)) {
+            return ApiError{HttpStatus::bad_request,
                 fmt::format("Unknown 2.0.1 operation: '{}' (station {} uses OCPP 2.0.1)",
-                            operation, identity));
-            return;
+                            operation, identity)};
         }
 
-        auto body = content_to_json(req);
-
         // Save connectorId before translation (OCPP 2.0.1 RequestStartTransaction has no connectorId)
         int saved_connector_id = 0;
-        if (actual_op == "RequestStartTransaction" && body.contains("connectorId"))
+        if (action == Action::RequestStartTransaction && body.contains("connectorId"))
             saved_connector_id = body.value("connectorId", 0);
 
         // Translate payload fields for cross-version compatibility
-        body = translate_payload(actual_op, body, "2.0.1");
+        body = translate_payload(action, body, "2.0.1");
 
         // Schema validation (best-effort: passes through if no schema found)
-        if (auto err = schema_registry_.validate("2.0.1", actual_op, "Request", body)) {
-            reply_error(resp, HttpStatus::bad_request, *err);
-            return;
-        }
+        if (auto err = schema_registry_.validate(ocpp::OcppVersion::V201, action,
+                                                 ocpp::SchemaDirection::Request, body))
+            return ApiError{HttpStatus::bad_request, *err};
 
         // For emulator stations: pass connectorId hint via customData so CPEmulator
         // knows which connector to report in TransactionEvent/StatusNotification.
         // Real stations never have vendorName "Emulator" so this branch is skipped.
         if (saved_connector_id > 0) {
-            auto& boot = point->last_request("BootNotification");
+            auto& boot = point.last_request("BootNotification");
             bool is_emulator = boot.contains("chargingStation") &&
                 boot["chargingStation"].value("vendorName", "") == "Emulator";
             if (is_emulator)
                 body["customData"] = {{"vendorId", "ChargeMeCar"}, {"connectorId", saved_connector_id}};
         }
 
-        // Send via WebSocket (send_json_response handles logging + broadcast)
-        auto msg = ocpp::make_call(actual_op, body);
-        send_json_response(*point, msg);
+        cmd.action  = action;
+        cmd.payload = std::move(body);
+        return std::nullopt;
+    }
 
-        // Defer HTTP response
-        resp.set_deferred(true);
-        auto conn = std::static_pointer_cast<HttpConnection>(req.connection_ctx);
+    if (!is_command_16(requested))
+        return ApiError{HttpStatus::bad_request, fmt::format("Unknown operation: '{}'", operation)};
 
-        pending_calls_.emplace(msg.unique_id, PendingCall{
-            .conn     = std::move(conn),
-            .action   = actual_op,
-            .deadline = std::chrono::steady_clock::now() + pending_call_timeout_
-        });
+    // Translate payload fields for cross-version compatibility
+    body = translate_payload(requested, body, "1.6");
 
-        return;
-    }
+    // Schema validation (best-effort: passes through if no schema found)
+    if (auto err = schema_registry_.validate(ocpp::OcppVersion::V16, requested,
+                                             ocpp::SchemaDirection::Request, body))
+        return ApiError{HttpStatus::bad_request, *err};
 
-    // OCPP 1.6 CS→CP allowed operations (whitelist)
-    static const std::unordered_set<std::string_view> allowed_operations = {
-        "CancelReservation", "ChangeAvailability", "ChangeConfiguration",
-        "ClearCache", "ClearChargingProfile", "DataTransfer",
-        "GetCompositeSchedule", "GetConfiguration", "GetDiagnostics",
-        "GetLocalListVersion", "RemoteStartTransaction", "RemoteStopTransaction",
-        "ReserveNow", "Reset", "SendLocalList", "SetChargingProfile",
-        "TriggerMessage", "UnlockConnector", "UpdateFirmware",
-    };
+    cmd.action  = requested;
+    cmd.payload = std::move(body);
+    return std::nullopt;
+}
 
-    if (!allowed_operations.contains(operation)) {
-        reply_error(resp, HttpStatus::bad_request,
-            fmt::format("Unknown operation: '{}'", operation));
-        return;
-    }
+void CSService::send_command(ocpp::CSChargingPoint& point, ChargePointCommand cmd, PendingCall pending)
+{
+    // Build OCPP Call and send via WebSocket (send_json_response handles logging + broadcast)
+    auto msg = ocpp::make_call(cmd.action, std::move(cmd.payload));
+    send_json_response(point, msg);
 
-    auto body = content_to_json(req);
+    pending.action  = std::string(ocpp::action_name(cmd.action));
+    pending.timeout = command_timeout(cmd.action);
 
-    // Translate payload fields for cross-version compatibility
-    body = translate_payload(operation, body, "1.6");
+    auto deadline = std::chrono::steady_clock::now() + pending.timeout;
+    pending_calls_.insert(std::move(msg.unique_id), point.handle(), deadline, std::move(pending));
+    arm_pending_timer();
+}
 
-    // Schema validation (best-effort: passes through if no schema found)
-    if (auto err = schema_registry_.validate("1.6", operation, "Request", body)) {
-        reply_error(resp, HttpStatus::bad_request, *err);
+void CSService::finish_pending_call(PendingCall& pending, HttpStatus status, std::string body, bool error)
+{
+    if (pending.forward) {
+        pending.forward(status, std::move(body), error);
         return;
     }
 
-    if (point->protocol_type() == ocpp::ProtocolType::JSON) {
-        // Build OCPP Call and send via WebSocket (send_json_response handles logging + broadcast)
-        auto msg = ocpp::make_call(operation, body);
-        send_json_response(*point, msg);
+    if (!pending.conn) return;
 
-        // Defer HTTP response — will be resolved when station replies
-        resp.set_deferred(true);
-        auto conn = std::static_pointer_cast<HttpConnection>(req.connection_ctx);
-
-        pending_calls_.emplace(msg.unique_id, PendingCall{
-            .conn     = std::move(conn),
-            .action   = operation,
-            .deadline = std::chrono::steady_clock::now() + pending_call_timeout_
-        });
-    }
-#ifdef WITH_POSTGRESQL
-    else if (pool_) {
-        // SOAP: convert JSON to SOAP, POST to station, convert response back to JSON
-        json_to_soap(req, resp, point, operation, body);
-    }
-#endif
-    else {
-        reply_error(resp, HttpStatus::service_unavailable,
-            "SOAP requires PostgreSQL");
+    HttpResponse r;
+    if (error) {
+        reply_error(r, status, body);
+    } else {
+        r.set_status(status);
+        r.set_body(std::move(body), "application/json");
     }
+    pending.conn->send_response(r);
 }
 
 #ifdef WITH_POSTGRESQL
@@ -1037,20 +1797,69 @@ void CSService::do_central_system(const HttpRequest& req, HttpResponse& resp,
         });
 }
 
+// Connection-state changes are collected per identity for a short window, so
+// a station that flaps during a reconnect storm is written once, in its final
+// state; all stations changed within the window share one statement.
 void CSService::set_point_connected(const std::string& identity, bool value,
                                     const nlohmann::json& metadata)
 {
-    auto sql = fmt::format(
-        "SELECT * FROM ocpp.setchargepointconnected({}, {}, {}::jsonb)",
-        pq_quote_literal(identity),
-        value ? "true" : "false",
-        pq_quote_literal(metadata.dump()));
+    pg_connected_.put(identity, PgConnectedState{value, metadata.dump()});
+
+    if (pg_connected_.size() >= pg_connected_size_ || pg_connected_window_.count() <= 0) {
+        flush_point_connected();
+    } else if (!pg_connected_armed_) {
+        pg_connected_armed_ = true;
+        app_.worker_loop().add_timer(pg_connected_window_, [this] {
+            pg_connected_armed_ = false;
+            flush_point_connected();
+        }, false);
+    }
+}
+
+void CSService::flush_point_connected()
+{
+    if (pg_connected_.empty()) return;
+
+    auto rows = std::make_shared<std::vector<ocpp::CoalescingMap<PgConnectedState>::Entry>>(
+        pg_connected_.take());
+
+    std::string sql;
+    std::size_t length = 160;
+    for (const auto& [identity, state] : *rows)
+        length += identity.size() + state.metadata.size() + 32;
+    sql.reserve(length);
+
+    sql += "SELECT count(ocpp.setchargepointconnected(c.identity, c.connected, c.metadata::jsonb)) "
+           "FROM (VALUES ";
+    for (std::size_t i = 0; i < rows->size(); ++i) {
+        const auto& [identity, state] = (*rows)[i];
+        if (i > 0) sql += ", ";
+        sql += '(';
+        append_pg_literal(sql, identity);
+        sql += state.connected ? ", true, " : ", false, ";
+        append_pg_dollar_quoted(sql, state.metadata);
+        sql += ')';
+    }
+    sql += ") AS c(identity, connected, metadata)";
+
+    // Updates that never reached the database since the last report
+    const auto coalesced = pg_connected_.coalesced() - pg_connected_logged_;
+    pg_connected_logged_ = pg_connected_.coalesced();
+    if (coalesced > 0)
+        app_.logger().info("SetChargePointConnected: {} stations, {} updates coalesced "
+            "({} of {} since start)", rows->size(), coalesced,
+            pg_connected_.coalesced(), pg_connected_.submitted());
+    else
+        app_.logger().debug("SetChargePointConnected: {} stations", rows->size());
 
     pool_->execute(std::move(sql),
-        [this, identity](std::vector<PgResult> results) {
-            if (results.empty() || !results[0].ok()) {
-                app_.logger().error("[{}] SetChargePointConnected failed", identity);
-            }
+        [this, rows](std::vector<PgResult> results) {
+            if (results.empty() || !results[0].ok())
+                app_.logger().error("SetChargePointConnected failed for {} stations", rows->size());
+        },
+        [this, rows](std::string_view error) {
+            app_.logger().error("SetChargePointConnected for {} stations exception: {}",
+                rows->size(), error);
         });
 }
 
@@ -1063,68 +1872,242 @@ void CSService::set_point_connected(const std::string& identity, bool value,
 void CSService::parse_json_pg(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
                               const std::string& account)
 {
-    auto sql = fmt::format(
-        "SELECT * FROM ocpp.parse({}, {}, {}, {}::jsonb, {}, {})",
-        pq_quote_literal(point.identity()),
-        pq_quote_literal(msg.unique_id),
-        pq_quote_literal(msg.action),
-        pq_quote_literal(msg.payload.dump()),
-        pq_quote_literal(account),
-        pq_quote_literal(point.ocpp_version()));
+    std::string dumped;
+    std::string_view payload = msg.raw();
+    if (payload.empty()) {
+        dumped = msg.payload.dump();
+        payload = dumped;
+    }
 
-    auto identity = point.identity();
-    auto unique_id = msg.unique_id;
+    auto call = make_parse_call(point.identity(), msg.unique_id, msg.action, payload,
+                                account, point.ocpp_version());
 
-    pool_->execute(std::move(sql),
+    if (!pg_batch_.enabled || !pg_batch_.actions.test(ocpp::action_index(msg.action_id))) {
+        submit_parse_pg(point.identity(), msg.unique_id, std::move(call));
+        return;
+    }
+
+    pg_batch_items_.push_back({point.identity(), msg.unique_id, std::move(call)});
+
+    if (pg_batch_items_.size() >= pg_batch_.size) {
+        flush_parse_batch();
+    } else if (!pg_batch_armed_) {
+        pg_batch_armed_ = true;
+        app_.worker_loop().add_timer(pg_batch_.window, [this] {
+            pg_batch_armed_ = false;
+            flush_parse_batch();
+        }, false);
+    }
+}
+
+void CSService::submit_parse_pg(std::string identity, std::string unique_id, std::string call)
+{
+    ++pg_parse_in_flight_;
+
+    pool_->execute("SELECT * FROM " + call,
         [this, identity, unique_id](std::vector<PgResult> results) {
+            --pg_parse_in_flight_;
+            if (results.empty() || !results[0].ok() || results[0].rows() == 0) {
+                app_.logger().error("[{}] ocpp.parse() failed or returned empty", identity);
+                if (auto* point = point_manager_.find_by_identity(identity)) {
+                    auto error = ocpp::make_call_error(unique_id,
+                        ocpp::error::InternalError, "Database error");
+                    send_json_response(*point, error);
+                }
+                return;
+            }
+
+            reply_parse_pg(identity, unique_id, results[0].value(0, 0));
+        },
+        // on_exception: PG connection error → send CallError to station
+        [this, identity, unique_id](std::string_view error) {
+            --pg_parse_in_flight_;
+            app_.logger().error("[{}] ocpp.parse() exception: {}", identity, error);
             auto* point = point_manager_.find_by_identity(identity);
             if (!point) return;
+            auto err = ocpp::make_call_error(unique_id,
+                ocpp::error::InternalError, "Database connection error");
+            send_json_response(*point, err);
+        });
+}
 
-            if (results.empty() || !results[0].ok() || results[0].rows() == 0) {
-                app_.logger().error("[{}] ocpp.parse() failed or returned empty", identity);
-                auto error = ocpp::make_call_error(unique_id,
-                    ocpp::error::InternalError, "Database error");
-                send_json_response(*point, error);
+void CSService::flush_parse_batch()
+{
+    if (pg_batch_items_.empty()) return;
+
+    auto items = std::make_shared<std::vector<PgBatchItem>>(std::move(pg_batch_items_));
+    pg_batch_items_.clear();
+
+    if (items->size() == 1) {
+        auto& item = items->front();
+        submit_parse_pg(std::move(item.identity), std::move(item.unique_id), std::move(item.call));
+        return;
+    }
+
+    // One row per message, tagged with its position; each branch is the
+    // single-message statement:
+    //   SELECT 0, * FROM ocpp.parse(...) UNION ALL SELECT 1, * FROM ocpp.parse(...) ...
+    constexpr std::string_view kUnion = " UNION ALL ";
+    std::size_t length = 0;
+    for (const auto& item : *items)
+        length += item.call.size() + kUnion.size() + 24;
+
+    std::string sql;
+    sql.reserve(length);
+    for (std::size_t i = 0; i < items->size(); ++i) {
+        if (i > 0) sql += kUnion;
+        sql += "SELECT ";
+        sql += std::to_string(i);
+        sql += ", * FROM ";
+        sql += (*items)[i].call;
+    }
+
+    app_.logger().debug("ocpp.parse() batch of {} messages", items->size());
+
+    auto fail = [this](const PgBatchItem& item, std::string_view description) {
+        if (auto* point = point_manager_.find_by_identity(item.identity))
+            send_json_response(*point, ocpp::make_call_error(item.unique_id,
+                ocpp::error::InternalError, description));
+    };
+
+    pg_parse_in_flight_ += items->size();
+
+    pool_->execute(std::move(sql),
+        [this, items, fail](std::vector<PgResult> results) {
+            pg_parse_in_flight_ -= items->size();
+
+            // The statement fails as a whole when one message aborts it:
+            // resubmit each on its own so only the offending one errors out
+            if (results.empty() || !results[0].ok()) {
+                app_.logger().warn("ocpp.parse() batch of {} failed, resubmitting one by one",
+                    items->size());
+                for (auto& item : *items)
+                    submit_parse_pg(std::move(item.identity), std::move(item.unique_id), std::move(item.call));
                 return;
             }
 
             const auto& result = results[0];
-            const char* json_str = result.value(0, 0);
-            if (!json_str || json_str[0] == '\0') {
-                app_.logger().error("[{}] ocpp.parse() returned null", identity);
-                auto error = ocpp::make_call_error(unique_id,
-                    ocpp::error::InternalError, "Empty database response");
-                send_json_response(*point, error);
-                return;
+            std::vector<bool> answered(items->size());
+            for (int row = 0; row < result.rows(); ++row) {
+                const char* tag = result.value(row, 0);
+                const auto i = tag ? std::strtoul(tag, nullptr, 10) : items->size();
+                if (i >= items->size() || answered[i])
+                    continue;   // a set-returning parse: the first row counts, as on its own
+                answered[i] = true;
+                reply_parse_pg((*items)[i].identity, (*items)[i].unique_id, result.value(row, 1));
             }
 
-            auto j = json::parse(json_str);
+            for (std::size_t i = 0; i < items->size(); ++i) {
+                if (answered[i]) continue;
+                app_.logger().error("[{}] ocpp.parse() failed or returned empty", (*items)[i].identity);
+                fail((*items)[i], "Database error");
+            }
+        },
+        // on_exception: PG connection error → CallError to every station, as on its own
+        [this, items, fail](std::string_view error) {
+            pg_parse_in_flight_ -= items->size();
+            app_.logger().error("ocpp.parse() batch of {} exception: {}", items->size(), error);
+            for (const auto& item : *items)
+                fail(item, "Database connection error");
+        });
+}
 
-            ocpp::OcppMessage response;
-            response.unique_id = j.value("uniqueId", "");
+void CSService::reply_parse_pg(const std::string& identity, const std::string& unique_id,
+                               const char* json_str)
+{
+    auto* point = point_manager_.find_by_identity(identity);
+    if (!point) return;
 
-            auto msg_type = j.value("messageTypeId", "CallResult");
+    if (!json_str || json_str[0] == '\0') {
+        app_.logger().error("[{}] ocpp.parse() returned null", identity);
+        auto error = ocpp::make_call_error(unique_id,
+            ocpp::error::InternalError, "Empty database response");
+        send_json_response(*point, error);
+        return;
+    }
 
-            if (msg_type == "CallError") {
-                response.type = ocpp::MessageType::CallError;
-                response.error_code = j.value("errorCode", "InternalError");
-                response.error_description = j.value("errorDescription", "");
-                response.payload = j.value("errorDetails", json::object());
-            } else {
-                response.type = ocpp::MessageType::CallResult;
-                response.payload = j.value("payload", json::object());
+    auto response = ocpp::parse_backend_reply(json_str);
+    if (!response) {
+        app_.logger().error("[{}] ocpp.parse() returned malformed JSON", identity);
+        auto error = ocpp::make_call_error(unique_id,
+            ocpp::error::InternalError, "Database error");
+        send_json_response(*point, error);
+        return;
+    }
+
+    send_json_response(*point, *response);
+}
+
+// Replay the latest locally answered Heartbeat of every station through
+// ocpp.parse() in a single statement, so the database keeps its last-seen
+// bookkeeping without a round trip per Heartbeat. Rows of a failed flush are
+// kept for the next one, unless a newer Heartbeat replaced them or the
+// station has disconnected since.
+void CSService::flush_heartbeats()
+{
+    if (pg_heartbeats_.empty()) return;
+
+    auto rows = std::make_shared<PgHeartbeatRows>();
+    rows->reserve(pg_heartbeats_.size());
+    for (auto& [identity, heartbeat] : pg_heartbeats_)
+        rows->emplace_back(identity, std::move(heartbeat));
+    pg_heartbeats_.clear();
+
+    submit_heartbeats(std::move(rows));
+}
+
+// A statement that fails is split in halves until each failing row is on its
+// own, and that row is dropped: one bad row cannot hold back the others, nor
+// every later flush. After a connection error all rows are kept for the next.
+void CSService::submit_heartbeats(std::shared_ptr<PgHeartbeatRows> rows)
+{
+    std::string sql;
+    sql.reserve(rows->size() * 80 + 160);
+    sql += "SELECT count(ocpp.parse(h.identity, h.unique_id, 'Heartbeat', '{}'::jsonb, '', h.version)) "
+           "FROM (VALUES ";
+
+    bool first = true;
+    for (const auto& [identity, heartbeat] : *rows) {
+        if (!first) sql += ", ";
+        first = false;
+        sql += '(';
+        append_pg_literal(sql, identity);
+        sql += ", ";
+        append_pg_literal(sql, heartbeat.unique_id);
+        sql += ", ";
+        append_pg_literal(sql, heartbeat.version);
+        sql += ')';
+    }
+    sql += ") AS h(identity, unique_id, version)";
+
+    app_.logger().debug("ocpp.parse() Heartbeat flush of {} stations", rows->size());
+
+    pool_->execute(std::move(sql),
+        [this, rows](std::vector<PgResult> results) {
+            if (!results.empty() && results[0].ok())
+                return;
+
+            if (rows->size() == 1) {
+                app_.logger().error("[{}] ocpp.parse() Heartbeat failed, dropped", rows->front().first);
+                return;
             }
 
-            send_json_response(*point, response);
+            app_.logger().warn("ocpp.parse() Heartbeat flush of {} stations failed, splitting", rows->size());
+            const auto middle = rows->begin() + static_cast<std::ptrdiff_t>(rows->size() / 2);
+            auto second = std::make_shared<PgHeartbeatRows>(
+                std::make_move_iterator(middle), std::make_move_iterator(rows->end()));
+            rows->erase(middle, rows->end());
+            submit_heartbeats(rows);
+            submit_heartbeats(std::move(second));
         },
-        // on_exception: PG connection error → send CallError to station
-        [this, identity, unique_id](std::string_view error) {
-            app_.logger().error("[{}] ocpp.parse() exception: {}", identity, error);
-            auto* point = point_manager_.find_by_identity(identity);
-            if (!point) return;
-            auto err = ocpp::make_call_error(unique_id,
-                ocpp::error::InternalError, "Database connection error");
-            send_json_response(*point, err);
+        [this, rows](std::string_view error) {
+            app_.logger().error("ocpp.parse() Heartbeat flush of {} stations exception: {}",
+                rows->size(), error);
+            for (auto& [identity, heartbeat] : *rows) {
+                auto* point = point_manager_.find_by_identity(identity);
+                if (point && point->connected())
+                    pg_heartbeats_.try_emplace(identity, std::move(heartbeat));
+            }
         });
 }
 
@@ -1133,54 +2116,21 @@ void CSService::parse_json_pg(ocpp::CSChargingPoint& point, const ocpp::OcppMess
 void CSService::handle_action_201(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg)
 {
     // OCPP 2.0.1 CP->CSMS message handler (standalone mode)
-    nlohmann::json response;
+    if (msg.action_id == ocpp::Action::NotifyReport && msg.payload.contains("reportData")) {
+        auto& data = msg.payload["reportData"];
+        app_.logger().info("[{}] NotifyReport: requestId={}, seqNo={}, {} variables, tbc={}",
+            point.identity(),
+            msg.payload.value("requestId", 0),
+            msg.payload.value("seqNo", 0),
+            data.size(),
+            msg.payload.value("tbc", false));
+    }
 
-    if (msg.action == "BootNotification") {
-        response = {
-            {"currentTime", ocpp::iso_time_now()},
-            {"interval", 60},
-            {"status", "Accepted"}
-        };
-    } else if (msg.action == "Heartbeat") {
-        response = {{"currentTime", ocpp::iso_time_now()}};
-    } else if (msg.action == "StatusNotification") {
-        response = json::object();  // empty per spec
-    } else if (msg.action == "Authorize") {
-        response = {{"idTokenInfo", {{"status", "Accepted"}}}};
-    } else if (msg.action == "TransactionEvent") {
-        // Minimal response — optionally include idTokenInfo for Started events
-        auto event_type = msg.payload.value("eventType", "");
-        if (event_type == "Started") {
-            response = {{"idTokenInfo", {{"status", "Accepted"}}}};
-        } else {
-            response = json::object();
-        }
-    } else if (msg.action == "MeterValues") {
-        response = json::object();
-    } else if (msg.action == "DataTransfer") {
-        response = {{"status", "Accepted"}};
-    } else if (msg.action == "NotifyReport") {
-        if (msg.payload.contains("reportData")) {
-            auto& data = msg.payload["reportData"];
-            app_.logger().info("[{}] NotifyReport: requestId={}, seqNo={}, {} variables, tbc={}",
-                point.identity(),
-                msg.payload.value("requestId", 0),
-                msg.payload.value("seqNo", 0),
-                data.size(),
-                msg.payload.value("tbc", false));
-        }
-        response = json::object();
-    } else if (msg.action == "FirmwareStatusNotification") {
-        response = json::object();
-    } else {
+    if (!send_default_response(point, msg)) {
         auto error = ocpp::make_call_error(msg.unique_id, ocpp::error::NotImplemented,
             fmt::format("Action '{}' not implemented for OCPP 2.0.1", msg.action));
         send_json_response(point, error);
-        return;
     }
-
-    auto resp = ocpp::make_call_result(msg.unique_id, response);
-    send_json_response(point, resp);
 }
 
 void CSService::parse_json_webhook(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
@@ -1191,29 +2141,12 @@ void CSService::parse_json_webhook(ocpp::CSChargingPoint& point, const ocpp::Ocp
 
 void CSService::parse_json_standalone(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg)
 {
-    // Standalone mode: generate default responses in-memory
-    using namespace ocpp;
-
-    static const std::unordered_map<std::string, std::function<OcppMessage(const OcppMessage&)>> handlers = {
-        {"Authorize",          CSChargingPoint::default_authorize_response},
-        {"BootNotification",   CSChargingPoint::default_boot_notification_response},
-        {"StartTransaction",   CSChargingPoint::default_start_transaction_response},
-        {"StopTransaction",    CSChargingPoint::default_stop_transaction_response},
-        {"Heartbeat",          CSChargingPoint::default_heartbeat_response},
-        {"StatusNotification", CSChargingPoint::default_status_notification_response},
-        {"DataTransfer",       CSChargingPoint::default_data_transfer_response},
-        {"MeterValues",        CSChargingPoint::default_meter_values_response},
-    };
-
-    auto it = handlers.find(msg.action);
-    if (it != handlers.end()) {
-        auto response = it->second(msg);
-        send_json_response(point, response);
-    } else {
-        auto response = ocpp::make_call_error(msg.unique_id,
+    // Standalone mode: pre-rendered default responses
+    if (!send_default_response(point, msg)) {
+        auto error = ocpp::make_call_error(msg.unique_id,
             ocpp::error::NotImplemented,
             fmt::format("Action '{}' is not supported", msg.action));
-        send_json_response(point, response);
+        send_json_response(point, error);
     }
 }
 
@@ -1228,143 +2161,751 @@ void CSService::webhook_json(ocpp::CSChargingPoint& point, const ocpp::OcppMessa
         return;
     }
 
-    json webhook_payload = {
-        {"identity",  point.identity()},
-        {"uniqueId",  msg.unique_id},
-        {"action",    msg.action},
-        {"payload",   msg.payload},
-        {"account",   account}
-    };
-
-    auto identity = point.identity();
-    auto unique_id = msg.unique_id;
+    if (!webhook_client_) {
+        // Authorization is rendered once into the client's request head
+        WebhookClient::Options options;
+        options.url         = webhook_.url;
+        options.connections = webhook_.connections;
+        options.pipeline    = webhook_.pipeline;
+        options.queue       = webhook_.queue;
+        options.timeout     = std::chrono::seconds(webhook_.timeout);
 
-    // Build headers
-    FetchClient::Headers headers;
-    headers.emplace_back("Content-Type", "application/json");
+        if (webhook_.auth_scheme == "Basic" && !webhook_.username.empty())
+            options.authorization = "Basic " + base64_encode(webhook_.username + ":" + webhook_.password);
+        else if (webhook_.auth_scheme == "Bearer" && !webhook_.token.empty())
+            options.authorization = "Bearer " + webhook_.token;
 
-    if (webhook_.auth_scheme == "Basic" && !webhook_.username.empty()) {
-        auto credentials = webhook_.username + ":" + webhook_.password;
-        headers.emplace_back("Authorization", "Basic " + base64_encode(credentials));
-    } else if (webhook_.auth_scheme == "Bearer" && !webhook_.token.empty()) {
-        headers.emplace_back("Authorization", "Bearer " + webhook_.token);
+        try {
+            webhook_client_ = std::make_unique<WebhookClient>(app_.worker_loop(), std::move(options));
+        } catch (const std::invalid_argument& e) {
+            app_.logger().error("{}; falling back to standalone mode", e.what());
+            webhook_.enabled = false;
+            parse_json_standalone(point, msg);
+            return;
+        }
     }
 
-    // Use FetchClient instance to POST to webhook
-    if (!fetch_client_) {
-        fetch_client_ = std::make_unique<FetchClient>(app_.worker_loop());
+    // Envelope: {account, action, identity, payload, uniqueId}; the payload is spliced in
+    // as the original bytes received from the station
+    std::string body;
+    body.reserve(msg.raw().size() + point.identity().size() + msg.unique_id.size() +
+                 msg.action.size() + account.size() + 80);
+    body += R"({"account":)";
+    ocpp::append_json_string(body, account);
+    body += R"(,"action":)";
+    ocpp::append_json_string(body, msg.action);
+    body += R"(,"identity":)";
+    ocpp::append_json_string(body, point.identity());
+    body += R"(,"payload":)";
+    msg.append_payload(body);
+    body += R"(,"uniqueId":)";
+    ocpp::append_json_string(body, msg.unique_id);
+    body += '}';
+
+    if (webhook_.breaker && !webhook_breaker_.allow(std::chrono::steady_clock::now())) {
+        webhook_unavailable(point, msg, std::move(body));
+        return;
     }
 
-    auto body = webhook_payload.dump();
-
     app_.logger().debug("[{}] webhook POST {} (action: {}, auth: {})",
-        identity, webhook_.url, msg.action,
+        point.identity(), webhook_.url, msg.action,
         webhook_.auth_scheme.empty() ? "none" : webhook_.auth_scheme);
 
-    fetch_client_->post(webhook_.url, body, headers,
-        [this, identity, unique_id](FetchResponse fetch_resp) {
-            auto* point = point_manager_.find_by_identity(identity);
-            if (!point) return;
+    if (!webhook_.batch.enabled || !webhook_.batch.actions.test(ocpp::action_index(msg.action_id))) {
+        post_webhook(point.identity(), msg.unique_id, std::move(body));
+        return;
+    }
+
+    webhook_batch_items_.push_back({point.identity(), msg.unique_id, std::move(body)});
+
+    if (webhook_batch_items_.size() >= webhook_.batch.size) {
+        flush_webhook_batch();
+    } else if (!webhook_batch_armed_) {
+        webhook_batch_armed_ = true;
+        app_.worker_loop().add_timer(webhook_.batch.window, [this] {
+            webhook_batch_armed_ = false;
+            flush_webhook_batch();
+        }, false);
+    }
+}
+
+void CSService::post_webhook(std::string identity, std::string unique_id, std::string body)
+{
+    const auto sent = std::chrono::steady_clock::now();
+
+    webhook_client_->post(std::move(body),
+        [this, identity, unique_id, sent](FetchResponse fetch_resp) {
+            record_webhook(fetch_resp.status_code < 500, sent, 1);
 
             if (fetch_resp.status_code < 200 || fetch_resp.status_code >= 300) {
                 app_.logger().error("[{}] webhook error: HTTP {}: {}", identity,
                     fetch_resp.status_code, fetch_resp.body);
-                auto error = ocpp::make_call_error(unique_id,
-                    ocpp::error::InternalError, "Webhook error");
-                send_json_response(*point, error);
+                fail_webhook(identity, unique_id, "Webhook error");
                 return;
             }
 
             try {
-                auto resp_json = json::parse(fetch_resp.body);
-
-                ocpp::OcppMessage response;
-                response.unique_id = resp_json.value("uniqueId", unique_id);
-
-                // messageTypeId can be int (3/4) or string ("CallResult"/"CallError")
-                bool is_error = false;
-                if (resp_json.contains("messageTypeId")) {
-                    const auto& mt = resp_json["messageTypeId"];
-                    if (mt.is_number())
-                        is_error = (mt.get<int>() == 4);
-                    else if (mt.is_string())
-                        is_error = (mt.get<std::string>() == "CallError");
-                }
-
-                if (is_error) {
-                    response.type = ocpp::MessageType::CallError;
-                    response.error_code = resp_json.value("errorCode", "InternalError");
-                    response.error_description = resp_json.value("errorDescription", "");
-                    response.payload = resp_json.contains("errorDetails")
-                        ? resp_json["errorDetails"] : resp_json.value("payload", json::object());
-                } else {
-                    response.type = ocpp::MessageType::CallResult;
-                    response.payload = resp_json.value("payload", json::object());
-                }
-
-                send_json_response(*point, response);
+                reply_webhook(identity, unique_id, json::parse(fetch_resp.body));
             } catch (const std::exception& e) {
                 app_.logger().error("[{}] webhook response parse error: {}",
                     identity, e.what());
-                auto error = ocpp::make_call_error(unique_id,
-                    ocpp::error::InternalError, "Webhook response parse error");
-                send_json_response(*point, error);
+                fail_webhook(identity, unique_id, "Webhook response parse error");
             }
         },
-        [this, identity, unique_id](std::string_view error) {
+        [this, identity, unique_id, sent](std::string_view error) {
             app_.logger().error("[{}] webhook fetch error: {}", identity, error);
-            auto* point = point_manager_.find_by_identity(identity);
-            if (!point) return;
-            auto err = ocpp::make_call_error(unique_id,
-                ocpp::error::InternalError, "Webhook fetch error");
-            send_json_response(*point, err);
+            record_webhook(false, sent, 1);
+            fail_webhook(identity, unique_id, "Webhook fetch error");
+        });
+}
+
+void CSService::flush_webhook_batch()
+{
+    if (webhook_batch_items_.empty()) return;
+
+    auto items = std::make_shared<std::vector<WebhookBatchItem>>(std::move(webhook_batch_items_));
+    webhook_batch_items_.clear();
+
+    if (items->size() == 1) {
+        auto& item = items->front();
+        post_webhook(std::move(item.identity), std::move(item.unique_id), std::move(item.envelope));
+        return;
+    }
+
+    // [envelope, envelope, ...]; the webhook answers with an array of responses
+    std::size_t length = 2;
+    for (const auto& item : *items)
+        length += item.envelope.size() + 1;
+
+    std::string body;
+    body.reserve(length);
+    body += '[';
+    for (std::size_t i = 0; i < items->size(); ++i) {
+        if (i > 0) body += ',';
+        body += (*items)[i].envelope;
+        (*items)[i].envelope = {};
+    }
+    body += ']';
+
+    app_.logger().debug("webhook batch of {} messages", items->size());
+
+    auto fail_all = [this, items](std::string_view description) {
+        for (const auto& item : *items)
+            fail_webhook(item.identity, item.unique_id, description);
+    };
+
+    const auto sent = std::chrono::steady_clock::now();
+
+    webhook_client_->post(std::move(body),
+        [this, items, fail_all, sent](FetchResponse fetch_resp) {
+            record_webhook(fetch_resp.status_code < 500, sent, items->size());
+
+            if (fetch_resp.status_code < 200 || fetch_resp.status_code >= 300) {
+                app_.logger().error("webhook batch of {} error: HTTP {}: {}", items->size(),
+                    fetch_resp.status_code, fetch_resp.body);
+                fail_all("Webhook error");
+                return;
+            }
+
+            json responses;
+            try {
+                responses = json::parse(fetch_resp.body);
+                if (!responses.is_array())
+                    throw std::runtime_error("expected an array of responses");
+            } catch (const std::exception& e) {
+                app_.logger().error("webhook batch response parse error: {}", e.what());
+                fail_all("Webhook response parse error");
+                return;
+            }
+
+            // Responses are matched by uniqueId (and identity, when given);
+            // the common case is the same order as the request. A uniqueId
+            // that two stations in the batch share needs the identity too.
+            const std::size_t n = items->size();
+            std::vector<bool> answered(n, false);
+            std::vector<bool> shared(n, false);
+            ocpp::StringMap<std::size_t> first;
+            for (std::size_t k = 0; k < n; ++k) {
+                auto [it, inserted] = first.try_emplace((*items)[k].unique_id, k);
+                if (!inserted)
+                    shared[k] = shared[it->second] = true;
+            }
+
+            for (std::size_t i = 0; i < responses.size(); ++i) {
+                const auto& response = responses[i];
+                if (!response.is_object() || !response.contains("uniqueId") || !response["uniqueId"].is_string()) {
+                    app_.logger().warn("webhook batch: response #{} has no uniqueId, ignored", i);
+                    continue;
+                }
+
+                const auto& uid = response["uniqueId"].get_ref<const std::string&>();
+                const auto identity = response.value("identity", std::string{});
+                auto matches = [&](std::size_t k) {
+                    const auto& item = (*items)[k];
+                    return !answered[k] && item.unique_id == uid &&
+                           (identity.empty() ? !shared[k] : item.identity == identity);
+                };
+
+                std::size_t k = i < n && matches(i) ? i : 0;
+                while (k < n && !matches(k)) ++k;
+                if (k == n) {
+                    if (identity.empty() && first.contains(uid))
+                        app_.logger().warn("webhook batch: response for uniqueId '{}' has no identity, "
+                                           "but several stations sent it; ignored", uid);
+                    else
+                        app_.logger().warn("webhook batch: no message with uniqueId '{}'", uid);
+                    continue;
+                }
+
+                answered[k] = true;
+                const auto& item = (*items)[k];
+                try {
+                    reply_webhook(item.identity, item.unique_id, response);
+                } catch (const std::exception& e) {
+                    app_.logger().error("[{}] webhook response parse error: {}", item.identity, e.what());
+                    fail_webhook(item.identity, item.unique_id, "Webhook response parse error");
+                }
+            }
+
+            for (std::size_t k = 0; k < n; ++k) {
+                if (answered[k]) continue;
+                const auto& item = (*items)[k];
+                app_.logger().error("[{}] webhook batch: no response for '{}'", item.identity, item.unique_id);
+                fail_webhook(item.identity, item.unique_id, "Webhook response missing");
+            }
+        },
+        [this, items, fail_all, sent](std::string_view error) {
+            app_.logger().error("webhook batch of {} fetch error: {}", items->size(), error);
+            record_webhook(false, sent, items->size());
+            fail_all("Webhook fetch error");
         });
 }
 
-// ── Pending call cleanup ────────────────────────────────────────────────────
+// One webhook response object -> CallResult / CallError to the station
+void CSService::reply_webhook(const std::string& identity, const std::string& unique_id,
+                              const json& resp_json)
+{
+    auto* point = point_manager_.find_by_identity(identity);
+    if (!point) return;
+
+    ocpp::OcppMessage response;
+    response.unique_id = resp_json.value("uniqueId", unique_id);
+
+    // messageTypeId can be int (3/4) or string ("CallResult"/"CallError")
+    bool is_error = false;
+    if (resp_json.contains("messageTypeId")) {
+        const auto& mt = resp_json["messageTypeId"];
+        if (mt.is_number())
+            is_error = (mt.get<int>() == 4);
+        else if (mt.is_string())
+            is_error = (mt.get<std::string>() == "CallError");
+    }
 
-void CSService::cleanup_expired_calls()
+    if (is_error) {
+        response.type = ocpp::MessageType::CallError;
+        response.error_code = resp_json.value("errorCode", "InternalError");
+        response.error_description = resp_json.value("errorDescription", "");
+        response.payload = resp_json.contains("errorDetails")
+            ? resp_json["errorDetails"] : resp_json.value("payload", json::object());
+    } else {
+        response.type = ocpp::MessageType::CallResult;
+        response.payload = resp_json.value("payload", json::object());
+    }
+
+    send_json_response(*point, response);
+}
+
+void CSService::fail_webhook(const std::string& identity, const std::string& unique_id,
+                             std::string_view description)
 {
-    if (pending_calls_.empty()) return;
+    auto* point = point_manager_.find_by_identity(identity);
+    if (!point) return;
+    auto error = ocpp::make_call_error(unique_id, ocpp::error::InternalError, description);
+    send_json_response(*point, error);
+}
 
-    auto now = std::chrono::steady_clock::now();
-    for (auto it = pending_calls_.begin(); it != pending_calls_.end(); ) {
-        if (now >= it->second.deadline) {
-            app_.logger().warn("pending call {} ({}) timed out after {}s",
-                it->first, it->second.action, pending_call_timeout_.count());
+// ── Webhook circuit breaker ─────────────────────────────────────────────────
 
-            HttpResponse r;
-            reply_error(r, HttpStatus::service_unavailable,
-                fmt::format("Charge point did not respond within {}s",
-                    pending_call_timeout_.count()));
-            it->second.conn->send_response(r);
+// The breaker is open: answer safe messages from the standalone path and keep
+// their envelopes for later delivery; anything else fails fast.
+void CSService::webhook_unavailable(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
+                                    std::string envelope)
+{
+    if (!webhook_.fallback.test(ocpp::action_index(msg.action_id))) {
+        fail_webhook(point.identity(), msg.unique_id, "Webhook unavailable");
+        return;
+    }
+
+    if (point.ocpp_version() == "2.0.1")
+        handle_action_201(point, msg);
+    else
+        parse_json_standalone(point, msg);
+
+    if (webhook_.deferred == 0)
+        return;
+    if (webhook_deferred_.size() >= webhook_.deferred) {
+        app_.logger().warn("webhook: deferred queue full ({}), dropping the oldest message",
+            webhook_deferred_.size());
+        webhook_deferred_.pop_front();
+    }
+    webhook_deferred_.push_back(std::move(envelope));
+}
+
+// Feed @p count outcomes of one webhook request (sent at @p sent) to the
+// breaker. HTTP 4xx still counts as healthy: the backend answered.
+void CSService::record_webhook(bool healthy, std::chrono::steady_clock::time_point sent, std::size_t count)
+{
+    if (!webhook_.breaker) return;
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(now - sent);
+    const auto before = webhook_breaker_.state();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (healthy)
+            webhook_breaker_.record_success(latency, now);
+        else
+            webhook_breaker_.record_failure(now);
+    }
+
+    const auto after = webhook_breaker_.state();
+    if (after != before) {
+        if (after == ocpp::CircuitBreaker::State::Open)
+            app_.logger().warn("webhook unhealthy (error rate {:.0f}%, latency {} ms), "
+                               "answering fallback actions locally",
+                               webhook_breaker_.error_rate() * 100, webhook_breaker_.latency().count());
+        else if (after == ocpp::CircuitBreaker::State::Closed)
+            app_.logger().notice("webhook recovered, delivering {} deferred messages",
+                                 webhook_deferred_.size());
+    }
 
-            it = pending_calls_.erase(it);
+    if (after == ocpp::CircuitBreaker::State::Closed)
+        drain_webhook_deferred();
+}
+
+// Deliver envelopes answered locally while the breaker was open. Their
+// responses are only used for health: the stations already have an answer.
+// At most `connections` requests are outstanding, so a recovering backend
+// is not flooded.
+void CSService::drain_webhook_deferred()
+{
+    if (webhook_draining_ || !webhook_client_) return;
+    webhook_draining_ = true;
+
+    while (!webhook_deferred_.empty() && webhook_deferred_in_flight_ < webhook_.connections &&
+           webhook_breaker_.state() == ocpp::CircuitBreaker::State::Closed) {
+        const std::size_t count = webhook_.batch.enabled
+            ? std::min(webhook_.batch.size, webhook_deferred_.size()) : 1;
+
+        auto envelopes = std::make_shared<std::vector<std::string>>();
+        envelopes->reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            envelopes->push_back(std::move(webhook_deferred_.front()));
+            webhook_deferred_.pop_front();
+        }
+
+        std::string body;
+        if (count == 1) {
+            body = envelopes->front();
         } else {
-            ++it;
+            body += '[';
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i > 0) body += ',';
+                body += (*envelopes)[i];
+            }
+            body += ']';
         }
+
+        // Undelivered envelopes go back to the front, in order
+        auto requeue = [this, envelopes]() {
+            if (webhook_deferred_.size() + envelopes->size() > webhook_.deferred) {
+                app_.logger().warn("webhook: deferred queue full, dropping {} undelivered messages",
+                                   envelopes->size());
+                return;
+            }
+            for (auto it = envelopes->rbegin(); it != envelopes->rend(); ++it)
+                webhook_deferred_.push_front(std::move(*it));
+        };
+
+        ++webhook_deferred_in_flight_;
+        const auto sent = std::chrono::steady_clock::now();
+
+        webhook_client_->post(std::move(body),
+            [this, count, sent, requeue](FetchResponse fetch_resp) {
+                --webhook_deferred_in_flight_;
+                if (fetch_resp.status_code >= 500)
+                    requeue();
+                else if (fetch_resp.status_code < 200 || fetch_resp.status_code >= 300)
+                    app_.logger().warn("webhook: deferred delivery of {} rejected: HTTP {}",
+                                       count, fetch_resp.status_code);
+                record_webhook(fetch_resp.status_code < 500, sent, count);
+            },
+            [this, count, sent, requeue](std::string_view error) {
+                --webhook_deferred_in_flight_;
+                app_.logger().warn("webhook: deferred delivery of {} failed: {}", count, error);
+                requeue();
+                record_webhook(false, sent, count);
+            });
     }
+
+    webhook_draining_ = false;
 }
 
-// ── Logging ─────────────────────────────────────────────────────────────────
+// ── Authorization cache ─────────────────────────────────────────────────────
 
-void CSService::log_json_message(const std::string& identity, const ocpp::OcppMessage& msg)
+// Authorize (1.6, 2.0.1) and 2.0.1 TransactionEvent Started carrying an idToken:
+// both are answered with just the token's info, which the cache holds.
+void CSService::check_authorization_cache(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg)
 {
-    auto type_str = [](ocpp::MessageType t) -> const char* {
-        switch (t) {
-            case ocpp::MessageType::Call:       return "Call";
-            case ocpp::MessageType::CallResult: return "CallResult";
-            case ocpp::MessageType::CallError:  return "CallError";
+    const bool v201 = point.ocpp_version() == "2.0.1";
+    const bool started = v201 && msg.action_id == ocpp::Action::TransactionEvent &&
+                         msg.payload.value("eventType", "") == "Started";
+    if (msg.action_id != ocpp::Action::Authorize && !started)
+        return;
+
+    std::string token;
+    std::string key;
+
+    if (v201) {
+        // Certificate checks need the backend's certificateStatus: never cached
+        if (msg.payload.contains("certificate") || msg.payload.contains("iso15118CertificateHashData"))
+            return;
+        auto id = msg.payload.find("idToken");
+        if (id == msg.payload.end() || !id->is_object())
+            return;
+        token = id->value("idToken", "");
+        key = ocpp::AuthorizationCache::make_key(point.ocpp_version(), point.account(),
+                                                 token + '\x1f' + id->value("type", ""));
+    } else {
+        token = msg.payload.value("idTag", "");
+        key = ocpp::AuthorizationCache::make_key(point.ocpp_version(), point.account(), token);
+    }
+
+    if (token.empty())
+        return;
+
+    bool answered = false;
+    if (const auto* info = authorize_cache_.find(key, std::chrono::system_clock::now())) {
+        app_.logger().debug("[{}] {} '{}' answered from cache", point.identity(), msg.action, token);
+        send_json_response(point, ocpp::make_call_result(msg.unique_id,
+            {{v201 ? "idTokenInfo" : "idTagInfo", *info}}));
+        answered = true;
+    }
+
+    authorize_calls_.insert_or_assign(point.identity() + '\x1f' + msg.unique_id,
+        AuthorizeCall{std::move(key), std::move(token), answered});
+}
+
+bool CSService::settle_authorize_call(const std::string& identity, const ocpp::OcppMessage& response,
+                                      bool learn)
+{
+    auto it = authorize_calls_.find(identity + '\x1f' + response.unique_id);
+    if (it == authorize_calls_.end())
+        return false;
+
+    auto call = std::move(it->second);
+    authorize_calls_.erase(it);
+
+    // A CallError says nothing about the token: the cache is left as it is
+    if (learn && response.type == ocpp::MessageType::CallResult) {
+        auto info = response.payload.find("idTagInfo");
+        if (info == response.payload.end())
+            info = response.payload.find("idTokenInfo");
+
+        if (info != response.payload.end()) {
+            if (call.answered && info->value("status", "") != "Accepted")
+                app_.logger().warn("[{}] Authorize '{}' answered Accepted from cache, backend says {}",
+                    identity, call.token, info->value("status", ""));
+            authorize_cache_.store(std::move(call.key), call.token, *info, std::chrono::system_clock::now());
         }
-        return "Unknown";
-    };
+    }
+
+    return call.answered;
+}
+
+std::size_t CSService::invalidate_authorization_cache(std::string_view token)
+{
+    std::size_t removed;
+    if (token.empty()) {
+        removed = authorize_cache_.size();
+        authorize_cache_.clear();
+    } else {
+        removed = authorize_cache_.invalidate(token);
+    }
 
-    global_logger().debug("[{}] [{}] [{}] [{}] {}",
-        identity,
-        msg.unique_id.empty() ? "(empty)" : msg.unique_id,
-        msg.action.empty() ? "(empty)" : msg.action,
-        type_str(msg.type),
-        msg.payload.dump());
+    app_.logger().info("Authorization cache: {} '{}' ({} entries removed)",
+        token.empty() ? "cleared" : "invalidated", token, removed);
+    return removed;
+}
+
+// POST /api/v1/AuthorizationCache {"idTag": "..."} drops one token, without a
+// body the whole cache. Other workers are notified through the router.
+void CSService::do_authorization_cache(const HttpRequest& req, HttpResponse& resp)
+{
+    auto body = content_to_json(req);
+
+    std::string token;
+    if (body.is_object()) {
+        token = body.value("idTag", "");
+        if (token.empty())
+            token = body.value("idToken", "");
+    }
+
+    auto removed = invalidate_authorization_cache(token);
+    if (router_)
+        router_->broadcast("AuthorizationCache", token);
+
+    json result = {{"removed", removed}, {"size", authorize_cache_.size()}};
+    resp.set_status(HttpStatus::ok);
+    resp.set_body(result.dump(), "application/json");
+}
+
+// ── Traffic journal ─────────────────────────────────────────────────────────
+
+void CSService::journal_append(const ocpp::TrafficJournal::Record& record)
+{
+    try {
+        journal_->append(record);
+    } catch (const std::exception& e) {
+        app_.logger().error("Traffic journal disabled: {}", e.what());
+        journal_.reset();
+    }
+}
+
+// Frames to a station, as they leave for its outbound queue
+void CSService::journal_outbound(const std::string& identity, std::string_view text)
+{
+    ocpp::OcppFrame frame;
+    try {
+        frame = ocpp::parse_ocpp_frame(text);
+    } catch (const std::exception&) {
+        return;  // not an OCPP frame; we only send what we built
+    }
+
+    ocpp::TrafficJournal::Record record;
+    record.time      = ocpp::TrafficJournal::clock::now();
+    record.identity  = identity;
+    record.direction = ocpp::LogDirection::Out;
+    record.type      = frame.type;
+    record.action    = ocpp::action_from_string(frame.action);
+    record.unique_id = frame.unique_id;
+    record.payload   = frame.payload;
+
+    ocpp::OcppMessage decoded;
+    if (frame.escaped) {
+        decoded          = frame.envelope();
+        record.action    = decoded.action_id;
+        record.unique_id = decoded.unique_id;
+    }
+
+    journal_append(record);
+}
+
+// POST /api/v1/Journal {"from": "...", "to": "...", "identity": "...", "limit": N}
+// All fields are optional. Entries of all workers, in time order, as on /ws/log;
+// beyond `limit` the earliest are returned and "truncated" is set. At most
+// kJournalExportScan bytes of segments in the range are read; "complete" is
+// false when the scan stopped there. Authenticated API only: frames carry
+// idTags and tokens.
+void CSService::do_journal(const HttpRequest& req, HttpResponse& resp)
+{
+    if (journal_dir_.empty()) {
+        reply_error(resp, HttpStatus::not_found, "Traffic journal is disabled");
+        return;
+    }
+
+    auto body = content_to_json(req);
+
+    ocpp::TrafficJournal::Query query;
+    query.max_scan = kJournalExportScan;
+    std::size_t limit = 10000;
+    if (body.is_object()) {
+        for (auto [key, bound] : {std::pair{"from", &query.from}, std::pair{"to", &query.to}}) {
+            if (!body.contains(key))
+                continue;
+            auto time = body[key].is_string() ? ocpp::parse_rfc3339(body[key].get<std::string>()) : std::nullopt;
+            if (!time) {
+                reply_error(resp, HttpStatus::bad_request, std::string("Invalid '") + key + "' time");
+                return;
+            }
+            *bound = *time;
+        }
+        query.identity = body.value("identity", "");
+        limit = std::clamp<std::size_t>(body.value("limit", limit), 1, kJournalExportLimit);
+    }
+
+    // Keep the earliest `limit` entries; segments of several workers interleave
+    using Entry = std::pair<ocpp::TrafficJournal::time_point, std::string>;
+    std::vector<Entry> entries;
+    bool truncated = false;
+    auto by_time = [](const Entry& a, const Entry& b) { return a.first < b.first; };
+
+    const auto scan = ocpp::TrafficJournal::read(journal_dir_, query, [&](const ocpp::TrafficJournal::Record& record) {
+        std::string entry;
+        ocpp::append_log_event(entry, ocpp::to_log_event(record));
+        entries.emplace_back(record.time, std::move(entry));
+        if (entries.size() >= 2 * limit) {
+            std::nth_element(entries.begin(), entries.begin() + limit, entries.end(), by_time);
+            entries.resize(limit);
+            truncated = true;
+        }
+    });
+
+    std::stable_sort(entries.begin(), entries.end(), by_time);
+    if (entries.size() > limit) {
+        entries.resize(limit);
+        truncated = true;
+    }
+
+    std::string result = R"({"count":)" + std::to_string(entries.size()) +
+                         R"(,"truncated":)" + (truncated ? "true" : "false") +
+                         R"(,"complete":)" + (scan.complete ? "true" : "false") + R"(,"entries":[)";
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (i) result += ',';
+        result += entries[i].second;
+    }
+    result += "]}";
+
+    resp.set_status(HttpStatus::ok);
+    resp.set_body(result, "application/json");
+}
+
+// ── Admission control ───────────────────────────────────────────────────────
+
+// A BootNotification refused by the admission controller is answered Pending
+// with a random interval, so the station re-boots later (OCPP 1.6 4.2 /
+// 2.0.1 B02); nothing reaches the backend.
+bool CSService::admit_boot_notification(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg)
+{
+    if (!admission_->admit_boot(backend_queue_depth())) {
+        const auto interval = admission_->pending_interval();
+        app_.logger().debug("[{}] BootNotification deferred for {}s", point.identity(), interval.count());
+        send_json_response(point, ocpp::make_call_result(msg.unique_id, {
+            {"status", "Pending"}, {"currentTime", ocpp::iso_time_now()}, {"interval", interval.count()}}));
+        return false;
+    }
+
+    bool backend = webhook_.enabled;
+#ifdef WITH_POSTGRESQL
+    backend = backend || pool_;
+#endif
+    // Standalone mode answers right away; a repeated uniqueId is already
+    // holding its slot until the first call is answered
+    if (!backend || !boot_calls_.insert(point.identity() + '\x1f' + msg.unique_id).second)
+        admission_->boot_finished();
+
+    return true;
+}
+
+void CSService::finish_boot_call(const std::string& identity, std::string_view unique_id)
+{
+    std::string key;
+    key.reserve(identity.size() + unique_id.size() + 1);
+    key.append(identity).append(1, '\x1f').append(unique_id);
+
+    if (boot_calls_.erase(key))
+        admission_->boot_finished();
+}
+
+// Messages handed to the backend and not answered yet
+std::size_t CSService::backend_queue_depth() const
+{
+    std::size_t depth = webhook_batch_items_.size();
+    if (webhook_client_)
+        depth += webhook_client_->queued();
+#ifdef WITH_POSTGRESQL
+    depth += pg_parse_in_flight_ + pg_batch_items_.size();
+#endif
+    return depth;
+}
+
+void CSService::log_admission()
+{
+    const auto& stats = admission_->stats();
+    if (stats.upgrades_rejected == admission_logged_.upgrades_rejected &&
+        stats.boots_pending == admission_logged_.boots_pending)
+        return;  // nothing refused since the last report
+
+    app_.logger().info("Admission: {} upgrades admitted, {} refused; {} BootNotifications admitted, "
+        "{} answered Pending; {} in flight (last {}s: {} refused, {} Pending)",
+        stats.upgrades_admitted, stats.upgrades_rejected, stats.boots_admitted, stats.boots_pending,
+        admission_->boots_in_flight(),
+        std::chrono::duration_cast<std::chrono::seconds>(kCleanupInterval).count(),
+        stats.upgrades_rejected - admission_logged_.upgrades_rejected,
+        stats.boots_pending - admission_logged_.boots_pending);
+
+    admission_logged_ = stats;
+}
+
+// ── Pending call expiry ─────────────────────────────────────────────────────
+
+std::chrono::milliseconds CSService::command_timeout(ocpp::Action action) const
+{
+    return action == ocpp::Action::Unknown ? kDefaultCommandTimeout
+                                           : command_timeouts_[ocpp::action_index(action)];
+}
+
+void CSService::arm_pending_timer()
+{
+    auto next = pending_calls_.next_deadline();
+    if (!next || (pending_timer_at_ && *pending_timer_at_ <= *next))
+        return;
+
+    // A timer for a later deadline may still be outstanding; it will find
+    // nothing (or something new) to expire, which is harmless.
+    pending_timer_at_ = *next;
+    auto delay = std::chrono::ceil<std::chrono::milliseconds>(*next - std::chrono::steady_clock::now());
+
+    app_.worker_loop().add_timer(std::max(delay, std::chrono::milliseconds(0)), [this, at = *next] {
+        if (pending_timer_at_ == at)
+            pending_timer_at_.reset();
+        expire_pending_calls();
+    }, false);
+}
+
+void CSService::expire_pending_calls()
+{
+    pending_calls_.expire(std::chrono::steady_clock::now(), [this](auto& call) {
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(call.value.timeout).count();
+
+        app_.logger().warn("pending call {} ({}) timed out after {}s",
+            call.unique_id, call.value.action, seconds);
+
+        finish_pending_call(call.value, HttpStatus::service_unavailable,
+            fmt::format("Charge point did not respond within {}s", seconds), true);
+    });
+
+    arm_pending_timer();
+}
+
+// ── Logging ─────────────────────────────────────────────────────────────────
+
+void CSService::log_message(const ocpp::LogEvent& event, ocpp::Action action)
+{
+    // The payload is serialized only if the logger formats the line
+    app_.logger().debug("[{}] [{}] [{}] [{}] {}", event.identity,
+        event.unique_id.empty() ? "(empty)" : event.unique_id,
+        event.action.empty() ? "(empty)" : event.action,
+        ocpp::message_type_name(event.type), ocpp::LogPayload{event});
+
+    // Nothing is formatted unless the record is kept
+    if (!message_log_ || !message_log_->sample(action))
+        return;
+
+    std::string record;
+    ocpp::append_log_event(record, event);
+    message_log_->push(std::move(record));
+}
+
+void CSService::log_message_counters()
+{
+    const auto counters = message_log_->counters();
+    if (counters.dropped == message_log_dropped_)
+        return;
+
+    app_.logger().warn("Message log: {} records dropped, writer behind ({} queued, {} written, {} sampled out)",
+        counters.dropped - message_log_dropped_, counters.logged, counters.written, counters.skipped);
+    message_log_dropped_ = counters.dropped;
 }
 
 // ── Utilities ───────────────────────────────────────────────────────────────
@@ -1379,9 +2920,19 @@ nlohmann::json CSService::charge_point_to_json(const ocpp::CSChargingPoint& poin
     };
 
     if (point.connected() && point.ws_connection()) {
+        const int fd = point.ws_connection()->fd();
         result["connection"] = {
-            {"fd", point.ws_connection()->fd()}
+            {"fd", fd}
         };
+        if (auto it = outbound_.find(fd); it != outbound_.end()) {
+            const auto& queue = it->second.queue;
+            result["connection"]["outbound"] = {
+                {"queuedBytes", queue.queued_bytes()},
+                {"queuedFrames", queue.queued_frames()},
+                {"peakBytes", queue.counters().peak_bytes},
+                {"delayedFrames", queue.counters().queued_frames}
+            };
+        }
     }
 
     // Include last boot notification and status if available
@@ -17,13 +17,30 @@
 #endif
 
 #include "ocpp/protocol.hpp"
+#include "ocpp/admission_controller.hpp"
+#include "ocpp/authorization_cache.hpp"
 #include "ocpp/charging_point.hpp"
+#include "ocpp/circuit_breaker.hpp"
+#include "ocpp/coalescing_map.hpp"
+#include "ocpp/log_stream.hpp"
+#include "ocpp/message_log.hpp"
+#include "ocpp/outbound_queue.hpp"
+#include "ocpp/pending_calls.hpp"
 #include "ocpp/schema_registry.hpp"
+#include "ocpp/string_map.hpp"
+#include "ocpp/traffic_journal.hpp"
 
+#include "WebhookClient.hpp"
+#include "WorkerRouter.hpp"
+
+#include <array>
 #include <chrono>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <functional>
@@ -33,6 +50,19 @@ namespace apostol
 
 class FetchClient;  // forward declaration — destructor defined in CSService.cpp
 
+// ── Batching (opt-in) ────────────────────────────────────────────────────────
+// Calls for the listed actions are collected for up to `window` or `size`
+// messages and submitted together: to ocpp.parse() as a single statement, or
+// to the webhook as one JSON array.
+
+struct BatchConfig {
+    bool                            enabled = false;
+    std::chrono::milliseconds       window {10};
+    std::size_t                     size = 50;
+    ocpp::ActionSet                 actions = ocpp::make_action_set({
+        ocpp::Action::Heartbeat, ocpp::Action::MeterValues, ocpp::Action::StatusNotification});
+};
+
 // ── Webhook config ──────────────────────────────────────────────────────────
 
 struct WebhookConfig {
@@ -42,14 +72,62 @@ struct WebhookConfig {
     std::string username;
     std::string password;
     std::string token;
+
+    // Transport (see WebhookClient)
+    std::size_t connections = 16;
+    std::size_t pipeline = 1;
+    std::size_t queue = 10000;
+    int         timeout = 30;      // seconds
+
+    BatchConfig batch;
+
+    // Circuit breaker: while the webhook is unhealthy, `fallback` actions are
+    // answered locally and up to `deferred` of them are delivered later; the
+    // rest fail fast with a CallError
+    bool                          breaker = true;
+    ocpp::CircuitBreaker::Options breaker_options;
+    std::size_t                   deferred = 10000;
+    ocpp::ActionSet               fallback = ocpp::make_action_set({
+        ocpp::Action::Heartbeat, ocpp::Action::StatusNotification, ocpp::Action::MeterValues});
+};
+
+struct WebhookBatchItem {
+    std::string identity;
+    std::string unique_id;
+    std::string envelope;  // {"account":..,"action":..,"identity":..,"payload":..,"uniqueId":..}
+};
+
+#ifdef WITH_POSTGRESQL
+struct PgBatchItem {
+    std::string identity;
+    std::string unique_id;
+    std::string call;      // "ocpp.parse(...)" expression
+};
+
+// Connection state of a station awaiting flush_point_connected()
+struct PgConnectedState {
+    bool        connected = false;
+    std::string metadata;  // JSON
+};
+
+// Latest locally answered Heartbeat of a station, replayed by flush_heartbeats()
+struct PgHeartbeat {
+    std::string unique_id;
+    std::string version;
 };
 
+using PgHeartbeatRows = std::vector<std::pair<std::string, PgHeartbeat>>;  // identity, heartbeat
+#endif
+
 // ── PendingCall — correlates outbound CS→CP Call with deferred HTTP response ─
+// The REST caller is either a deferred HTTP connection on this worker or, for
+// commands forwarded by another worker, the router reply back to that worker.
 
 struct PendingCall {
     std::shared_ptr<HttpConnection> conn;     // deferred HTTP connection
+    WorkerRouter::Reply             forward;  // forwarded command (conn is null)
     std::string                     action;   // OCPP action name
-    std::chrono::steady_clock::time_point deadline;
+    std::chrono::milliseconds       timeout{0};
 };
 
 // ── CSService ───────────────────────────────────────────────────────────────
@@ -60,6 +138,11 @@ public:
     explicit CSService(Application& app);
     ~CSService() override;
 
+    // Master process: shared state of the workers, set up before they are
+    // forked and removed after they have exited
+    static void prepare_master(Application& app);
+    static void cleanup_master(Application& app);
+
     std::string_view name() const override { return "CSService"; }
     std::string_view title() const override { return "ocpp central system service"; }
     bool enabled() const override { return enabled_; }
@@ -79,10 +162,31 @@ private:
 
     void on_ws_upgrade(EventLoop& loop, WsConnection ws, const HttpRequest& req);
     void on_ws_message(ocpp::CSChargingPoint& point, const std::string& payload);
-    void on_ws_close(const std::string& identity);
+    void on_ws_close(ocpp::PointHandle handle);
+    void drop_connection(ocpp::CSChargingPoint& point);
 
     void send_json_response(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& response);
 
+    // ── WebSocket I/O (bounded outbound queue per connection) ───────────
+
+    struct WsOutbound {
+        ocpp::OutboundQueue queue;
+        bool                watching_write = false;   // EPOLLOUT registered
+        bool                io_update_armed = false;
+        bool                evicting = false;
+    };
+
+    void watch_station_io(int fd, ocpp::PointHandle handle, uint32_t events);
+    void watch_log_io(int fd, uint32_t events);
+    void set_log_filter(int fd, const std::string& text);
+    void close_log_subscriber(int fd);
+    ocpp::OutboundQueue::Options outbound_options(ocpp::OutboundQueue::Policy policy) const;
+    void ws_send(int fd, WsConnection& ws, std::string_view frame);
+    void on_ws_writable(int fd);
+    void update_io(int fd, WsOutbound& out);
+    void evict_slow_station(int fd);
+    bool send_default_response(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& request);
+
     // ── SOAP (OCPP 1.5) — WITH_POSTGRESQL only ──────────────────────────
 
 #ifdef WITH_POSTGRESQL
@@ -102,11 +206,31 @@ private:
     void do_charge_point(const HttpRequest& req, HttpResponse& resp,
                         const std::string& identity, const std::string& operation);
 
+    // Charge point command (CS→CP Call) shared by local and forwarded REST requests
+    struct ChargePointCommand {
+        ocpp::Action   action = ocpp::Action::Unknown;
+        nlohmann::json payload;
+    };
+
+    struct ApiError {
+        HttpStatus  status;
+        std::string message;
+    };
+
+    std::optional<ApiError> prepare_command(ocpp::CSChargingPoint& point,
+                                            const std::string& operation,
+                                            nlohmann::json body,
+                                            ChargePointCommand& cmd);
+    void send_command(ocpp::CSChargingPoint& point, ChargePointCommand cmd, PendingCall pending);
+    void on_forwarded_command(const std::string& identity, const std::string& operation,
+                              const std::string& body, WorkerRouter::Reply reply);
+
 #ifdef WITH_POSTGRESQL
     void do_central_system(const HttpRequest& req, HttpResponse& resp,
                           const std::string& endpoint);
     void set_point_connected(const std::string& identity, bool value,
                             const nlohmann::json& metadata);
+    void flush_point_connected();
 #endif
 
     // ── JSON dispatch (PG or webhook or standalone) ─────────────────────
@@ -114,6 +238,12 @@ private:
 #ifdef WITH_POSTGRESQL
     void parse_json_pg(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
                        const std::string& account = {});
+    void submit_parse_pg(std::string identity, std::string unique_id, std::string call);
+    void flush_parse_batch();
+    void reply_parse_pg(const std::string& identity, const std::string& unique_id,
+                        const char* json_str);
+    void flush_heartbeats();
+    void submit_heartbeats(std::shared_ptr<PgHeartbeatRows> rows);
 #endif
     void parse_json_webhook(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
                            const std::string& account = {});
@@ -125,6 +255,44 @@ private:
 
     void webhook_json(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
                      const std::string& account = {});
+    void post_webhook(std::string identity, std::string unique_id, std::string body);
+    void flush_webhook_batch();
+    void reply_webhook(const std::string& identity, const std::string& unique_id,
+                       const nlohmann::json& response);
+    void fail_webhook(const std::string& identity, const std::string& unique_id,
+                      std::string_view description);
+    void webhook_unavailable(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg,
+                             std::string envelope);
+    void record_webhook(bool healthy, std::chrono::steady_clock::time_point sent, std::size_t count);
+    void drain_webhook_deferred();
+
+    // ── Authorization cache ─────────────────────────────────────────────
+
+    // Authorize results are cached per token: a hit is answered at once and
+    // the call still goes to the backend; the backend's answer refreshes the
+    // cache and is not sent again. Every response to a station passes
+    // settle_authorize_call(), which returns true to suppress it.
+    void check_authorization_cache(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg);
+    bool settle_authorize_call(const std::string& identity, const ocpp::OcppMessage& response, bool learn);
+    std::size_t invalidate_authorization_cache(std::string_view token);
+    void do_authorization_cache(const HttpRequest& req, HttpResponse& resp);
+
+    // ── Traffic journal ─────────────────────────────────────────────────
+
+    // Every JSON frame to and from the stations, as received and as sent.
+    // POST /api/v1/Journal renders a time/identity range back to JSON.
+    void journal_append(const ocpp::TrafficJournal::Record& record);
+    void journal_outbound(const std::string& identity, std::string_view frame);
+    void do_journal(const HttpRequest& req, HttpResponse& resp);
+
+    // ── Admission control ───────────────────────────────────────────────
+
+    // Admitted BootNotifications count as in flight until their answer
+    // passes send_json_response() or the station disconnects.
+    bool admit_boot_notification(ocpp::CSChargingPoint& point, const ocpp::OcppMessage& msg);
+    void finish_boot_call(const std::string& identity, std::string_view unique_id);
+    std::size_t backend_queue_depth() const;
+    void log_admission();
 
     // ── Static file serving ────────────────────────────────────────────
 
@@ -132,25 +300,50 @@ private:
 
     // ── Utilities ───────────────────────────────────────────────────────
 
-    static void log_json_message(const std::string& identity, const ocpp::OcppMessage& msg);
+    // Traffic log record, if message logging is on and @p action is sampled
+    void log_message(const ocpp::LogEvent& event, ocpp::Action action);
+    void log_message_counters();
 
     nlohmann::json charge_point_to_json(const ocpp::CSChargingPoint& point) const;
     nlohmann::json get_charge_point_list() const;
 
     // Translate REST API payload to target OCPP version
-    static nlohmann::json translate_payload(const std::string& operation,
+    static nlohmann::json translate_payload(ocpp::Action action,
                                             const nlohmann::json& body,
                                             const std::string& target_version);
 
     // ── Pending call management ─────────────────────────────────────────
 
-    void cleanup_expired_calls();
+    // Pending calls expire from a one-shot timer armed for the earliest
+    // deadline; a station's calls fail as soon as it disconnects.
+    std::chrono::milliseconds command_timeout(ocpp::Action action) const;
+    void arm_pending_timer();
+    void expire_pending_calls();
+    void finish_pending_call(PendingCall& pending, HttpStatus status, std::string body, bool error);
 
     // ── Members ─────────────────────────────────────────────────────────
 
     Application&                    app_;
 #ifdef WITH_POSTGRESQL
     PgPool*                         pool_ {nullptr};
+    BatchConfig                     pg_batch_;
+    std::vector<PgBatchItem>        pg_batch_items_;
+    bool                            pg_batch_armed_ = false;
+    std::size_t                     pg_parse_in_flight_ = 0;  // messages awaiting ocpp.parse()
+
+    // Connection-state changes, coalesced per station for `window`
+    // (postgres.connection) and written in one statement
+    std::chrono::milliseconds                  pg_connected_window_ {250};
+    std::size_t                                pg_connected_size_ = 1000;
+    ocpp::CoalescingMap<PgConnectedState>      pg_connected_;
+    uint64_t                                   pg_connected_logged_ = 0;  // coalesced count last logged
+    bool                                       pg_connected_armed_ = false;
+
+    // Heartbeats answered locally (postgres.heartbeat.local); last-seen is
+    // written behind, one statement per `flush` interval
+    bool                            pg_heartbeat_local_ = false;
+    std::chrono::seconds            pg_heartbeat_flush_ {10};
+    ocpp::StringMap<PgHeartbeat>    pg_heartbeats_;
 #endif
     ocpp::CSChargingPointManager    point_manager_;
     WebhookConfig                   webhook_;
@@ -160,20 +353,70 @@ private:
     // WsConnection storage: fd -> WsConnection (moved here after upgrade)
     std::unordered_map<int, WsConnection> ws_connections_;
 
-    // Browser WebSocket log subscribers: fd -> WsConnection
-    std::unordered_map<int, WsConnection> log_subscribers_;
-    void broadcast_log(const nlohmann::json& entry);
+    // Outbound queues of stations and log subscribers, by fd
+    ocpp::OutboundQueue::Options            outbound_options_;
+    std::unordered_map<int, WsOutbound>     outbound_;
 
-    // Lazy-initialized FetchClient for webhook dispatch
+    // Browser WebSocket log subscribers, by fd, each with its own filter
+    struct LogSubscriber {
+        WsConnection    ws;
+        ocpp::LogFilter filter;
+    };
+    std::unordered_map<int, LogSubscriber> log_subscribers_;
+    std::string                            log_entry_;   // reused serialization buffer
+    void broadcast_log(const ocpp::LogEvent& event);
+
+    // Lazy-initialized FetchClient for SOAP forwarding
     std::unique_ptr<FetchClient> fetch_client_;
 
-    // Pending outbound calls: uniqueId -> PendingCall (deferred HTTP response)
-    std::unordered_map<std::string, PendingCall> pending_calls_;
+    // Lazy-initialized pooled webhook transport
+    std::unique_ptr<WebhookClient> webhook_client_;
+    std::vector<WebhookBatchItem>  webhook_batch_items_;
+    bool                           webhook_batch_armed_ = false;
+
+    // Webhook health; envelopes answered locally while it was open
+    ocpp::CircuitBreaker           webhook_breaker_;
+    std::deque<std::string>        webhook_deferred_;
+    std::size_t                    webhook_deferred_in_flight_ = 0;
+    bool                           webhook_draining_ = false;
+
+    // Reconnect-storm admission control (null when disabled); admitted
+    // BootNotifications awaiting the backend, by identity + '\x1f' + uniqueId
+    std::unique_ptr<ocpp::AdmissionController> admission_;
+    ocpp::StringSet                            boot_calls_;
+    ocpp::AdmissionController::Stats           admission_logged_;
+
+    // Binary traffic journal (null when disabled, or after a write error;
+    // the directory stays set for exports)
+    std::unique_ptr<ocpp::TrafficJournal> journal_;
+    std::string                           journal_dir_;
+
+    // OCPP traffic log (null when disabled)
+    std::unique_ptr<ocpp::MessageLog> message_log_;
+    uint64_t                          message_log_dropped_ = 0;
+
+    // Authorize results; calls awaiting the backend, by identity + '\x1f' + uniqueId
+    struct AuthorizeCall {
+        std::string key;
+        std::string token;
+        bool        answered = false;  // already answered from the cache
+    };
+    bool                               authorize_cache_enabled_ = false;
+    ocpp::AuthorizationCache           authorize_cache_;
+    ocpp::StringMap<AuthorizeCall>     authorize_calls_;
+
+    // Pending outbound calls (deferred HTTP responses), by uniqueId, station and deadline
+    ocpp::PendingCalls<PendingCall> pending_calls_;
+    std::optional<std::chrono::steady_clock::time_point> pending_timer_at_;
+
+    // Outbound command timeout per action (commands.timeout / commands.timeouts)
+    std::array<std::chrono::milliseconds, ocpp::kActionCount> command_timeouts_{};
+
+    // Multi-worker routing (null with a single worker)
+    std::unique_ptr<WorkerRouter> router_;
 
     // OCPP JSON schema validator
     ocpp::SchemaRegistry schema_registry_;
-
-    static constexpr std::chrono::seconds pending_call_timeout_{30};
 };
 
 } // namespace apostol
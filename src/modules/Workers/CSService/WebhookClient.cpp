@@ -0,0 +1,500 @@
+#include "WebhookClient.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace apostol
+{
+
+namespace
+{
+
+constexpr std::size_t kReadBuffer = 64 * 1024;
+
+// A connection's send buffer is released after a burst larger than this
+constexpr std::size_t kMaxIdleBuffer = 64 * 1024;
+
+} // namespace
+
+WebhookClient::WebhookClient(EventLoop& loop, Options options)
+    : loop_(loop)
+    , options_(std::move(options))
+{
+    auto url = ocpp::parse_http_url(options_.url);
+    if (!url)
+        throw std::invalid_argument(fmt::format("webhook url '{}' is not http:// or https://", options_.url));
+    url_ = std::move(*url);
+
+    options_.connections = std::max<std::size_t>(options_.connections, 1);
+    options_.pipeline    = std::max<std::size_t>(options_.pipeline, 1);
+
+    if (url_.tls) {
+        fetch_ = std::make_unique<FetchClient>(loop_);
+        fetch_headers_.emplace_back("Content-Type", "application/json");
+        if (!options_.authorization.empty())
+            fetch_headers_.emplace_back("Authorization", options_.authorization);
+        return;
+    }
+
+    prefix_ = fmt::format("POST {} HTTP/1.1\r\nHost: {}\r\nContent-Type: application/json\r\n",
+                          url_.target, url_.host_header);
+    if (!options_.authorization.empty())
+        prefix_ += fmt::format("Authorization: {}\r\n", options_.authorization);
+    prefix_ += "Content-Length: ";
+
+    buffer_.resize(kReadBuffer);
+}
+
+WebhookClient::Lookup::~Lookup()
+{
+    if (efd >= 0)
+        ::close(efd);
+}
+
+WebhookClient::~WebhookClient()
+{
+    // A lookup still running finishes on its own and releases its state
+    if (lookup_)
+        loop_.remove_io(lookup_->efd);
+
+    for (auto& conn : connections_) {
+        if (conn->events)
+            loop_.remove_io(conn->fd);
+        ::close(conn->fd);
+    }
+}
+
+void WebhookClient::post(std::string body, OnResponse on_response, OnError on_error)
+{
+    Request request{std::move(body), std::move(on_response), std::move(on_error),
+                    std::chrono::steady_clock::now() + options_.timeout};
+
+    if (queue_.size() >= options_.queue) {
+        fail(std::move(request), "webhook queue is full");
+    } else {
+        queue_.push_back(std::move(request));
+        if (fetch_)
+            dispatch_fetch();
+        else
+            dispatch();
+    }
+
+    run_finished();
+}
+
+void WebhookClient::expire(time_point now)
+{
+    // The queue is FIFO (retries go back to the front with older deadlines)
+    while (!queue_.empty() && queue_.front().deadline <= now) {
+        fail(std::move(queue_.front()), "webhook request timed out waiting for a connection");
+        queue_.pop_front();
+    }
+
+    // A connection whose oldest request is overdue is stuck: drop it with
+    // everything pipelined behind it
+    for (std::size_t i = 0; i < connections_.size();) {
+        auto& conn = *connections_[i];
+        if (!conn.in_flight.empty() && conn.in_flight.front().deadline <= now) {
+            close_connection(conn, "request timed out", false);
+            continue;
+        }
+        ++i;
+    }
+
+    if (!fetch_)
+        dispatch();
+    run_finished();
+}
+
+// ── Dispatch ────────────────────────────────────────────────────────────────
+
+void WebhookClient::dispatch()
+{
+    while (!queue_.empty()) {
+        Connection* conn = pick_connection();
+        if (!conn) {
+            if (connections_.empty() && !lookup_) {
+                // Nothing is connected and no connection can be opened
+                auto error = fmt::format("webhook {}:{}: cannot connect", url_.host, url_.port);
+                while (!queue_.empty()) {
+                    fail(std::move(queue_.front()), error);
+                    queue_.pop_front();
+                }
+            }
+            break;
+        }
+
+        auto& request = queue_.front();
+        request.offset = conn->out.size();
+        conn->out += prefix_;
+        fmt::format_to(std::back_inserter(conn->out), "{}\r\n\r\n", request.body.size());
+        conn->out += request.body;
+        conn->in_flight.push_back(std::move(request));
+        queue_.pop_front();
+
+        if (conn->connected && !flush(*conn))
+            continue;  // closed; its requests are back in the queue or failed
+        update_interest(*conn);
+    }
+}
+
+void WebhookClient::dispatch_fetch()
+{
+    while (!queue_.empty() && fetch_in_flight_ < options_.connections) {
+        auto request = std::make_shared<Request>(std::move(queue_.front()));
+        queue_.pop_front();
+        ++fetch_in_flight_;
+
+        fetch_->post(options_.url, request->body, fetch_headers_,
+            [this, request](FetchResponse response) {
+                --fetch_in_flight_;
+                finished_.push_back({std::move(*request), std::move(response), {}});
+                dispatch_fetch();
+                run_finished();
+            },
+            [this, request](std::string_view error) {
+                --fetch_in_flight_;
+                fail(std::move(*request), std::string(error));
+                dispatch_fetch();
+                run_finished();
+            });
+    }
+}
+
+// Idle connection first; otherwise a new one while under the cap; otherwise
+// the least loaded connection that still has pipeline room.
+WebhookClient::Connection* WebhookClient::pick_connection()
+{
+    Connection* best = nullptr;
+    for (auto& conn : connections_) {
+        const std::size_t depth = conn->pipelining ? options_.pipeline : 1;
+        if (conn->in_flight.size() >= depth)
+            continue;
+        if (!best || conn->in_flight.size() < best->in_flight.size())
+            best = conn.get();
+        if (best->in_flight.empty())
+            return best;
+    }
+
+    if (connections_.size() < options_.connections) {
+        if (auto* conn = open_connection())
+            return conn;
+    }
+    return best;
+}
+
+// ── Connections ─────────────────────────────────────────────────────────────
+
+// The address is resolved on the first connect and kept until a connect
+// fails, so the lookup does not run per request. getaddrinfo() blocks, so it
+// runs on a thread of its own; the queue waits for on_resolved().
+void WebhookClient::resolve()
+{
+    if (lookup_)
+        return;
+
+    auto lookup = std::make_shared<Lookup>();
+    lookup->efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (lookup->efd < 0) {
+        global_logger().error("webhook: eventfd: {}", std::strerror(errno));
+        return;
+    }
+
+    try {
+        std::thread([lookup, host = url_.host, port = std::to_string(url_.port)] {
+            addrinfo hints{};
+            hints.ai_family   = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+
+            addrinfo* result = nullptr;
+            const int rc = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+            {
+                std::lock_guard lock(lookup->mutex);
+                if (rc == 0 && result) {
+                    std::memcpy(&lookup->address, result->ai_addr, result->ai_addrlen);
+                    lookup->address_len = result->ai_addrlen;
+                } else {
+                    lookup->error = rc != 0 ? ::gai_strerror(rc) : "no address";
+                }
+            }
+            if (result)
+                ::freeaddrinfo(result);
+
+            const uint64_t one = 1;
+            [[maybe_unused]] auto n = ::write(lookup->efd, &one, sizeof(one));
+        }).detach();
+    } catch (const std::system_error& e) {
+        global_logger().error("webhook: cannot start host lookup: {}", e.what());
+        return;
+    }
+
+    lookup_ = std::move(lookup);
+    loop_.add_io(lookup_->efd, EPOLLIN, [this](uint32_t) { on_resolved(); });
+}
+
+void WebhookClient::on_resolved()
+{
+    auto lookup = std::move(lookup_);
+    loop_.remove_io(lookup->efd);
+
+    std::string error;
+    {
+        std::lock_guard lock(lookup->mutex);
+        address_     = lookup->address;
+        address_len_ = lookup->address_len;
+        error        = lookup->error;
+    }
+
+    if (address_len_ == 0) {
+        global_logger().error("webhook: cannot resolve '{}': {}", url_.host, error);
+        auto message = fmt::format("webhook {}: cannot resolve: {}", url_.host, error);
+        while (!queue_.empty()) {
+            fail(std::move(queue_.front()), message);
+            queue_.pop_front();
+        }
+    }
+
+    dispatch();
+    run_finished();
+}
+
+WebhookClient::Connection* WebhookClient::open_connection()
+{
+    if (address_len_ == 0) {
+        resolve();
+        return nullptr;
+    }
+
+    int fd = ::socket(address_.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        global_logger().error("webhook: socket: {}", std::strerror(errno));
+        return nullptr;
+    }
+
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address_), address_len_) != 0 &&
+        errno != EINPROGRESS) {
+        global_logger().error("webhook: connect to {}:{}: {}", url_.host, url_.port, std::strerror(errno));
+        ::close(fd);
+        address_len_ = 0;
+        return nullptr;
+    }
+
+    auto conn = std::make_unique<Connection>();
+    conn->fd = fd;
+    connections_.push_back(std::move(conn));
+
+    auto* raw = connections_.back().get();
+    update_interest(*raw);
+    return raw;
+}
+
+void WebhookClient::update_interest(Connection& conn)
+{
+    uint32_t events = EPOLLIN;
+    if (!conn.connected || conn.out_pos < conn.out.size())
+        events |= EPOLLOUT;
+    if (events == conn.events)
+        return;
+
+    if (conn.events)
+        loop_.remove_io(conn.fd);
+    conn.events = events;
+    loop_.add_io(conn.fd, events, [this, fd = conn.fd](uint32_t ev) { on_event(fd, ev); });
+}
+
+void WebhookClient::close_connection(Connection& conn, std::string_view reason, bool retry)
+{
+    if (conn.events)
+        loop_.remove_io(conn.fd);
+    ::close(conn.fd);
+
+    auto in_flight = std::move(conn.in_flight);
+
+    auto it = std::find_if(connections_.begin(), connections_.end(),
+                           [&](const auto& c) { return c.get() == &conn; });
+    connections_.erase(it);
+
+    // Only requests the server cannot have seen are sent again: a POST that
+    // was written may have been acted on even if its answer never came
+    std::vector<Request> again;
+    for (auto& request : in_flight) {
+        if (retry && !request.sent) {
+            again.push_back(std::move(request));
+        } else {
+            fail(std::move(request), fmt::format("webhook {}:{}: {}", url_.host, url_.port, reason));
+        }
+    }
+
+    for (auto r = again.rbegin(); r != again.rend(); ++r)
+        queue_.push_front(std::move(*r));
+}
+
+// ── I/O ─────────────────────────────────────────────────────────────────────
+
+void WebhookClient::on_event(int fd, uint32_t events)
+{
+    auto it = std::find_if(connections_.begin(), connections_.end(),
+                           [fd](const auto& c) { return c->fd == fd; });
+    if (it == connections_.end())
+        return;
+    Connection& conn = **it;
+
+    bool alive = true;
+
+    if (!conn.connected) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            address_len_ = 0;  // resolve again next time
+            close_connection(conn, std::strerror(err), false);
+            alive = false;
+        } else if (events & EPOLLOUT) {
+            conn.connected = true;
+        }
+    }
+
+    if (alive && conn.connected && (events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+        alive = read_responses(conn);
+    if (alive && conn.connected)
+        alive = flush(conn);
+    if (alive)
+        update_interest(conn);
+
+    dispatch();
+    run_finished();
+}
+
+bool WebhookClient::read_responses(Connection& conn)
+{
+    for (;;) {
+        ssize_t n = ::recv(conn.fd, buffer_.data(), buffer_.size(), 0);
+
+        if (n > 0) {
+            std::string_view data(buffer_.data(), static_cast<std::size_t>(n));
+            try {
+                while (!data.empty()) {
+                    data.remove_prefix(conn.parser.feed(data));
+                    if (conn.parser.complete() && !on_response(conn))
+                        return false;
+                }
+            } catch (const std::exception& e) {
+                close_connection(conn, e.what(), false);
+                return false;
+            }
+            continue;
+        }
+
+        if (n == 0) {
+            if (conn.parser.finish() && conn.parser.complete() && !on_response(conn))
+                return false;
+            close_connection(conn, "connection closed by server", true);
+            return false;
+        }
+
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return true;
+
+        close_connection(conn, std::strerror(errno), true);
+        return false;
+    }
+}
+
+bool WebhookClient::on_response(Connection& conn)
+{
+    auto response = conn.parser.take();
+
+    if (conn.in_flight.empty()) {
+        close_connection(conn, "unexpected response", false);
+        return false;
+    }
+
+    FetchResponse result;
+    result.status_code = response.status;
+    result.body        = std::move(response.body);
+
+    finished_.push_back({std::move(conn.in_flight.front()), std::move(result), {}});
+    conn.in_flight.pop_front();
+
+    if (!response.keep_alive) {
+        close_connection(conn, "connection closed by server", true);
+        return false;
+    }
+
+    if (response.http11 && options_.pipeline > 1)
+        conn.pipelining = true;
+    return true;
+}
+
+bool WebhookClient::flush(Connection& conn)
+{
+    while (conn.out_pos < conn.out.size()) {
+        ssize_t n = ::send(conn.fd, conn.out.data() + conn.out_pos, conn.out.size() - conn.out_pos,
+                           MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_pos += static_cast<std::size_t>(n);
+            for (auto r = conn.in_flight.rbegin(); r != conn.in_flight.rend() && !r->sent; ++r)
+                r->sent = r->offset < conn.out_pos;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+
+        close_connection(conn, std::strerror(errno), true);
+        return false;
+    }
+
+    conn.out.clear();
+    conn.out_pos = 0;
+    if (conn.out.capacity() > kMaxIdleBuffer)
+        conn.out.shrink_to_fit();
+    return true;
+}
+
+// ── Completion ──────────────────────────────────────────────────────────────
+
+void WebhookClient::fail(Request request, std::string error)
+{
+    finished_.push_back({std::move(request), {}, std::move(error)});
+}
+
+// Callbacks run after the connection state is settled, since they may post
+// further requests.
+void WebhookClient::run_finished()
+{
+    while (!finished_.empty()) {
+        auto batch = std::move(finished_);
+        finished_.clear();
+
+        for (auto& item : batch) {
+            if (!item.error.empty()) {
+                if (item.request.on_error)
+                    item.request.on_error(item.error);
+            } else if (item.request.on_response) {
+                item.request.on_response(std::move(item.response));
+            }
+        }
+    }
+}
+
+} // namespace apostol
@@ -0,0 +1,152 @@
+#pragma once
+//
+// WebhookClient — pooled keep-alive HTTP/1.1 transport for webhook dispatch.
+//
+// Requests are POSTed over at most `connections` persistent sockets to the
+// webhook host; the rest wait in a FIFO queue bounded by `queue` (beyond it a
+// request fails at once), so a burst of station messages never opens more
+// sockets than the cap. The request head, Authorization included, is rendered
+// once: a request is that prefix, a Content-Length and the body.
+//
+// With `pipeline` > 1, up to that many requests are written on a connection
+// ahead of their answers, once the server has shown it keeps HTTP/1.1
+// connections open. When a connection closes, requests none of whose bytes
+// reached the socket are sent again on another; a request already written
+// fails, since the server may have acted on it.
+//
+// The host name is looked up on a thread of its own (getaddrinfo blocks);
+// requests wait in the queue meanwhile, and fail if the lookup does.
+//
+// There is no TLS here: https:// URLs are posted through FetchClient, still
+// under the same concurrency cap and queue.
+//
+
+#include "apostol/application.hpp"
+#include "apostol/fetch_client.hpp"
+
+#include "ocpp/http_parser.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+
+namespace apostol
+{
+
+class WebhookClient
+{
+public:
+    struct Options {
+        std::string               url;
+        std::string               authorization;  // Authorization header value, or empty
+        std::size_t               connections = 16;
+        std::size_t               pipeline = 1;    // requests in flight per connection
+        std::size_t               queue = 10000;   // requests waiting for a connection
+        std::chrono::milliseconds timeout{30000};  // from post() to the answer
+    };
+
+    using OnResponse = std::function<void(FetchResponse)>;
+    using OnError    = std::function<void(std::string_view)>;
+
+    // Throws std::invalid_argument if the URL is not http:// or https://.
+    WebhookClient(EventLoop& loop, Options options);
+    ~WebhookClient();
+
+    WebhookClient(const WebhookClient&) = delete;
+    WebhookClient& operator=(const WebhookClient&) = delete;
+
+    void post(std::string body, OnResponse on_response, OnError on_error);
+
+    // Fail requests older than the timeout (called from the service timer).
+    void expire(std::chrono::steady_clock::time_point now);
+
+    std::size_t queued() const { return queue_.size(); }
+    std::size_t connections() const { return connections_.size(); }
+
+private:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    // A host lookup in progress, shared with its thread: the result comes
+    // back through `efd`, which lives as long as either side needs it
+    struct Lookup {
+        int              efd = -1;
+        std::mutex       mutex;
+        sockaddr_storage address{};
+        socklen_t        address_len = 0;
+        std::string      error;
+
+        ~Lookup();
+    };
+
+    struct Request {
+        std::string body;
+        OnResponse  on_response;
+        OnError     on_error;
+        time_point  deadline;
+        std::size_t offset = 0;     // start in the connection's `out`
+        bool        sent = false;   // some of it reached the socket
+    };
+
+    struct Connection {
+        int                      fd = -1;
+        bool                     connected = false;
+        bool                     pipelining = false;  // server keeps HTTP/1.1 connections open
+        uint32_t                 events = 0;          // registered epoll interest
+        std::string              out;
+        std::size_t              out_pos = 0;
+        std::deque<Request>      in_flight;
+        ocpp::HttpResponseParser parser;
+    };
+
+    // A request that is done, waiting for its callback to run
+    struct Finished {
+        Request       request;
+        FetchResponse response;
+        std::string   error;
+    };
+
+    void dispatch();
+    void dispatch_fetch();
+    Connection* pick_connection();
+    Connection* open_connection();
+    void resolve();
+    void on_resolved();
+
+    void on_event(int fd, uint32_t events);
+    bool read_responses(Connection& conn);
+    bool on_response(Connection& conn);
+    bool flush(Connection& conn);
+    void update_interest(Connection& conn);
+    void close_connection(Connection& conn, std::string_view reason, bool retry);
+    void fail(Request request, std::string error);
+    void run_finished();
+
+    EventLoop&              loop_;
+    Options                 options_;
+    ocpp::HttpUrl           url_;
+    std::string             prefix_;  // request line and headers up to "Content-Length: "
+
+    sockaddr_storage        address_{};
+    socklen_t               address_len_ = 0;
+    std::shared_ptr<Lookup> lookup_;  // while resolving
+
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::deque<Request>     queue_;
+    std::vector<Finished>   finished_;
+    std::vector<char>       buffer_;
+
+    // https:// fallback
+    std::unique_ptr<FetchClient> fetch_;
+    FetchClient::Headers         fetch_headers_;
+    std::size_t                  fetch_in_flight_ = 0;
+};
+
+} // namespace apostol
@@ -0,0 +1,327 @@
+#include "WorkerRouter.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace apostol
+{
+
+using json = nlohmann::json;
+
+namespace
+{
+
+constexpr int kSocketBuffer = 4 * 1024 * 1024;
+
+sockaddr_un make_address(const std::string& name, socklen_t& len)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    // Abstract namespace: leading NUL, no filesystem entry to clean up
+    auto n = std::min(name.size(), sizeof(addr.sun_path) - 1);
+    std::memcpy(addr.sun_path + 1, name.data(), n);
+    len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + n);
+    return addr;
+}
+
+// Parent of @p pid from /proc/<pid>/stat ("pid (comm) state ppid ..."), or 0
+pid_t parent_of(pid_t pid)
+{
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", static_cast<int>(pid));
+    std::FILE* f = std::fopen(path, "re");
+    if (!f)
+        return 0;
+
+    char line[512];
+    const bool ok = std::fgets(line, sizeof(line), f) != nullptr;
+    std::fclose(f);
+    if (!ok)
+        return 0;
+
+    // comm may contain spaces and parentheses; the state follows the last ')'
+    const char* p = std::strrchr(line, ')');
+    int ppid = 0;
+    if (!p || std::sscanf(p + 1, " %*c %d", &ppid) != 1)
+        return 0;
+    return static_cast<pid_t>(ppid);
+}
+
+} // namespace
+
+WorkerRouter::WorkerRouter(EventLoop& loop, std::string app_name)
+    : loop_(loop)
+    , app_name_(std::move(app_name))
+{
+}
+
+WorkerRouter::~WorkerRouter()
+{
+    if (fd_ >= 0) {
+        loop_.remove_io(fd_);
+        ::close(fd_);
+    }
+    if (directory_.is_open())
+        directory_.leave(self_);
+}
+
+std::string WorkerRouter::socket_name(std::string_view app_name, pid_t pid)
+{
+    return fmt::format("{}.{}", app_name, pid);
+}
+
+// One directory per master: all workers of this instance share it
+std::string WorkerRouter::directory_name(std::string_view app_name)
+{
+    return fmt::format("/{}.directory", app_name);
+}
+
+void WorkerRouter::create_directory(std::string_view app_name, std::size_t capacity)
+{
+    ocpp::WorkerDirectory::create(directory_name(app_name), capacity);
+}
+
+void WorkerRouter::remove_directory(std::string_view app_name)
+{
+    ocpp::WorkerDirectory::unlink(directory_name(app_name));
+}
+
+void WorkerRouter::start(std::size_t capacity, RequestHandler on_request)
+{
+    on_request_ = std::move(on_request);
+    self_ = ::getpid();
+    buffer_.resize(kSocketBuffer);
+
+    directory_.open(directory_name(app_name_), capacity, ::getppid());
+
+    fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0)
+        throw std::runtime_error(fmt::format("worker socket: {}", std::strerror(errno)));
+
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &kSocketBuffer, sizeof(kSocketBuffer));
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &kSocketBuffer, sizeof(kSocketBuffer));
+
+    // Every datagram carries the sender's kernel-verified pid and uid
+    const int on = 1;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_PASSCRED, &on, sizeof(on)) != 0) {
+        int err = errno;
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error(fmt::format("worker socket credentials: {}", std::strerror(err)));
+    }
+
+    socklen_t len = 0;
+    auto addr = make_address(socket_name(app_name_, self_), len);
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), len) != 0) {
+        int err = errno;
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error(fmt::format("worker socket bind: {}", std::strerror(err)));
+    }
+
+    loop_.add_io(fd_, EPOLLIN, [this](uint32_t) { on_readable(); });
+
+    if (!directory_.join(self_))
+        global_logger().warn("worker {}: worker table full, notices will not reach this worker", self_);
+}
+
+// ── Directory ───────────────────────────────────────────────────────────────
+
+void WorkerRouter::claim(std::string_view identity)
+{
+    if (!directory_.claim(identity, self_))
+        global_logger().warn("[{}] worker directory full or identity too long, "
+                             "REST commands will only work on this worker", identity);
+}
+
+void WorkerRouter::release(std::string_view identity)
+{
+    directory_.release(identity, self_);
+}
+
+pid_t WorkerRouter::remote_owner(std::string_view identity) const
+{
+    pid_t owner = directory_.owner(identity);
+    return owner == self_ ? 0 : owner;
+}
+
+// ── Forwarding ──────────────────────────────────────────────────────────────
+
+void WorkerRouter::forward(pid_t owner, const std::string& identity, const std::string& operation,
+                           const std::string& body, std::chrono::seconds timeout, Reply on_reply)
+{
+    uint64_t id = ++next_id_;
+
+    json request = {
+        {"t", "req"}, {"id", id},
+        {"identity", identity}, {"operation", operation}, {"body", body}
+    };
+
+    if (!send_to(owner, request.dump())) {
+        on_reply(HttpStatus::bad_gateway,
+                 fmt::format("Worker {} owning '{}' is unreachable", owner, identity), true);
+        return;
+    }
+
+    outstanding_.emplace(id, Outstanding{
+        .reply    = std::move(on_reply),
+        .deadline = std::chrono::steady_clock::now() + timeout
+    });
+}
+
+void WorkerRouter::broadcast(const std::string& operation, const std::string& body)
+{
+    if (fd_ < 0)
+        return;
+
+    json notice = {{"t", "note"}, {"operation", operation}, {"body", body}};
+    const auto datagram = notice.dump();
+
+    for (pid_t pid : directory_.workers()) {
+        if (pid != self_)
+            send_to(pid, datagram);
+    }
+}
+
+void WorkerRouter::expire(std::chrono::steady_clock::time_point now)
+{
+    for (auto it = outstanding_.begin(); it != outstanding_.end(); ) {
+        if (now >= it->second.deadline) {
+            auto reply = std::move(it->second.reply);
+            it = outstanding_.erase(it);
+            reply(HttpStatus::gateway_timeout, "Owning worker did not respond", true);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool WorkerRouter::send_to(pid_t pid, const std::string& datagram)
+{
+    socklen_t len = 0;
+    auto addr = make_address(socket_name(app_name_, pid), len);
+    auto n = ::sendto(fd_, datagram.data(), datagram.size(), MSG_NOSIGNAL,
+                      reinterpret_cast<sockaddr*>(&addr), len);
+    if (n < 0) {
+        global_logger().error("worker {} -> {}: send failed: {}", self_, pid, std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void WorkerRouter::reply_to(pid_t pid, uint64_t id, HttpStatus status, std::string body, bool error)
+{
+    json reply = {
+        {"t", "res"}, {"id", id}, {"status", static_cast<int>(status)},
+        {"error", error}, {"body", std::move(body)}
+    };
+    const auto datagram = reply.dump();
+    if (send_to(pid, datagram))
+        return;
+
+    // Too large for one datagram, or the caller's queue is full: a short
+    // error still ends the caller's wait instead of its timeout
+    json failed = {
+        {"t", "res"}, {"id", id}, {"status", static_cast<int>(HttpStatus::bad_gateway)},
+        {"error", true},
+        {"body", fmt::format("Worker {} could not pass back a reply of {} bytes", self_, datagram.size())}
+    };
+    send_to(pid, failed.dump());
+}
+
+void WorkerRouter::on_readable()
+{
+    for (;;) {
+        iovec iov{buffer_.data(), buffer_.size()};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(ucred))];
+        msghdr hdr{};
+        hdr.msg_iov        = &iov;
+        hdr.msg_iovlen     = 1;
+        hdr.msg_control    = control;
+        hdr.msg_controllen = sizeof(control);
+
+        auto n = ::recvmsg(fd_, &hdr, MSG_TRUNC);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                global_logger().error("worker {}: recv failed: {}", self_, std::strerror(errno));
+            return;
+        }
+        if (static_cast<std::size_t>(n) > buffer_.size()) {
+            global_logger().error("worker {}: dropped oversized datagram ({} bytes)", self_, n);
+            continue;
+        }
+
+        const ucred* cred = nullptr;
+        for (auto* c = CMSG_FIRSTHDR(&hdr); c; c = CMSG_NXTHDR(&hdr, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_CREDENTIALS &&
+                c->cmsg_len == CMSG_LEN(sizeof(ucred)))
+                cred = reinterpret_cast<const ucred*>(CMSG_DATA(c));
+        }
+        if (!cred || !is_sibling(cred->pid, cred->uid)) {
+            global_logger().warn("worker {}: rejected datagram from pid {} uid {}", self_,
+                                 cred ? cred->pid : 0, cred ? static_cast<long>(cred->uid) : -1L);
+            continue;
+        }
+
+        on_datagram(std::string_view(buffer_.data(), static_cast<std::size_t>(n)), cred->pid);
+    }
+}
+
+// Another worker of the same master, running as the same user
+bool WorkerRouter::is_sibling(pid_t pid, uid_t uid) const
+{
+    return pid > 0 && pid != self_ && uid == ::getuid() && parent_of(pid) == ::getppid();
+}
+
+void WorkerRouter::on_datagram(std::string_view data, pid_t sender)
+{
+    // A malformed datagram must not escape into the event loop
+    try {
+        const auto msg = json::parse(data);
+        if (!msg.is_object())
+            throw std::invalid_argument("not an object");
+
+        const auto type = msg.value("t", "");
+        const auto id = msg.value("id", uint64_t{0});
+
+        if (type == "res") {
+            auto it = outstanding_.find(id);
+            if (it == outstanding_.end()) return;   // already expired
+
+            auto reply = std::move(it->second.reply);
+            outstanding_.erase(it);
+            reply(static_cast<HttpStatus>(msg.value("status", 500)),
+                  msg.value("body", ""), msg.value("error", true));
+            return;
+        }
+
+        if (type == "note" && on_request_) {
+            on_request_({}, msg.value("operation", ""), msg.value("body", ""),
+                        [](HttpStatus, std::string, bool) {});
+            return;
+        }
+
+        if (type == "req" && on_request_) {
+            on_request_(msg.value("identity", ""), msg.value("operation", ""), msg.value("body", ""),
+                [this, sender, id](HttpStatus status, std::string body, bool error) {
+                    reply_to(sender, id, status, std::move(body), error);
+                });
+        }
+    } catch (const std::exception& e) {
+        global_logger().error("worker {}: invalid datagram from {}: {}", self_, sender, e.what());
+    }
+}
+
+} // namespace apostol
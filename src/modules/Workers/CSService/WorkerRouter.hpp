@@ -0,0 +1,115 @@
+#pragma once
+//
+// WorkerRouter — routes REST commands to the worker that owns a station.
+//
+// With more than one worker, a station's WebSocket lives in exactly one worker
+// process, but REST requests are accepted by any of them. The router keeps a
+// shared-memory identity -> worker directory (ocpp::WorkerDirectory) and gives
+// every worker an abstract unix datagram socket ("\0{app}.{pid}"). A request
+// for a station owned elsewhere is forwarded there; the owner runs it as a
+// normal charge point command and sends the result back the same way.
+//
+// Wire format (one JSON object per datagram):
+//   request:  {"t":"req","id":N,"identity":"...","operation":"...","body":"..."}
+//   reply:    {"t":"res","id":N,"status":200,"error":false,"body":"..."}
+//   notice:   {"t":"note","operation":"...","body":"..."}  (no reply)
+//
+// The socket is reachable by any local process, so the sender is taken from
+// the kernel (SCM_CREDENTIALS), never from the datagram: only sibling workers
+// (same uid, same master) are accepted, and replies go to the sender's pid.
+//
+
+#include "apostol/application.hpp"
+
+#include "ocpp/worker_directory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace apostol
+{
+
+class WorkerRouter
+{
+public:
+    // Result of a forwarded command: HTTP status, body, and whether the body
+    // is an error message (to be wrapped with reply_error) or a JSON document.
+    using Reply = std::function<void(HttpStatus status, std::string body, bool error)>;
+
+    // Invoked on the owning worker for a request forwarded by another worker.
+    using RequestHandler = std::function<void(const std::string& identity,
+                                              const std::string& operation,
+                                              const std::string& body,
+                                              Reply reply)>;
+
+    WorkerRouter(EventLoop& loop, std::string app_name);
+    ~WorkerRouter();
+
+    WorkerRouter(const WorkerRouter&) = delete;
+    WorkerRouter& operator=(const WorkerRouter&) = delete;
+
+    // Master process: create the directory before the workers are forked
+    // (throws std::runtime_error), remove it once they are gone.
+    static void create_directory(std::string_view app_name, std::size_t capacity);
+    static void remove_directory(std::string_view app_name);
+
+    // Map the directory and bind this worker's socket. Must run in the worker
+    // process (after fork). Throws std::runtime_error.
+    void start(std::size_t capacity, RequestHandler on_request);
+
+    // ── Directory ───────────────────────────────────────────────────────
+
+    void claim(std::string_view identity);
+    void release(std::string_view identity);
+
+    // Worker owning @p identity, or 0 if none or this worker.
+    pid_t remote_owner(std::string_view identity) const;
+
+    // ── Forwarding ──────────────────────────────────────────────────────
+
+    void forward(pid_t owner, const std::string& identity, const std::string& operation,
+                 const std::string& body, std::chrono::seconds timeout, Reply on_reply);
+
+    // Send a notice to every other live worker, whether or not it owns a
+    // station. It reaches the request handler with an empty identity; its
+    // reply is dropped.
+    void broadcast(const std::string& operation, const std::string& body);
+
+    // Fail forwarded requests whose owner never answered.
+    void expire(std::chrono::steady_clock::time_point now);
+
+private:
+    struct Outstanding {
+        Reply                                 reply;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void on_readable();
+    void on_datagram(std::string_view data, pid_t sender);
+    bool is_sibling(pid_t pid, uid_t uid) const;
+    bool send_to(pid_t pid, const std::string& datagram);
+    void reply_to(pid_t pid, uint64_t id, HttpStatus status, std::string body, bool error);
+
+    static std::string socket_name(std::string_view app_name, pid_t pid);
+    static std::string directory_name(std::string_view app_name);
+
+    EventLoop&            loop_;
+    std::string           app_name_;
+    pid_t                 self_ = 0;
+    int                   fd_ = -1;
+    ocpp::WorkerDirectory directory_;
+    RequestHandler        on_request_;
+    uint64_t              next_id_ = 0;
+    std::vector<char>     buffer_;
+
+    std::unordered_map<uint64_t, Outstanding> outstanding_;
+};
+
+} // namespace apostol
@@ -9,4 +9,17 @@ static inline void create_workers(Application& app)
     if (app.module_enabled("CSService"))
         app.module_manager().add_module(std::make_unique<CSService>(app));
 }
+
+// Master process, before the workers are forked and after they have exited
+static inline void prepare_workers(Application& app)
+{
+    if (app.module_enabled("CSService"))
+        CSService::prepare_master(app);
+}
+
+static inline void cleanup_workers(Application& app)
+{
+    if (app.module_enabled("CSService"))
+        CSService::cleanup_master(app);
+}
 } // namespace apostol
@@ -0,0 +1,212 @@
+#pragma once
+//
+// OCPP action names interned as a compact enum.
+//
+// Every action of OCPP 1.6 (incl. the security whitepaper extensions) and
+// OCPP 2.0.1 gets one Action value. action_from_string() maps a name to its
+// value through a perfect hash that is computed at compile time, so interning
+// an incoming action costs one hash and one string compare. Unknown names map
+// to Action::Unknown.
+//
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+namespace ocpp
+{
+
+// X(Name, in 1.6, in 2.0.1)
+#define OCPP_ACTIONS(X)                                     \
+    X(Authorize,                         true,  true)      \
+    X(BootNotification,                  true,  true)      \
+    X(CancelReservation,                 true,  true)      \
+    X(CertificateSigned,                 true,  true)      \
+    X(ChangeAvailability,                true,  true)      \
+    X(ChangeConfiguration,               true,  false)     \
+    X(ClearCache,                        true,  true)      \
+    X(ClearChargingProfile,              true,  true)      \
+    X(ClearDisplayMessage,               false, true)      \
+    X(ClearVariableMonitoring,           false, true)      \
+    X(ClearedChargingLimit,              false, true)      \
+    X(CostUpdated,                       false, true)      \
+    X(CustomerInformation,               false, true)      \
+    X(DataTransfer,                      true,  true)      \
+    X(DeleteCertificate,                 true,  true)      \
+    X(DiagnosticsStatusNotification,     true,  false)     \
+    X(ExtendedTriggerMessage,            true,  false)     \
+    X(FirmwareStatusNotification,        true,  true)      \
+    X(Get15118EVCertificate,             false, true)      \
+    X(GetBaseReport,                     false, true)      \
+    X(GetCertificateStatus,              false, true)      \
+    X(GetChargingProfiles,               false, true)      \
+    X(GetCompositeSchedule,              true,  true)      \
+    X(GetConfiguration,                  true,  false)     \
+    X(GetDiagnostics,                    true,  false)     \
+    X(GetDisplayMessages,                false, true)      \
+    X(GetInstalledCertificateIds,        true,  true)      \
+    X(GetLocalListVersion,               true,  true)      \
+    X(GetLog,                            true,  true)      \
+    X(GetMonitoringReport,               false, true)      \
+    X(GetReport,                         false, true)      \
+    X(GetTransactionStatus,              false, true)      \
+    X(GetVariables,                      false, true)      \
+    X(Heartbeat,                         true,  true)      \
+    X(InstallCertificate,                true,  true)      \
+    X(LogStatusNotification,             true,  true)      \
+    X(MeterValues,                       true,  true)      \
+    X(NotifyChargingLimit,               false, true)      \
+    X(NotifyCustomerInformation,         false, true)      \
+    X(NotifyDisplayMessages,             false, true)      \
+    X(NotifyEVChargingNeeds,             false, true)      \
+    X(NotifyEVChargingSchedule,          false, true)      \
+    X(NotifyEvent,                       false, true)      \
+    X(NotifyMonitoringReport,            false, true)      \
+    X(NotifyReport,                      false, true)      \
+    X(PublishFirmware,                   false, true)      \
+    X(PublishFirmwareStatusNotification, false, true)      \
+    X(RemoteStartTransaction,            true,  false)     \
+    X(RemoteStopTransaction,             true,  false)     \
+    X(ReportChargingProfiles,            false, true)      \
+    X(RequestStartTransaction,           false, true)      \
+    X(RequestStopTransaction,            false, true)      \
+    X(ReservationStatusUpdate,           false, true)      \
+    X(ReserveNow,                        true,  true)      \
+    X(Reset,                             true,  true)      \
+    X(SecurityEventNotification,         true,  true)      \
+    X(SendLocalList,                     true,  true)      \
+    X(SetChargingProfile,                true,  true)      \
+    X(SetDisplayMessage,                 false, true)      \
+    X(SetMonitoringBase,                 false, true)      \
+    X(SetMonitoringLevel,                false, true)      \
+    X(SetNetworkProfile,                 false, true)      \
+    X(SetVariableMonitoring,             false, true)      \
+    X(SetVariables,                      false, true)      \
+    X(SignCertificate,                   true,  true)      \
+    X(SignedFirmwareStatusNotification,  true,  false)     \
+    X(SignedUpdateFirmware,              true,  false)     \
+    X(StartTransaction,                  true,  false)     \
+    X(StatusNotification,                true,  true)      \
+    X(StopTransaction,                   true,  false)     \
+    X(TransactionEvent,                  false, true)      \
+    X(TriggerMessage,                    true,  true)      \
+    X(UnlockConnector,                   true,  true)      \
+    X(UnpublishFirmware,                 false, true)      \
+    X(UpdateFirmware,                    true,  true)
+
+enum class Action : uint8_t {
+    Unknown = 0,
+#define OCPP_ACTION_ENUM(name, v16, v201) name,
+    OCPP_ACTIONS(OCPP_ACTION_ENUM)
+#undef OCPP_ACTION_ENUM
+};
+
+namespace detail
+{
+
+struct ActionInfo {
+    std::string_view name;
+    bool             v16;
+    bool             v201;
+};
+
+inline constexpr std::array kActionInfo = {
+    ActionInfo{"", false, false},
+#define OCPP_ACTION_INFO(name, v16, v201) ActionInfo{#name, v16, v201},
+    OCPP_ACTIONS(OCPP_ACTION_INFO)
+#undef OCPP_ACTION_INFO
+};
+
+// ── Compile-time perfect hash ───────────────────────────────────────────────
+// FNV-1a with a seed, folded to kActionTableBits. The first seed under which
+// all names land in distinct buckets is found by the compiler.
+
+inline constexpr unsigned kActionTableBits = 10;
+inline constexpr std::size_t kActionTableSize = std::size_t{1} << kActionTableBits;
+
+constexpr uint32_t action_hash(std::string_view s, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return (h ^ (h >> kActionTableBits)) & (kActionTableSize - 1);
+}
+
+constexpr bool action_seed_is_perfect(uint32_t seed)
+{
+    std::array<bool, kActionTableSize> used{};
+    for (std::size_t i = 1; i < kActionInfo.size(); ++i) {
+        auto slot = action_hash(kActionInfo[i].name, seed);
+        if (used[slot])
+            return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t find_action_seed()
+{
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        if (action_seed_is_perfect(seed))
+            return seed;
+    }
+    return UINT32_MAX;
+}
+
+inline constexpr uint32_t kActionSeed = find_action_seed();
+static_assert(kActionSeed != UINT32_MAX, "no perfect hash seed for the OCPP action set");
+
+constexpr std::array<Action, kActionTableSize> make_action_table()
+{
+    std::array<Action, kActionTableSize> table{};
+    for (std::size_t i = 1; i < kActionInfo.size(); ++i)
+        table[action_hash(kActionInfo[i].name, kActionSeed)] = static_cast<Action>(i);
+    return table;
+}
+
+inline constexpr auto kActionTable = make_action_table();
+
+} // namespace detail
+
+inline constexpr std::size_t kActionCount = detail::kActionInfo.size();
+
+constexpr std::size_t action_index(Action action) { return static_cast<std::size_t>(action); }
+
+/// Action name ("" for Action::Unknown).
+constexpr std::string_view action_name(Action action)
+{
+    auto i = action_index(action);
+    return i < kActionCount ? detail::kActionInfo[i].name : std::string_view{};
+}
+
+/// Intern an action name; Action::Unknown if it is not an OCPP 1.6/2.0.1 action.
+constexpr Action action_from_string(std::string_view name)
+{
+    Action action = detail::kActionTable[detail::action_hash(name, detail::kActionSeed)];
+    return detail::kActionInfo[action_index(action)].name == name ? action : Action::Unknown;
+}
+
+/// Set of actions, indexed by action_index().
+using ActionSet = std::bitset<kActionCount>;
+
+inline ActionSet make_action_set(std::initializer_list<Action> actions)
+{
+    ActionSet set;
+    for (auto action : actions)
+        set.set(action_index(action));
+    return set;
+}
+
+/// Whether @p action is defined by the given OCPP version ("1.6" or "2.0.1").
+constexpr bool action_in_version(Action action, std::string_view version)
+{
+    const auto& info = detail::kActionInfo[action_index(action)];
+    return version == "2.0.1" ? info.v201 : info.v16;
+}
+
+} // namespace ocpp
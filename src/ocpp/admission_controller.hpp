@@ -0,0 +1,120 @@
+#pragma once
+//
+// AdmissionController — keeps a reconnect storm from flooding the backend.
+//
+// Upgrades:          a token bucket (`upgrade_rate` per second, `upgrade_burst`
+//                    deep) decides whether a WebSocket upgrade is accepted.
+// BootNotifications: at most `boot_in_flight` are with the backend at once,
+//                    and none are passed on while the backend queue is deeper
+//                    than `queue_threshold`. A refused boot is answered
+//                    Pending with a random interval in [pending_min,
+//                    pending_max], so stations spread out their retries as
+//                    OCPP intends.
+//
+// Every boot admitted by admit_boot() must be ended by boot_finished().
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace ocpp
+{
+
+class AdmissionController
+{
+public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+
+    struct Options {
+        double               upgrade_rate = 200.0;   // upgrades per second
+        std::size_t          upgrade_burst = 400;
+        std::size_t          boot_in_flight = 100;
+        std::size_t          queue_threshold = 1000; // backend messages waiting
+        std::chrono::seconds pending_min{30};
+        std::chrono::seconds pending_max{300};
+    };
+
+    struct Stats {
+        uint64_t upgrades_admitted = 0;
+        uint64_t upgrades_rejected = 0;
+        uint64_t boots_admitted = 0;
+        uint64_t boots_pending = 0;
+    };
+
+    AdmissionController() : AdmissionController(Options{}) {}
+    explicit AdmissionController(Options options, uint32_t seed = std::random_device{}())
+        : options_(options)
+        , tokens_(static_cast<double>(options.upgrade_burst))
+        , rng_(seed)
+    {
+        if (options_.pending_max < options_.pending_min)
+            options_.pending_max = options_.pending_min;
+    }
+
+    /// May a station upgrade to WebSocket now?
+    bool admit_upgrade(time_point now)
+    {
+        if (!started_) {
+            started_  = true;
+            refilled_ = now;
+        } else if (now > refilled_) {
+            const std::chrono::duration<double> elapsed = now - refilled_;
+            tokens_ = std::min(static_cast<double>(options_.upgrade_burst),
+                               tokens_ + elapsed.count() * options_.upgrade_rate);
+            refilled_ = now;
+        }
+
+        if (tokens_ < 1.0) {
+            ++stats_.upgrades_rejected;
+            return false;
+        }
+        tokens_ -= 1.0;
+        ++stats_.upgrades_admitted;
+        return true;
+    }
+
+    /// May a BootNotification go to the backend, given @p queue_depth
+    /// messages already waiting there? If not, answer it with Pending and
+    /// pending_interval().
+    bool admit_boot(std::size_t queue_depth)
+    {
+        if (in_flight_ >= options_.boot_in_flight || queue_depth >= options_.queue_threshold) {
+            ++stats_.boots_pending;
+            return false;
+        }
+        ++in_flight_;
+        ++stats_.boots_admitted;
+        return true;
+    }
+
+    void boot_finished()
+    {
+        if (in_flight_ > 0) --in_flight_;
+    }
+
+    /// Retry interval for a Pending answer, uniform in [pending_min, pending_max].
+    std::chrono::seconds pending_interval()
+    {
+        std::uniform_int_distribution<int64_t> dist(options_.pending_min.count(),
+                                                    options_.pending_max.count());
+        return std::chrono::seconds(dist(rng_));
+    }
+
+    std::size_t boots_in_flight() const { return in_flight_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    Options      options_;
+    double       tokens_;
+    time_point   refilled_{};
+    bool         started_ = false;
+    std::size_t  in_flight_ = 0;
+    Stats        stats_;
+    std::mt19937 rng_;
+};
+
+} // namespace ocpp
@@ -0,0 +1,88 @@
+#include "ocpp/authorization_cache.hpp"
+#include "ocpp/time_utils.hpp"
+
+namespace ocpp
+{
+
+std::string AuthorizationCache::make_key(std::string_view version, std::string_view account,
+                                         std::string_view token)
+{
+    std::string key;
+    key.reserve(version.size() + account.size() + token.size() + 2);
+    key.append(version).append(1, '\x1f').append(account).append(1, '\x1f').append(token);
+    return key;
+}
+
+const nlohmann::json* AuthorizationCache::find(std::string_view key, time_point now)
+{
+    auto it = index_.find(key);
+    if (it == index_.end())
+        return nullptr;
+
+    if (it->second->expires <= now) {
+        erase(it->second);
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &entries_.front().info;
+}
+
+void AuthorizationCache::store(std::string key, std::string_view token, const nlohmann::json& info,
+                               time_point now)
+{
+    if (auto it = index_.find(key); it != index_.end())
+        erase(it->second);
+
+    if (options_.capacity == 0 || !info.is_object() || info.value("status", "") != "Accepted")
+        return;
+
+    auto expires = now + options_.ttl;
+    for (const char* field : {"expiryDate", "cacheExpiryDateTime"}) {
+        auto date = info.find(field);
+        if (date == info.end())
+            continue;
+        // An expiry we cannot read must not fall back to the TTL
+        auto at = date->is_string() ? parse_rfc3339(date->get_ref<const std::string&>()) : std::nullopt;
+        if (!at)
+            return;
+        if (*at < expires)
+            expires = *at;
+    }
+    if (expires <= now)
+        return;
+
+    if (index_.size() >= options_.capacity)
+        erase(std::prev(entries_.end()));
+
+    entries_.push_front(Entry{std::move(key), std::string(token), info, expires});
+    index_.emplace(entries_.front().key, entries_.begin());
+}
+
+std::size_t AuthorizationCache::invalidate(std::string_view token)
+{
+    std::size_t count = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto next = std::next(it);
+        if (it->token == token) {
+            erase(it);
+            ++count;
+        }
+        it = next;
+    }
+    return count;
+}
+
+void AuthorizationCache::clear()
+{
+    index_.clear();
+    entries_.clear();
+}
+
+void AuthorizationCache::erase(List::iterator it)
+{
+    index_.erase(it->key);
+    entries_.erase(it);
+}
+
+} // namespace ocpp
@@ -0,0 +1,76 @@
+#pragma once
+//
+// AuthorizationCache — idTag -> idTagInfo (1.6) / idToken -> idTokenInfo
+// (2.0.1) results from the backend, so a card presented again is answered
+// without a round trip.
+//
+// Only "Accepted" results are kept; any other result for the same key
+// removes the entry. An entry lives for the configured TTL, cut short by the
+// info's own expiryDate (1.6) or cacheExpiryDateTime (2.0.1); an info whose
+// date does not parse is not cached. The least recently used entry is
+// evicted when the cache is full.
+//
+
+#include "ocpp/string_map.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+
+namespace ocpp
+{
+
+class AuthorizationCache
+{
+public:
+    using clock      = std::chrono::system_clock;  // expiry dates are wall-clock
+    using time_point = clock::time_point;
+
+    struct Options {
+        std::size_t          capacity = 10000;
+        std::chrono::seconds ttl{300};
+    };
+
+    AuthorizationCache() = default;
+    explicit AuthorizationCache(Options options) : options_(options) {}
+
+    /// Cache key: the token scoped by OCPP version and account, so the same
+    /// card may be answered differently per tenant.
+    static std::string make_key(std::string_view version, std::string_view account, std::string_view token);
+
+    /// Cached info for @p key, or nullptr if absent or expired. A hit becomes
+    /// the most recently used entry.
+    const nlohmann::json* find(std::string_view key, time_point now);
+
+    /// Remember the backend's @p info for @p key (see class comment).
+    void store(std::string key, std::string_view token, const nlohmann::json& info, time_point now);
+
+    /// Drop every entry for @p token (all versions and accounts). Returns the count.
+    std::size_t invalidate(std::string_view token);
+
+    void clear();
+
+    std::size_t size() const { return index_.size(); }
+
+private:
+    struct Entry {
+        std::string    key;
+        std::string    token;
+        nlohmann::json info;
+        time_point     expires;
+    };
+
+    using List = std::list<Entry>;
+
+    void erase(List::iterator it);
+
+    Options              options_;
+    List                 entries_;  // most recently used first
+    StringMap<List::iterator> index_;
+};
+
+} // namespace ocpp
@@ -1,4 +1,5 @@
 #include "ocpp/charging_point.hpp"
+#include "ocpp/response_template.hpp"
 #include "ocpp/time_utils.hpp"
 #include "apostol/websocket.hpp"
 #include <fmt/format.h>
@@ -14,6 +15,86 @@ namespace
 {
 std::atomic<uint32_t> s_transaction_id{0};
 constexpr int kDefaultExpirySec = 5 * 60; // 5 min default for idTagInfo/reservation expiry
+constexpr std::size_t kMaxRetainedSendBuffer = 64 * 1024; // don't keep one huge frame's buffer alive
+
+// Default replies of standalone mode, rendered once
+struct DefaultResponses {
+    using Slot = ResponseTemplate::Slot;
+    using json = nlohmann::json;
+
+    static json id_tag_info()
+    {
+        return {{"status", "Accepted"}, {"expiryDate", ResponseTemplate::placeholder(Slot::ExpiryDate)}};
+    }
+
+    ResponseTemplate empty{json::object()};
+    ResponseTemplate accepted{json{{"status", "Accepted"}}};
+    ResponseTemplate heartbeat{json{{"currentTime", ResponseTemplate::placeholder(Slot::CurrentTime)}}};
+    ResponseTemplate boot_notification{json{
+        {"status", "Accepted"},
+        {"currentTime", ResponseTemplate::placeholder(Slot::CurrentTime)},
+        {"interval", 60}
+    }};
+
+    // 1.6
+    ResponseTemplate id_tag_accepted{json{{"idTagInfo", id_tag_info()}}};
+    ResponseTemplate start_transaction{json{
+        {"idTagInfo", id_tag_info()},
+        {"transactionId", ResponseTemplate::placeholder(Slot::TransactionId)}
+    }};
+
+    // 2.0.1
+    ResponseTemplate id_token_accepted{json{{"idTokenInfo", {{"status", "Accepted"}}}}};
+};
+
+const DefaultResponses& default_responses()
+{
+    static const DefaultResponses responses;
+    return responses;
+}
+
+const ResponseTemplate* default_response_16(const OcppMessage& request)
+{
+    const auto& r = default_responses();
+
+    switch (request.action_id) {
+    case Action::Authorize:          return &r.id_tag_accepted;
+    case Action::BootNotification:   return &r.boot_notification;
+    case Action::StartTransaction:   return &r.start_transaction;
+    case Action::StopTransaction:    return &r.id_tag_accepted;
+    case Action::Heartbeat:          return &r.heartbeat;
+    case Action::StatusNotification: return &r.empty;
+    case Action::DataTransfer:       return &r.accepted;
+    case Action::MeterValues:        return &r.empty;
+    default:                         return nullptr;
+    }
+}
+
+const ResponseTemplate* default_response_201(const OcppMessage& request)
+{
+    const auto& r = default_responses();
+
+    switch (request.action_id) {
+    case Action::BootNotification: return &r.boot_notification;
+    case Action::Heartbeat:        return &r.heartbeat;
+    case Action::Authorize:        return &r.id_token_accepted;
+    case Action::DataTransfer:     return &r.accepted;
+
+    case Action::TransactionEvent:
+        // Minimal response — include idTokenInfo for Started events
+        return request.payload.value("eventType", "") == "Started" ? &r.id_token_accepted : &r.empty;
+
+    case Action::NotifyReport:
+    case Action::StatusNotification:   // empty per spec
+    case Action::MeterValues:
+    case Action::FirmwareStatusNotification:
+        return &r.empty;
+
+    default:
+        return nullptr;
+    }
+}
+
 } // namespace
 
 // ── CSChargingPoint ─────────────────────────────────────────────────────────
@@ -25,9 +106,28 @@ CSChargingPoint::CSChargingPoint(std::string identity)
 
 void CSChargingPoint::send_json(const OcppMessage& msg)
 {
-    if (ws_conn_) {
-        ws_conn_->send_text(serialize_ocpp_json(msg));
-    }
+    if (!ws_conn_)
+        return;
+
+    auto& buffer = reset_send_buffer();
+    append_ocpp_json(buffer, msg);
+    send_frame(buffer);
+}
+
+void CSChargingPoint::send_frame(std::string_view frame)
+{
+    if (frame_sink_)
+        frame_sink_(frame);
+    else
+        ws_conn_->send_text(frame);
+}
+
+std::string& CSChargingPoint::reset_send_buffer()
+{
+    if (send_buffer_.capacity() > kMaxRetainedSendBuffer)
+        std::string().swap(send_buffer_);
+    send_buffer_.clear();
+    return send_buffer_;
 }
 
 void CSChargingPoint::send_call_error(std::string_view unique_id, std::string_view code, std::string_view desc)
@@ -37,117 +137,133 @@ void CSChargingPoint::send_call_error(std::string_view unique_id, std::string_vi
 
 nlohmann::json& CSChargingPoint::last_request(std::string_view action)
 {
-    return last_requests_[std::string(action)];
+    auto it = last_requests_.find(action);
+    if (it == last_requests_.end())
+        it = last_requests_.emplace(std::string(action), nlohmann::json{}).first;
+    return it->second;
 }
 
 const nlohmann::json& CSChargingPoint::last_request(std::string_view action) const
 {
     static const nlohmann::json empty = nlohmann::json::object();
-    auto it = last_requests_.find(std::string(action));
+    auto it = last_requests_.find(action);
     return it != last_requests_.end() ? it->second : empty;
 }
 
 void CSChargingPoint::store_request(std::string_view action, nlohmann::json payload)
 {
-    last_requests_[std::string(action)] = std::move(payload);
+    last_request(action) = std::move(payload);
 }
 
-// ── Default response handlers (standalone / webhook mode) ───────────────────
+// ── Default responses (standalone / webhook fallback) ───────────────────────
 
-OcppMessage CSChargingPoint::default_authorize_response(const OcppMessage& request)
+std::string_view CSChargingPoint::send_default_response(const OcppMessage& request)
 {
-    return make_call_result(request.unique_id, {
-        {"idTagInfo", {
-            {"status", "Accepted"},
-            {"expiryDate", iso_time_now(kDefaultExpirySec)}
-        }}
-    });
-}
+    using Slot = ResponseTemplate::Slot;
 
-OcppMessage CSChargingPoint::default_boot_notification_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, {
-        {"status", "Accepted"},
-        {"currentTime", iso_time_now()},
-        {"interval", 60}
-    });
-}
+    const auto* tmpl = version_ == OcppVersion::V201 ? default_response_201(request)
+                                                     : default_response_16(request);
+    if (!tmpl)
+        return {};
 
-OcppMessage CSChargingPoint::default_start_transaction_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, {
-        {"idTagInfo", {
-            {"status", "Accepted"},
-            {"expiryDate", iso_time_now(kDefaultExpirySec)}
-        }},
-        {"transactionId", ++s_transaction_id}
-    });
-}
+    IsoTimeBuffer current_time;
+    IsoTimeBuffer expiry_date;
+    ResponseTemplate::Values values;
 
-OcppMessage CSChargingPoint::default_stop_transaction_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, {
-        {"idTagInfo", {
-            {"status", "Accepted"},
-            {"expiryDate", iso_time_now(kDefaultExpirySec)}
-        }}
-    });
-}
+    if (tmpl->uses(Slot::CurrentTime))
+        values.current_time = iso_time_now(current_time);
+    if (tmpl->uses(Slot::ExpiryDate))
+        values.expiry_date = iso_time_now(expiry_date, kDefaultExpirySec);
+    if (tmpl->uses(Slot::TransactionId))
+        values.transaction_id = ++s_transaction_id;
 
-OcppMessage CSChargingPoint::default_heartbeat_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, {
-        {"currentTime", iso_time_now()}
-    });
-}
-
-OcppMessage CSChargingPoint::default_status_notification_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, nlohmann::json::object());
-}
+    auto& buffer = reset_send_buffer();
+    tmpl->render(buffer, request.unique_id, values);
 
-OcppMessage CSChargingPoint::default_data_transfer_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, {
-        {"status", "Accepted"}
-    });
-}
+    if (ws_conn_)
+        send_frame(buffer);
 
-OcppMessage CSChargingPoint::default_meter_values_response(const OcppMessage& request)
-{
-    return make_call_result(request.unique_id, nlohmann::json::object());
+    return buffer;
 }
 
 // ── CSChargingPointManager ──────────────────────────────────────────────────
 
 CSChargingPoint& CSChargingPointManager::get_or_create(const std::string& identity)
 {
-    auto it = points_.find(identity);
-    if (it != points_.end())
-        return *it->second;
+    auto it = by_identity_.find(identity);
+    if (it != by_identity_.end())
+        return *slot_at(it->second).point;
 
-    auto [inserted, ok] = points_.emplace(identity, std::make_unique<CSChargingPoint>(identity));
-    return *inserted->second;
+    uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        if (slot_count_ == chunks_.size() * kChunkSize)
+            chunks_.push_back(std::make_unique<Slot[]>(kChunkSize));
+        index = static_cast<uint32_t>(slot_count_++);
+    }
+
+    Slot& slot = slot_at(index);
+    auto& point = slot.point.emplace(identity);
+    point.handle_ = PointHandle{index, slot.generation};
+
+    by_identity_.emplace(identity, index);
+    return point;
+}
+
+CSChargingPoint* CSChargingPointManager::get(PointHandle handle) const
+{
+    if (!handle || handle.index >= slot_count_)
+        return nullptr;
+
+    Slot& slot = slot_at(handle.index);
+    if (slot.generation != handle.generation || !slot.point)
+        return nullptr;
+
+    return &*slot.point;
 }
 
 CSChargingPoint* CSChargingPointManager::find_by_identity(std::string_view identity) const
 {
-    auto it = points_.find(std::string(identity));
-    return it != points_.end() ? it->second.get() : nullptr;
+    auto it = by_identity_.find(identity);
+    return it != by_identity_.end() ? &*slot_at(it->second).point : nullptr;
 }
 
 CSChargingPoint* CSChargingPointManager::find_by_connection(const apostol::WsConnection* conn) const
 {
-    for (const auto& [id, pt] : points_) {
-        if (pt->ws_connection() == conn)
-            return pt.get();
-    }
-    return nullptr;
+    auto it = by_connection_.find(conn);
+    return it != by_connection_.end() ? &*slot_at(it->second).point : nullptr;
+}
+
+void CSChargingPointManager::bind_connection(CSChargingPoint& point, apostol::WsConnection* conn)
+{
+    if (point.ws_conn_)
+        by_connection_.erase(point.ws_conn_);
+
+    point.ws_conn_ = conn;
+
+    if (conn)
+        by_connection_[conn] = point.handle_.index;
 }
 
 bool CSChargingPointManager::remove(const std::string& identity)
 {
-    return points_.erase(identity) > 0;
+    auto it = by_identity_.find(identity);
+    if (it == by_identity_.end())
+        return false;
+
+    uint32_t index = it->second;
+    by_identity_.erase(it);
+
+    Slot& slot = slot_at(index);
+    if (slot.point->ws_conn_)
+        by_connection_.erase(slot.point->ws_conn_);
+
+    slot.point.reset();
+    ++slot.generation;
+    free_.push_back(index);
+    return true;
 }
 
 } // namespace ocpp
@@ -8,17 +8,34 @@
 //
 
 #include "ocpp/protocol.hpp"
+#include "ocpp/string_map.hpp"
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <memory>
+#include <optional>
+#include <vector>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 
 namespace apostol { class WsConnection; }
 
 namespace ocpp
 {
 
+// ── PointHandle ─────────────────────────────────────────────────────────────
+// Stable reference to a CSChargingPoint slot in CSChargingPointManager.
+// A handle to a removed point resolves to nullptr, even if its slot is reused.
+
+struct PointHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    explicit operator bool() const { return index != UINT32_MAX; }
+    bool operator==(const PointHandle&) const = default;
+};
+
 // ── CSChargingPoint ─────────────────────────────────────────────────────────
 // Represents a single charging station connected to this Central System.
 // One instance per station identity (e.g. "STRK-ION-001").
@@ -37,12 +54,22 @@ public:
     // ── Identity & addressing ───────────────────────────────────────────
 
     const std::string& identity() const { return identity_; }
+    PointHandle handle() const { return handle_; }
 
     const std::string& address() const { return address_; }
     void set_address(std::string addr) { address_ = std::move(addr); }
 
+    // Tenant from /ocpp/{account}/{identity}; empty for /ocpp/{identity}
+    const std::string& account() const { return account_; }
+    void set_account(std::string account) { account_ = std::move(account); }
+
     const std::string& ocpp_version() const { return ocpp_version_; }
-    void set_ocpp_version(std::string version) { ocpp_version_ = std::move(version); }
+    OcppVersion version() const { return version_; }
+    void set_ocpp_version(std::string version)
+    {
+        version_ = ocpp_version_from_string(version);
+        ocpp_version_ = std::move(version);
+    }
 
     // ── Connection state ────────────────────────────────────────────────
 
@@ -51,14 +78,30 @@ public:
 
     bool connected() const { return ws_conn_ != nullptr; }
 
+    // Set through CSChargingPointManager::bind_connection() so the
+    // connection index stays in sync.
     apostol::WsConnection* ws_connection() const { return ws_conn_; }
-    void set_ws_connection(apostol::WsConnection* conn) { ws_conn_ = conn; }
 
     // ── Send OCPP JSON message over WebSocket ───────────────────────────
+    // The frame is serialized into a per-point buffer that is reused for
+    // every message, so steady-state sends do not allocate.
 
     void send_json(const OcppMessage& msg);
     void send_call_error(std::string_view unique_id, std::string_view code, std::string_view desc);
 
+    // Frames go to the sink when one is set (e.g. a bounded outbound queue),
+    // otherwise straight to the WebSocket. Nothing is sent while disconnected.
+    using FrameSink = std::function<void(std::string_view frame)>;
+    void set_frame_sink(FrameSink sink) { frame_sink_ = std::move(sink); }
+
+    // ── Standalone (no backend) default responses ───────────────────────
+    // Reply to @p request with the default "Accepted" CallResult for this
+    // point's OCPP version. The replies are pre-rendered ResponseTemplates,
+    // so no DOM is built. Returns the frame that was sent (valid until the
+    // next send), or an empty view if the action has no default response.
+
+    std::string_view send_default_response(const OcppMessage& request);
+
     // ── Last request data (populated during message parsing) ────────────
     // Stored as raw JSON for flexibility — CSService or PG dispatch can use them.
 
@@ -77,29 +120,26 @@ public:
     time_point last_seen() const { return last_seen_; }
     void touch() { last_seen_ = clock::now(); }
 
-    // ── Standalone (no-PG) default response handlers ────────────────────
-    // Generate default "Accepted" responses for all OCPP operations.
-    // Used when WITH_POSTGRESQL is OFF (webhook mode).
+private:
+    friend class CSChargingPointManager;
 
-    static OcppMessage default_authorize_response(const OcppMessage& request);
-    static OcppMessage default_boot_notification_response(const OcppMessage& request);
-    static OcppMessage default_start_transaction_response(const OcppMessage& request);
-    static OcppMessage default_stop_transaction_response(const OcppMessage& request);
-    static OcppMessage default_heartbeat_response(const OcppMessage& request);
-    static OcppMessage default_status_notification_response(const OcppMessage& request);
-    static OcppMessage default_data_transfer_response(const OcppMessage& request);
-    static OcppMessage default_meter_values_response(const OcppMessage& request);
+    std::string& reset_send_buffer();
+    void send_frame(std::string_view frame);
 
-private:
     std::string identity_;
+    PointHandle handle_;
     std::string address_;
+    std::string account_;
     std::string ocpp_version_ = "1.6";
+    OcppVersion version_ = OcppVersion::V16;
     ProtocolType protocol_type_ = ProtocolType::JSON;
 
     apostol::WsConnection* ws_conn_ = nullptr;
+    FrameSink frame_sink_;
+    std::string send_buffer_;
 
     // Last request payload per action (e.g. "BootNotification" -> {...})
-    std::unordered_map<std::string, nlohmann::json> last_requests_;
+    StringMap<nlohmann::json> last_requests_;
 
     time_point connected_at_{};
     time_point last_seen_{};
@@ -108,37 +148,68 @@ private:
 // ── CSChargingPointManager ──────────────────────────────────────────────────
 // Registry of connected charging stations. Thread-safe is NOT required
 // (single epoll thread per worker).
+//
+// Points live in a slab of fixed-size chunks: addresses never move, slots are
+// recycled through a free list, and a PointHandle (slot index + generation)
+// identifies a point without hashing its identity. Two indexes map identity
+// and WsConnection to a slot.
 
 class CSChargingPointManager
 {
 public:
     CSChargingPointManager() = default;
 
+    CSChargingPointManager(const CSChargingPointManager&) = delete;
+    CSChargingPointManager& operator=(const CSChargingPointManager&) = delete;
+
     // Add or get existing point by identity. Creates if not found.
     CSChargingPoint& get_or_create(const std::string& identity);
 
+    // Resolve a handle (nullptr if the point was removed).
+    CSChargingPoint* get(PointHandle handle) const;
+
     // Find by identity (nullptr if not found).
     CSChargingPoint* find_by_identity(std::string_view identity) const;
 
     // Find by WsConnection (nullptr if not found).
     CSChargingPoint* find_by_connection(const apostol::WsConnection* conn) const;
 
+    // Attach @p conn to @p point (nullptr detaches) and update the connection index.
+    void bind_connection(CSChargingPoint& point, apostol::WsConnection* conn);
+
     // Remove by identity. Returns true if found and removed.
     bool remove(const std::string& identity);
 
     // Iteration.
-    std::size_t size() const { return points_.size(); }
-    bool empty() const { return points_.empty(); }
+    std::size_t size() const { return by_identity_.size(); }
+    bool empty() const { return by_identity_.empty(); }
 
     template<typename Fn>
     void for_each(Fn&& fn) const
     {
-        for (const auto& [id, pt] : points_)
-            fn(*pt);
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            const Slot& slot = slot_at(static_cast<uint32_t>(i));
+            if (slot.point)
+                fn(*slot.point);
+        }
     }
 
 private:
-    std::unordered_map<std::string, std::unique_ptr<CSChargingPoint>> points_;
+    static constexpr std::size_t kChunkSize = 256;
+
+    struct Slot {
+        std::optional<CSChargingPoint> point;
+        uint32_t generation = 0;
+    };
+
+    Slot& slot_at(uint32_t index) const { return chunks_[index / kChunkSize][index % kChunkSize]; }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    std::vector<uint32_t>                free_;
+    std::size_t                          slot_count_ = 0;
+
+    StringMap<uint32_t>                                        by_identity_;
+    std::unordered_map<const apostol::WsConnection*, uint32_t> by_connection_;
 };
 
 } // namespace ocpp
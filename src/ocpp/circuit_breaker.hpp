@@ -0,0 +1,137 @@
+#pragma once
+//
+// CircuitBreaker — health tracking for a backend (the webhook).
+//
+// Closed:    requests pass; each outcome updates an exponentially weighted
+//            error rate and latency. Once `min_samples` outcomes are in and
+//            either average crosses its threshold, the breaker opens.
+// Open:      requests are refused for `open_for`, then the breaker half-opens.
+// Half-open: up to `probes` requests pass; if all succeed in time the
+//            breaker closes with fresh averages, any failure re-opens it.
+//
+// Every request admitted by allow() must report exactly one outcome.
+//
+
+#include <chrono>
+#include <cstddef>
+
+namespace ocpp
+{
+
+class CircuitBreaker
+{
+public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+
+    enum class State { Closed, Open, HalfOpen };
+
+    struct Options {
+        double                    error_rate = 0.5;  // averaged failure ratio that opens
+        std::chrono::milliseconds latency{5000};     // averaged latency that opens
+        std::size_t               min_samples = 20;  // outcomes before it may open
+        double                    alpha = 0.1;       // weight of the newest outcome
+        std::chrono::milliseconds open_for{10000};   // before probing again
+        std::size_t               probes = 3;        // successes needed to close
+    };
+
+    CircuitBreaker() = default;
+    explicit CircuitBreaker(Options options) : options_(options) {}
+
+    /// May a request go to the backend now?
+    bool allow(time_point now)
+    {
+        switch (state_) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (now - opened_at_ < options_.open_for)
+                return false;
+            state_     = State::HalfOpen;
+            in_flight_ = 0;
+            successes_ = 0;
+            [[fallthrough]];
+        case State::HalfOpen:
+            if (in_flight_ + successes_ >= options_.probes)
+                return false;
+            ++in_flight_;
+            return true;
+        }
+        return false;
+    }
+
+    void record_success(std::chrono::milliseconds latency, time_point now)
+    {
+        if (state_ == State::HalfOpen) {
+            if (in_flight_ > 0) --in_flight_;
+            if (latency >= options_.latency) {
+                trip(now);
+            } else if (++successes_ >= options_.probes) {
+                state_      = State::Closed;
+                samples_    = 0;
+                error_ewma_ = 0.0;
+                latency_ms_ = 0.0;
+                latency_seeded_ = false;
+            }
+            return;
+        }
+        sample(false, latency, now);
+    }
+
+    void record_failure(time_point now)
+    {
+        if (state_ == State::HalfOpen) {
+            trip(now);
+            return;
+        }
+        sample(true, {}, now);
+    }
+
+    State state() const { return state_; }
+    double error_rate() const { return error_ewma_; }
+    std::chrono::milliseconds latency() const
+    {
+        return std::chrono::milliseconds(static_cast<int64_t>(latency_ms_));
+    }
+
+private:
+    void sample(bool failed, std::chrono::milliseconds latency, time_point now)
+    {
+        if (state_ != State::Closed)
+            return;  // answers to requests sent before the breaker opened
+
+        // The error rate starts from "healthy"; the first answer seeds the latency
+        error_ewma_ += options_.alpha * ((failed ? 1.0 : 0.0) - error_ewma_);
+        if (!failed) {
+            const double a = latency_seeded_ ? options_.alpha : 1.0;
+            latency_ms_ += a * (static_cast<double>(latency.count()) - latency_ms_);
+            latency_seeded_ = true;
+        }
+        ++samples_;
+
+        if (samples_ >= options_.min_samples &&
+            (error_ewma_ >= options_.error_rate ||
+             latency_ms_ >= static_cast<double>(options_.latency.count())))
+            trip(now);
+    }
+
+    void trip(time_point now)
+    {
+        state_     = State::Open;
+        opened_at_ = now;
+        in_flight_ = 0;
+        successes_ = 0;
+    }
+
+    Options     options_;
+    State       state_ = State::Closed;
+    time_point  opened_at_{};
+    std::size_t samples_ = 0;
+    double      error_ewma_ = 0.0;
+    double      latency_ms_ = 0.0;
+    bool        latency_seeded_ = false;
+    std::size_t in_flight_ = 0;  // half-open probes awaiting an outcome
+    std::size_t successes_ = 0;  // half-open probes that succeeded
+};
+
+} // namespace ocpp
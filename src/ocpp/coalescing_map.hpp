@@ -0,0 +1,66 @@
+#pragma once
+//
+// CoalescingMap — latest value per key, collected between flushes.
+//
+// put() replaces an earlier value for the same key instead of queuing a
+// second one, so a key that changes several times before the next take()
+// is flushed once, with its final value. Keys come out of take() in the
+// order they were first put. The counters tell how much was saved.
+//
+
+#include "ocpp/string_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ocpp
+{
+
+template<typename T>
+class CoalescingMap
+{
+public:
+    using Entry = std::pair<std::string, T>;
+
+    /// Record @p value for @p key. Returns true if it replaced a pending value.
+    bool put(std::string_view key, T value)
+    {
+        ++submitted_;
+
+        if (auto it = index_.find(key); it != index_.end()) {
+            entries_[it->second].second = std::move(value);
+            ++coalesced_;
+            return true;
+        }
+
+        index_.emplace(std::string(key), entries_.size());
+        entries_.emplace_back(std::string(key), std::move(value));
+        return false;
+    }
+
+    /// Pending entries in first-put order; the map is left empty.
+    std::vector<Entry> take()
+    {
+        index_.clear();
+        return std::exchange(entries_, {});
+    }
+
+    bool empty() const { return entries_.empty(); }
+    std::size_t size() const { return entries_.size(); }
+
+    /// Values put since construction, and how many of them replaced another.
+    uint64_t submitted() const { return submitted_; }
+    uint64_t coalesced() const { return coalesced_; }
+
+private:
+    std::vector<Entry>         entries_;
+    StringMap<std::size_t>     index_;
+    uint64_t                   submitted_ = 0;
+    uint64_t                   coalesced_ = 0;
+};
+
+} // namespace ocpp
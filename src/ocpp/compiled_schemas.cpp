@@ -0,0 +1,47 @@
+#include "ocpp/compiled_schemas.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace ocpp
+{
+
+uint64_t schema_hash(const nlohmann::json& schema)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : schema.dump()) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+namespace schema_detail
+{
+
+void fail(const Path* path, const nlohmann::json& instance, const std::string& message)
+{
+    std::vector<const Path*> chain;
+    for (auto* p = path; p; p = p->parent)
+        chain.push_back(p);
+
+    nlohmann::json::json_pointer ptr;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        ptr = (*it)->is_index ? ptr / (*it)->index : ptr / std::string((*it)->key);
+
+    // Same text as json-schema-validator's throwing error handler
+    throw std::invalid_argument("At " + ptr.to_string() + " of " + instance.dump() + " - " + message + "\n");
+}
+
+std::size_t utf8_length(const std::string& s)
+{
+    std::size_t length = 0;
+    for (unsigned char c : s)
+        if ((c & 0xc0) != 0x80)
+            ++length;
+    return length;
+}
+
+} // namespace schema_detail
+
+} // namespace ocpp
@@ -0,0 +1,70 @@
+#pragma once
+//
+// Compiled validators for the hot OCPP schemas.
+//
+// ocpp_schemagen (src/tools/schemagen.cpp) turns selected files of conf/schemas
+// into C++ functions at build time. A compiled validator checks the same
+// keywords as nlohmann::json_schema::json_validator, in the same order, and
+// throws std::invalid_argument with the same text:
+//
+//   "At <json pointer> of <instance.dump()> - <message>\n"
+//
+// SchemaRegistry uses it instead of the generic validator when the schema file
+// it loads is the one the validator was generated from (same schema_hash()).
+//
+
+#include "ocpp/action.hpp"
+#include "ocpp/protocol.hpp"
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ocpp
+{
+
+enum class SchemaDirection : uint8_t { Request, Response };
+
+namespace schema_detail { struct Path; }
+
+// Validates the instance at path (nullptr = document root); throws on error.
+using CompiledValidator = void (*)(const nlohmann::json& instance, const schema_detail::Path* path);
+
+struct CompiledSchema {
+    uint64_t          hash;      // schema_hash() of the source schema
+    CompiledValidator validate;
+};
+
+// Generated: compiled validator for (version, action, direction), or nullptr.
+const CompiledSchema* find_compiled_schema(OcppVersion version, Action action,
+                                           SchemaDirection direction);
+
+// FNV-1a (64-bit) of schema.dump(). ocpp_schemagen computes the same value.
+uint64_t schema_hash(const nlohmann::json& schema);
+
+// ── Support for generated code ──────────────────────────────────────────────
+
+namespace schema_detail
+{
+
+// Location of the instance being validated, kept on the stack and turned into
+// a JSON pointer only when an error is reported.
+struct Path {
+    Path(const Path* p, std::string_view k) : parent(p), key(k) {}
+    Path(const Path* p, std::size_t i) : parent(p), index(i), is_index(true) {}
+
+    const Path*      parent = nullptr;
+    std::string_view key;
+    std::size_t      index = 0;
+    bool             is_index = false;
+};
+
+[[noreturn]] void fail(const Path* path, const nlohmann::json& instance, const std::string& message);
+
+// Number of UTF-8 code points (as counted by minLength/maxLength).
+std::size_t utf8_length(const std::string& s);
+
+} // namespace schema_detail
+
+} // namespace ocpp
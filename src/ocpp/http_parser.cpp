@@ -0,0 +1,317 @@
+#include "ocpp/http_parser.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace ocpp
+{
+
+namespace
+{
+
+bool iequals(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return (x | 0x20) == (y | 0x20);
+           });
+}
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// Does the comma-separated header value contain @p token?
+bool has_token(std::string_view value, std::string_view token)
+{
+    while (!value.empty()) {
+        auto comma = value.find(',');
+        if (iequals(trim(value.substr(0, comma)), token))
+            return true;
+        if (comma == std::string_view::npos)
+            break;
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+// Append bytes of @p data to @p line up to and including '\n'. Returns true
+// once the line is complete; the CRLF is stripped.
+bool read_line(std::string_view data, std::size_t& pos, std::string& line)
+{
+    auto nl = data.find('\n', pos);
+    auto end = nl == std::string_view::npos ? data.size() : nl + 1;
+    line.append(data.substr(pos, end - pos));
+    pos = end;
+
+    if (line.size() > HttpResponseParser::kMaxHead)
+        throw std::runtime_error("HTTP line too long");
+    if (nl == std::string_view::npos)
+        return false;
+
+    line.pop_back();
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    return true;
+}
+
+} // namespace
+
+// ── URL ─────────────────────────────────────────────────────────────────────
+
+std::optional<HttpUrl> parse_http_url(std::string_view url)
+{
+    HttpUrl result;
+
+    if (url.starts_with("http://")) {
+        url.remove_prefix(7);
+    } else if (url.starts_with("https://")) {
+        url.remove_prefix(8);
+        result.tls  = true;
+        result.port = 443;
+    } else {
+        return std::nullopt;
+    }
+
+    auto end = url.find_first_of("/?#");
+    auto authority = url.substr(0, end);
+    auto rest = end == std::string_view::npos ? std::string_view{} : url.substr(end);
+
+    if (authority.empty() || authority.find('@') != std::string_view::npos)
+        return std::nullopt;
+
+    std::string_view host = authority;
+    std::string_view port;
+    if (authority.front() == '[') {
+        auto close = authority.find(']');
+        if (close == std::string_view::npos)
+            return std::nullopt;
+        host = authority.substr(1, close - 1);
+        auto after = authority.substr(close + 1);
+        if (!after.empty()) {
+            if (after.front() != ':')
+                return std::nullopt;
+            port = after.substr(1);
+        }
+    } else if (auto colon = authority.find(':'); colon != std::string_view::npos) {
+        host = authority.substr(0, colon);
+        port = authority.substr(colon + 1);
+    }
+
+    if (host.empty())
+        return std::nullopt;
+
+    if (!port.empty()) {
+        unsigned value = 0;
+        auto [ptr, ec] = std::from_chars(port.data(), port.data() + port.size(), value);
+        if (ec != std::errc{} || ptr != port.data() + port.size() || value == 0 || value > 65535)
+            return std::nullopt;
+        result.port = static_cast<uint16_t>(value);
+    }
+
+    rest = rest.substr(0, rest.find('#'));
+    result.host        = std::string(host);
+    result.host_header = std::string(authority);
+    result.target      = rest.starts_with('/') ? std::string(rest) : "/" + std::string(rest);
+    return result;
+}
+
+// ── Response parser ─────────────────────────────────────────────────────────
+
+std::size_t HttpResponseParser::feed(std::string_view data)
+{
+    std::size_t pos = 0;
+
+    while (pos < data.size() && state_ != State::Done) {
+        switch (state_) {
+        case State::Head: {
+            // Up to the blank line ending the headers; the terminator may
+            // straddle two reads, so search from just before the old end
+            const auto before = head_.size();
+            head_.append(data.substr(pos));
+            auto end = head_.find("\r\n\r\n", before < 3 ? 0 : before - 3);
+            if (end == std::string::npos) {
+                if (head_.size() > kMaxHead)
+                    throw std::runtime_error("HTTP response head too large");
+                pos = data.size();
+                break;
+            }
+            end += 4;
+            pos += end - before;
+            head_.resize(end);
+            parse_head();
+            break;
+        }
+
+        case State::Body:
+        case State::ChunkData: {
+            auto n = std::min(remaining_, data.size() - pos);
+            append_body(data.substr(pos, n));
+            pos += n;
+            remaining_ -= n;
+            if (remaining_ == 0)
+                state_ = state_ == State::Body ? State::Done : State::ChunkEnd;
+            break;
+        }
+
+        case State::UntilClose:
+            append_body(data.substr(pos));
+            pos = data.size();
+            break;
+
+        case State::ChunkSize: {
+            if (!read_line(data, pos, head_))
+                break;
+            std::string_view line = head_;
+            line = trim(line.substr(0, line.find(';')));
+            std::size_t size = 0;
+            auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+            if (line.empty() || ec != std::errc{} || ptr != line.data() + line.size())
+                throw std::runtime_error("HTTP chunk size is malformed");
+            head_.clear();
+            if (size == 0) {
+                state_ = State::Trailer;
+            } else {
+                if (size > kMaxBody)
+                    throw std::runtime_error("HTTP response body too large");
+                remaining_ = size;
+                state_ = State::ChunkData;
+            }
+            break;
+        }
+
+        case State::ChunkEnd:
+            if (!read_line(data, pos, head_))
+                break;
+            if (!head_.empty())
+                throw std::runtime_error("HTTP chunk is not terminated by CRLF");
+            state_ = State::ChunkSize;
+            break;
+
+        case State::Trailer:
+            if (!read_line(data, pos, head_))
+                break;
+            if (head_.empty())
+                state_ = State::Done;
+            head_.clear();
+            break;
+
+        case State::Done:
+            break;
+        }
+    }
+
+    return pos;
+}
+
+bool HttpResponseParser::finish()
+{
+    if (state_ == State::UntilClose) {
+        state_ = State::Done;
+        return true;
+    }
+    return state_ == State::Done || !started();
+}
+
+HttpResponseParser::Response HttpResponseParser::take()
+{
+    Response response = std::move(response_);
+    response_  = {};
+    state_     = State::Head;
+    remaining_ = 0;
+    head_.clear();
+    return response;
+}
+
+void HttpResponseParser::parse_head()
+{
+    std::string_view head = head_;
+
+    // Status line: "HTTP/1.1 200 OK"
+    auto eol = head.find("\r\n");
+    auto status_line = head.substr(0, eol);
+    head.remove_prefix(eol + 2);
+
+    if (!status_line.starts_with("HTTP/1.") || status_line.size() < 12 || status_line[8] != ' ')
+        throw std::runtime_error(fmt::format("HTTP status line is malformed: '{}'",
+                                             status_line.substr(0, 64)));
+
+    int status = 0;
+    auto [ptr, ec] = std::from_chars(status_line.data() + 9, status_line.data() + 12, status);
+    if (ec != std::errc{} || ptr != status_line.data() + 12 || status < 100)
+        throw std::runtime_error("HTTP status code is malformed");
+
+    // Interim responses (100 Continue, 103 Early Hints) precede the real one
+    if (status < 200 && status != 101) {
+        head_.clear();
+        return;
+    }
+
+    response_.status = status;
+    response_.http11 = status_line[7] == '1';
+
+    std::optional<std::size_t> content_length;
+    bool chunked = false;
+    bool close = false;
+    bool keep_alive = false;
+
+    while (!head.empty()) {
+        eol = head.find("\r\n");
+        auto line = head.substr(0, eol);
+        head.remove_prefix(eol + 2);
+        if (line.empty())
+            break;
+
+        auto colon = line.find(':');
+        if (colon == std::string_view::npos)
+            throw std::runtime_error("HTTP header is malformed");
+        auto name  = trim(line.substr(0, colon));
+        auto value = trim(line.substr(colon + 1));
+
+        if (iequals(name, "Content-Length")) {
+            std::size_t length = 0;
+            auto [p, e] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (e != std::errc{} || p != value.data() + value.size())
+                throw std::runtime_error("HTTP Content-Length is malformed");
+            content_length = length;
+        } else if (iequals(name, "Transfer-Encoding")) {
+            chunked = has_token(value, "chunked");
+        } else if (iequals(name, "Connection")) {
+            close      = close || has_token(value, "close");
+            keep_alive = keep_alive || has_token(value, "keep-alive");
+        }
+    }
+
+    response_.keep_alive = response_.http11 ? !close : keep_alive && !close;
+    head_.clear();
+
+    if (status == 204 || status == 304) {
+        state_ = State::Done;
+    } else if (chunked) {
+        state_ = State::ChunkSize;
+    } else if (content_length) {
+        if (*content_length > kMaxBody)
+            throw std::runtime_error("HTTP response body too large");
+        remaining_ = *content_length;
+        response_.body.reserve(remaining_);
+        state_ = remaining_ == 0 ? State::Done : State::Body;
+    } else {
+        response_.keep_alive = false;
+        state_ = State::UntilClose;
+    }
+}
+
+void HttpResponseParser::append_body(std::string_view data)
+{
+    if (response_.body.size() + data.size() > kMaxBody)
+        throw std::runtime_error("HTTP response body too large");
+    response_.body.append(data);
+}
+
+} // namespace ocpp
@@ -0,0 +1,75 @@
+#pragma once
+//
+// Minimal HTTP/1.1 client-side pieces for the webhook transport:
+//   - parse_http_url() splits "http[s]://host[:port]/path" once at startup;
+//   - HttpResponseParser reads responses incrementally from a keep-alive
+//     connection (Content-Length, chunked and read-until-close bodies), so
+//     pipelined responses arriving in one read are split correctly.
+//
+// Malformed input throws std::runtime_error; the caller drops the connection.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ocpp
+{
+
+struct HttpUrl {
+    bool        tls = false;
+    std::string host;        // without brackets for IPv6 literals
+    uint16_t    port = 80;
+    std::string target;      // path and query, at least "/"
+    std::string host_header; // "host" or "host:port" for a non-default port
+};
+
+/// Parse an absolute http:// or https:// URL. Returns std::nullopt otherwise.
+std::optional<HttpUrl> parse_http_url(std::string_view url);
+
+class HttpResponseParser
+{
+public:
+    static constexpr std::size_t kMaxHead = 64 * 1024;
+    static constexpr std::size_t kMaxBody = 16 * 1024 * 1024;
+
+    struct Response {
+        int         status = 0;
+        bool        keep_alive = true;  // connection may carry further requests
+        bool        http11 = true;      // server speaks HTTP/1.1 (pipelining candidate)
+        std::string body;
+    };
+
+    /// Consume bytes until one response is complete or @p data is exhausted.
+    /// Returns the number of bytes consumed; check complete() afterwards and
+    /// feed the remainder again for the next (pipelined) response.
+    std::size_t feed(std::string_view data);
+
+    /// The peer closed the connection: completes a body delimited by EOF.
+    /// Returns false if a response was cut short.
+    bool finish();
+
+    /// A full response is available.
+    bool complete() const { return state_ == State::Done; }
+
+    /// Some bytes of the current response have arrived.
+    bool started() const { return state_ != State::Head || !head_.empty(); }
+
+    /// Move the complete response out and get ready for the next one.
+    Response take();
+
+private:
+    enum class State { Head, Body, UntilClose, ChunkSize, ChunkData, ChunkEnd, Trailer, Done };
+
+    void parse_head();
+    void append_body(std::string_view data);
+
+    State       state_ = State::Head;
+    std::string head_;        // status line + headers, then chunk-size / trailer lines
+    std::size_t remaining_ = 0;
+    Response    response_;
+};
+
+} // namespace ocpp
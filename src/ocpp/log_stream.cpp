@@ -0,0 +1,96 @@
+#include "ocpp/log_stream.hpp"
+#include "ocpp/time_utils.hpp"
+
+#include <stdexcept>
+
+namespace ocpp
+{
+
+namespace
+{
+
+void load_names(const nlohmann::json& request, const char* field, StringSet& names)
+{
+    auto it = request.find(field);
+    if (it == request.end() || it->is_null())
+        return;
+
+    auto add = [&](const nlohmann::json& value) {
+        if (!value.is_string())
+            throw std::invalid_argument(std::string("log filter: '") + field + "' must be a string or an array of strings");
+        names.insert(value.get<std::string>());
+    };
+
+    if (it->is_array()) {
+        for (const auto& value : *it)
+            add(value);
+    } else {
+        add(*it);
+    }
+}
+
+} // namespace
+
+std::string_view message_type_name(MessageType type)
+{
+    switch (type) {
+    case MessageType::Call:       return "Call";
+    case MessageType::CallResult: return "CallResult";
+    default:                      return "CallError";
+    }
+}
+
+void append_log_payload(std::string& out, const LogEvent& event)
+{
+    if (event.message)
+        event.message->append_payload(out);
+    else if (!event.payload.empty())
+        out += event.payload;
+    else
+        out += "null";
+}
+
+void append_log_event(std::string& out, const LogEvent& event)
+{
+    IsoTimeBuffer ts;
+
+    // Keys in the order nlohmann::json::dump() gives for the same object
+    out += R"({"action":)";
+    append_json_string(out, event.action);
+    out += event.direction == LogDirection::In ? R"(,"direction":"in")" : R"(,"direction":"out")";
+    out += R"(,"identity":)";
+    append_json_string(out, event.identity);
+    out += R"(,"messageType":")";
+    out += message_type_name(event.type);
+    out += R"(","payload":)";
+    append_log_payload(out, event);
+    out += R"(,"ts":)";
+    append_json_string(out, event.time == std::chrono::system_clock::time_point{}
+                                ? iso_time_now(ts) : format_iso_time(event.time, ts));
+    out += R"(,"uniqueId":)";
+    append_json_string(out, event.unique_id);
+    out += '}';
+}
+
+LogFilter LogFilter::parse(const nlohmann::json& request)
+{
+    if (!request.is_object())
+        throw std::invalid_argument("log filter: expected an object");
+
+    LogFilter filter;
+    load_names(request, "identity", filter.identities);
+    load_names(request, "action", filter.actions);
+
+    const auto direction = request.value("direction", std::string{});
+    if (direction == "in") {
+        filter.out = false;
+    } else if (direction == "out") {
+        filter.in = false;
+    } else if (!direction.empty()) {
+        throw std::invalid_argument("log filter: 'direction' must be \"in\" or \"out\"");
+    }
+
+    return filter;
+}
+
+} // namespace ocpp
@@ -0,0 +1,104 @@
+#pragma once
+//
+// Live message log for /ws/log subscribers.
+//
+// A LogEvent only points at the message being logged; it is serialized (once,
+// and only if some subscriber's filter matches) straight from the original
+// payload bytes, so logging never copies a payload DOM:
+//
+//   {"action":"Heartbeat","direction":"in","identity":"CP1","messageType":"Call",
+//    "payload":{},"ts":"2024-01-01T00:00:00.000Z","uniqueId":"42"}
+//
+// A subscriber narrows the stream by sending a filter:
+//
+//   {"identity": ["CP1", "CP2"], "action": "BootNotification", "direction": "in"}
+//
+// Each field is optional (a string or an array of strings); an empty filter
+// passes everything. Entries whose action is unknown (e.g. replies to the
+// station) do not pass an action filter.
+//
+// LogPayload formats an event's payload for a log line only when the line is
+// formatted, so a debug line below the logger's level serializes nothing.
+//
+
+#include "ocpp/protocol.hpp"
+#include "ocpp/string_map.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace ocpp
+{
+
+enum class LogDirection { In, Out };
+
+struct LogEvent {
+    std::string_view   identity;
+    LogDirection       direction = LogDirection::In;
+    MessageType        type = MessageType::Call;
+    std::string_view   unique_id;
+    std::string_view   action;
+    const OcppMessage* message = nullptr;  // payload source, or
+    std::string_view   payload;            // the payload's JSON text
+    std::chrono::system_clock::time_point time{};   // now, if not set
+};
+
+/// Event for @p message as sent or received, with its payload as is.
+inline LogEvent make_log_event(std::string_view identity, LogDirection direction, const OcppMessage& message)
+{
+    LogEvent event;
+    event.identity  = identity;
+    event.direction = direction;
+    event.type      = message.type;
+    event.unique_id = message.unique_id;
+    event.action    = message.action;
+    event.message   = &message;
+    return event;
+}
+
+/// Append @p event as one JSON log entry, stamped with its time (or now).
+void append_log_event(std::string& out, const LogEvent& event);
+
+/// Append the payload of @p event as JSON ("null" if it has none).
+void append_log_payload(std::string& out, const LogEvent& event);
+
+std::string_view message_type_name(MessageType type);
+
+struct LogPayload {
+    const LogEvent& event;
+};
+
+struct LogFilter {
+    StringSet identities;  // empty: any
+    StringSet actions;     // empty: any
+    bool      in  = true;
+    bool      out = true;
+
+    bool matches(const LogEvent& event) const
+    {
+        if (!(event.direction == LogDirection::In ? in : out))
+            return false;
+        if (!identities.empty() && !identities.contains(event.identity))
+            return false;
+        return actions.empty() || actions.contains(event.action);
+    }
+
+    /// Filter from a subscriber's message. Throws std::invalid_argument.
+    static LogFilter parse(const nlohmann::json& request);
+};
+
+} // namespace ocpp
+
+template <>
+struct fmt::formatter<ocpp::LogPayload> : fmt::formatter<std::string_view> {
+    auto format(const ocpp::LogPayload& payload, format_context& ctx) const -> decltype(ctx.out())
+    {
+        std::string text;
+        ocpp::append_log_payload(text, payload.event);
+        return fmt::formatter<std::string_view>::format(text, ctx);
+    }
+};
@@ -0,0 +1,120 @@
+#include "ocpp/message_log.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ocpp
+{
+
+namespace
+{
+
+constexpr std::size_t kWriteBatch = 64 * 1024;
+constexpr auto        kIdleWait   = std::chrono::milliseconds(10);
+
+void write_all(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+        auto n = ::write(fd, data.data(), data.size());
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;   // nowhere left to report it; the records are lost
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+    }
+}
+
+} // namespace
+
+MessageLog::MessageLog(Options options)
+    : options_(std::move(options))
+    , ring_(options_.queue)
+{
+    for (auto& rate : options_.sample)
+        rate = rate == 0 ? 1 : rate;
+}
+
+MessageLog::~MessageLog()
+{
+    stop();
+}
+
+void MessageLog::start()
+{
+    if (writer_.joinable())
+        return;
+
+    fd_ = ::open(options_.file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "message log: " + options_.file);
+
+    stopping_.store(false, std::memory_order_relaxed);
+    writer_ = std::thread([this] { run(); });
+}
+
+void MessageLog::stop()
+{
+    if (writer_.joinable()) {
+        stopping_.store(true, std::memory_order_release);
+        writer_.join();
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void MessageLog::push(std::string record)
+{
+    if (!ring_.try_push(std::move(record))) {
+        ++dropped_;
+        return;
+    }
+    ++logged_;
+}
+
+MessageLog::Counters MessageLog::counters() const
+{
+    return {logged_, skipped_, dropped_, written_.load(std::memory_order_relaxed)};
+}
+
+void MessageLog::run()
+{
+    std::string batch;
+    batch.reserve(kWriteBatch);
+
+    for (;;) {
+        // Read before draining, so everything pushed before stop() is written
+        const bool stopping = stopping_.load(std::memory_order_acquire);
+
+        uint64_t records = 0;
+        while (auto record = ring_.try_pop()) {
+            batch += *record;
+            batch += '\n';
+            ++records;
+            if (batch.size() >= kWriteBatch) {
+                write_all(fd_, batch);
+                batch.clear();
+            }
+        }
+        if (!batch.empty()) {
+            write_all(fd_, batch);
+            batch.clear();
+        }
+        written_.fetch_add(records, std::memory_order_relaxed);
+
+        if (stopping)
+            return;
+        if (records == 0)
+            std::this_thread::sleep_for(kIdleWait);
+    }
+}
+
+} // namespace ocpp
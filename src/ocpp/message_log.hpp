@@ -0,0 +1,95 @@
+#pragma once
+//
+// MessageLog — asynchronous JSON-lines log of OCPP traffic.
+//
+// The worker decides per message whether it is logged (sample()) before
+// anything is formatted, renders the record itself and hands it over through
+// a lock-free ring; a background thread drains the ring into the log file in
+// batches. When the writer falls behind, new records are dropped and counted
+// rather than stalling the event loop.
+//
+// Sampling is per action: a rate of 100 for MeterValues keeps the first of
+// every 100 MeterValues messages. Messages without a known action use the
+// rate of Action::Unknown (1 by default).
+//
+
+#include "ocpp/action.hpp"
+#include "ocpp/spsc_ring.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace ocpp
+{
+
+class MessageLog
+{
+public:
+    struct Options {
+        std::string                          file;
+        std::size_t                          queue = 8192;   // records
+        std::array<uint32_t, kActionCount>   sample = make_rates();  // 1 in N
+
+        static std::array<uint32_t, kActionCount> make_rates()
+        {
+            std::array<uint32_t, kActionCount> rates;
+            rates.fill(1);
+            return rates;
+        }
+    };
+
+    struct Counters {
+        uint64_t logged = 0;    // records queued for the writer
+        uint64_t skipped = 0;   // sampled out
+        uint64_t dropped = 0;   // ring full
+        uint64_t written = 0;   // records written to the file
+    };
+
+    explicit MessageLog(Options options);
+    ~MessageLog();
+
+    MessageLog(const MessageLog&) = delete;
+    MessageLog& operator=(const MessageLog&) = delete;
+
+    /// Open the file and start the writer thread. Throws std::system_error.
+    void start();
+
+    /// Flush queued records and stop the writer.
+    void stop();
+
+    /// Producer: whether the next message of @p action is to be logged.
+    bool sample(Action action)
+    {
+        auto& seen = seen_[action_index(action)];
+        const bool keep = seen == 0;
+        if (++seen >= options_.sample[action_index(action)])
+            seen = 0;
+        if (!keep)
+            ++skipped_;
+        return keep;
+    }
+
+    /// Producer: queue one record (a line without the trailing newline).
+    void push(std::string record);
+
+    Counters counters() const;
+
+private:
+    void run();
+
+    Options                            options_;
+    SpscRing<std::string>              ring_;
+    std::array<uint32_t, kActionCount> seen_{};
+    uint64_t                           logged_ = 0;
+    uint64_t                           skipped_ = 0;
+    uint64_t                           dropped_ = 0;
+    std::atomic<uint64_t>              written_{0};
+    std::atomic<bool>                  stopping_{false};
+    int                                fd_ = -1;
+    std::thread                        writer_;
+};
+
+} // namespace ocpp
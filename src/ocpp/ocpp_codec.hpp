@@ -17,31 +17,29 @@ namespace ocpp
 class OcppCodec final : public apostol::WsCodec
 {
 public:
+    // Writes the frame straight from the WsMessage fields; the payload is
+    // serialized once and never copied.
     std::string serialize(const apostol::WsMessage& msg) const override
     {
-        OcppMessage m;
-        m.unique_id = msg.id;
+        static const nlohmann::json empty_object = nlohmann::json::object();
+
+        std::string out;
 
         switch (msg.type) {
         case apostol::WsMessage::Type::Request:
-            m.type    = MessageType::Call;
-            m.action  = msg.action;
-            m.payload = msg.payload;
+            append_ocpp_frame(out, MessageType::Call, msg.id, msg.action, {}, {}, msg.payload);
             break;
         case apostol::WsMessage::Type::Response:
-            m.type    = MessageType::CallResult;
-            m.payload = msg.payload;
+            append_ocpp_frame(out, MessageType::CallResult, msg.id, {}, {}, {}, msg.payload);
             break;
         case apostol::WsMessage::Type::Error:
-            m.type              = MessageType::CallError;
-            m.error_code        = msg.error_code;
-            m.error_description = msg.error_description;
-            m.payload           = msg.payload.is_null()
-                                    ? nlohmann::json::object() : msg.payload;
+            append_ocpp_frame(out, MessageType::CallError, msg.id, {},
+                              msg.error_code, msg.error_description,
+                              msg.payload.is_null() ? empty_object : msg.payload);
             break;
         }
 
-        return serialize_ocpp_json(m);
+        return out;
     }
 
     apostol::WsMessage deserialize(std::string_view text) const override
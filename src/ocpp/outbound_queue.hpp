@@ -0,0 +1,113 @@
+#pragma once
+//
+// OutboundQueue — bounded send queue in front of one WebSocket.
+//
+// Frames are written straight through while the socket has room; the room is
+// probed from the kernel only when the last known credit runs out. Once the
+// socket is full, frames wait here until it becomes writable again (flush()),
+// so at most one frame ever spills over into the WebSocket layer's own
+// buffer.
+//
+// Past `high_water` queued bytes the policy decides:
+//   Disconnect  — the consumer is too slow, send() reports Evict;
+//   DropOldest  — the oldest frames are dropped down to `low_water`.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+namespace ocpp
+{
+
+class OutboundQueue
+{
+public:
+    enum class Policy { Disconnect, DropOldest };
+    enum class Result { Sent, Queued, Evict };
+
+    struct Options {
+        std::size_t high_water = 1024 * 1024;
+        std::size_t low_water  = 256 * 1024;
+        Policy      policy = Policy::Disconnect;
+    };
+
+    struct Counters {
+        uint64_t    queued_frames = 0;   // frames that had to wait
+        uint64_t    dropped_frames = 0;
+        uint64_t    dropped_bytes = 0;
+        std::size_t peak_bytes = 0;
+    };
+
+    OutboundQueue() = default;
+    explicit OutboundQueue(Options options) : options_(options) {}
+
+    /// Send @p frame through @p write if the socket has room (@p probe returns
+    /// the bytes it can take now), otherwise queue a copy.
+    template<typename Probe, typename Write>
+    Result send(std::string_view frame, Probe&& probe, Write&& write)
+    {
+        if (frames_.empty()) {
+            if (credit_ < frame.size())
+                credit_ = probe();
+            if (credit_ > 0) {
+                consume(frame.size());
+                write(frame);
+                return Result::Sent;
+            }
+        }
+
+        frames_.emplace_back(frame);
+        bytes_ += frame.size();
+        ++counters_.queued_frames;
+        if (bytes_ > counters_.peak_bytes)
+            counters_.peak_bytes = bytes_;
+
+        if (bytes_ > options_.high_water) {
+            if (options_.policy == Policy::Disconnect)
+                return Result::Evict;
+
+            // Keep the newest frame even if it alone is above low water
+            while (bytes_ > options_.low_water && frames_.size() > 1) {
+                bytes_ -= frames_.front().size();
+                counters_.dropped_bytes += frames_.front().size();
+                ++counters_.dropped_frames;
+                frames_.pop_front();
+            }
+        }
+        return Result::Queued;
+    }
+
+    /// The socket is writable: send queued frames while it has room.
+    /// Returns true once the queue is empty.
+    template<typename Probe, typename Write>
+    bool flush(Probe&& probe, Write&& write)
+    {
+        credit_ = probe();
+        while (!frames_.empty() && credit_ > 0) {
+            consume(frames_.front().size());
+            write(std::string_view(frames_.front()));
+            bytes_ -= frames_.front().size();
+            frames_.pop_front();
+        }
+        return frames_.empty();
+    }
+
+    bool empty() const { return frames_.empty(); }
+    std::size_t queued_bytes() const { return bytes_; }
+    std::size_t queued_frames() const { return frames_.size(); }
+    const Counters& counters() const { return counters_; }
+
+private:
+    void consume(std::size_t size) { credit_ = credit_ > size ? credit_ - size : 0; }
+
+    Options                 options_;
+    std::deque<std::string> frames_;
+    std::size_t             bytes_ = 0;
+    std::size_t             credit_ = 0;   // bytes the socket is known to accept
+    Counters                counters_;
+};
+
+} // namespace ocpp
@@ -0,0 +1,219 @@
+#pragma once
+//
+// PendingCalls — outbound CS->CP Calls waiting for their CallResult/CallError.
+//
+// Each call is indexed three ways:
+//   - by uniqueId, to resolve it when the station answers;
+//   - by station (intrusive list per PointHandle), so a disconnect fails all
+//     of the station's calls at once;
+//   - by deadline (min-heap), so expiry only touches calls that are due.
+//
+// Resolving or failing a call leaves its heap node behind; the node carries
+// the slot generation and is skipped when it surfaces. Stale nodes are
+// bounded by the number of calls issued within one timeout.
+//
+
+#include "ocpp/charging_point.hpp"
+#include "ocpp/string_map.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ocpp
+{
+
+template<typename T>
+class PendingCalls
+{
+public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+
+    struct Call {
+        std::string unique_id;
+        PointHandle station;
+        time_point  deadline;
+        T           value;
+    };
+
+    // Register a call. Returns false (and keeps the existing one) if the
+    // uniqueId is already pending.
+    bool insert(std::string unique_id, PointHandle station, time_point deadline, T value)
+    {
+        if (by_id_.contains(unique_id))
+            return false;
+
+        uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+
+        Slot& slot = slots_[index];
+        slot.call.emplace(Call{std::move(unique_id), station, deadline, std::move(value)});
+
+        by_id_.emplace(slot.call->unique_id, index);
+        link(index);
+        deadlines_.push(Deadline{deadline, index, slot.generation});
+        ++size_;
+        return true;
+    }
+
+    // Remove and return the call with @p unique_id.
+    std::optional<Call> take(std::string_view unique_id)
+    {
+        auto it = by_id_.find(unique_id);
+        if (it == by_id_.end())
+            return std::nullopt;
+
+        return release(it->second);
+    }
+
+    // Remove every call whose deadline is <= now and pass it to @p fn.
+    // Cost is proportional to the number of expired (and stale) heap nodes.
+    template<typename F>
+    std::size_t expire(time_point now, F&& fn)
+    {
+        std::size_t count = 0;
+        while (!deadlines_.empty() && deadlines_.top().at <= now) {
+            auto top = deadlines_.top();
+            deadlines_.pop();
+
+            Slot& slot = slots_[top.index];
+            if (slot.generation != top.generation || !slot.call)
+                continue;  // resolved or failed earlier
+
+            auto call = release(top.index);
+            fn(*call);
+            ++count;
+        }
+        return count;
+    }
+
+    // Remove every call sent to @p station and pass it to @p fn.
+    template<typename F>
+    std::size_t take_station(PointHandle station, F&& fn)
+    {
+        std::size_t count = 0;
+        for (auto it = by_station_.find(key(station)); it != by_station_.end();
+             it = by_station_.find(key(station))) {
+            auto call = release(it->second);
+            fn(*call);
+            ++count;
+        }
+        return count;
+    }
+
+    // Earliest deadline among pending calls.
+    std::optional<time_point> next_deadline()
+    {
+        drop_stale();
+        if (deadlines_.empty())
+            return std::nullopt;
+        return deadlines_.top().at;
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Slot {
+        std::optional<Call> call;
+        uint32_t            generation = 0;
+        uint32_t            prev = kNone;  // per-station list
+        uint32_t            next = kNone;
+    };
+
+    struct Deadline {
+        time_point at;
+        uint32_t   index;
+        uint32_t   generation;
+
+        bool operator>(const Deadline& other) const { return at > other.at; }
+    };
+
+    static uint64_t key(PointHandle station)
+    {
+        return (static_cast<uint64_t>(station.generation) << 32) | station.index;
+    }
+
+    // Push the slot at the head of its station's list.
+    void link(uint32_t index)
+    {
+        Slot& slot = slots_[index];
+        auto [it, inserted] = by_station_.try_emplace(key(slot.call->station), index);
+        if (!inserted) {
+            slot.next = it->second;
+            slots_[it->second].prev = index;
+            it->second = index;
+        }
+    }
+
+    void unlink(uint32_t index)
+    {
+        Slot& slot = slots_[index];
+        if (slot.prev != kNone)
+            slots_[slot.prev].next = slot.next;
+        if (slot.next != kNone)
+            slots_[slot.next].prev = slot.prev;
+
+        if (slot.prev == kNone) {
+            auto k = key(slot.call->station);
+            if (slot.next != kNone)
+                by_station_[k] = slot.next;
+            else
+                by_station_.erase(k);
+        }
+
+        slot.prev = slot.next = kNone;
+    }
+
+    std::optional<Call> release(uint32_t index)
+    {
+        Slot& slot = slots_[index];
+        unlink(index);
+        by_id_.erase(slot.call->unique_id);
+
+        std::optional<Call> call = std::move(slot.call);
+        slot.call.reset();
+        ++slot.generation;
+        free_.push_back(index);
+        --size_;
+
+        if (size_ == 0)
+            deadlines_ = {};  // everything left is stale
+        return call;
+    }
+
+    void drop_stale()
+    {
+        while (!deadlines_.empty()) {
+            const auto& top = deadlines_.top();
+            const Slot& slot = slots_[top.index];
+            if (slot.generation == top.generation && slot.call)
+                break;
+            deadlines_.pop();
+        }
+    }
+
+    std::vector<Slot>     slots_;
+    std::vector<uint32_t> free_;
+    std::size_t           size_ = 0;
+
+    StringMap<uint32_t>                    by_id_;
+    std::unordered_map<uint64_t, uint32_t> by_station_;  // station -> list head
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines_;
+};
+
+} // namespace ocpp
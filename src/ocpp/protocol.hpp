@@ -6,7 +6,11 @@
 // and JSON array <-> structured message conversion.
 //
 
+#include "ocpp/action.hpp"
+
 #include <nlohmann/json.hpp>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <stdexcept>
@@ -21,6 +25,16 @@ namespace ocpp
 
 enum class ProtocolType { SOAP, JSON };
 
+// JSON protocol version negotiated on the WebSocket ("ocpp1.6" / "ocpp2.0.1")
+enum class OcppVersion : uint8_t { V16, V201 };
+
+inline constexpr std::size_t kOcppVersionCount = 2;
+
+constexpr OcppVersion ocpp_version_from_string(std::string_view version)
+{
+    return version == "2.0.1" ? OcppVersion::V201 : OcppVersion::V16;
+}
+
 enum class MessageType { Call = 2, CallResult = 3, CallError = 4 };
 
 // ── OCPP Error Codes (1.6 spec) ────────────────────────────────────────────
@@ -199,94 +213,422 @@ enum class MessageTrigger {
 
 // ── OCPP JSON Message (wire format) ────────────────────────────────────────
 
+namespace detail
+{
+
+// nlohmann output adapter that appends to a string chosen per call.
+class StringSink final : public nlohmann::detail::output_adapter_protocol<char>
+{
+public:
+    std::string* target = nullptr;
+
+    void write_character(char c) override { target->push_back(c); }
+    void write_characters(const char* s, std::size_t length) override { target->append(s, length); }
+};
+
+} // namespace detail
+
+// Append @p value to @p out as compact JSON (same text as value.dump()),
+// serialized in place without an intermediate string. The serializer (and the
+// 512-byte indent string it allocates on construction) is built once per thread.
+// This relies on nlohmann's detail API (3.11); the protocol tests compare the
+// result with dump(). If the value holds invalid UTF-8 the serializer throws
+// mid-way: @p out is cut back to its old size before the exception leaves.
+inline void append_json(std::string& out, const nlohmann::json& value)
+{
+    struct Writer {
+        std::shared_ptr<detail::StringSink>          sink = std::make_shared<detail::StringSink>();
+        nlohmann::detail::serializer<nlohmann::json> serializer{sink, ' '};
+    };
+    static thread_local Writer writer;
+
+    const auto size = out.size();
+    writer.sink->target = &out;
+    try {
+        writer.serializer.dump(value, false, false, 0);
+    } catch (...) {
+        out.resize(size);
+        throw;
+    }
+}
+
 struct OcppMessage {
     MessageType    type = MessageType::Call;
     std::string    unique_id;
     std::string    action;           // only for Call
+    Action         action_id = Action::Unknown; // interned `action` (Unknown if not an OCPP action)
     std::string    error_code;       // only for CallError
     std::string    error_description;// only for CallError
     nlohmann::json payload = nlohmann::json::object();
+
+    // Original payload bytes when the message was parsed from the wire, empty
+    // when it was built in memory. Code that changes `payload` in a way that
+    // must reach the backend has to clear it (and raw_view).
+    std::string    raw_payload;
+
+    // The same bytes as a view into the frame text, set instead of a copy by
+    // OcppFrame::envelope(); valid only while that text is.
+    std::string_view raw_view;
+
+    std::string_view raw() const { return raw_view.empty() ? std::string_view(raw_payload) : raw_view; }
+
+    // Payload as JSON text: the original bytes if known, otherwise a dump.
+    std::string payload_text() const { return raw().empty() ? payload.dump() : std::string(raw()); }
+
+    void append_payload(std::string& out) const
+    {
+        if (raw().empty()) append_json(out, payload);
+        else               out += raw();
+    }
 };
 
-// ── JSON Wire Format: Parse / Serialize ─────────────────────────────────────
+// ── Zero-copy frame scanner ────────────────────────────────────────────────
+// OcppFrame holds views into the original frame text; it is only valid while
+// that text is alive. The envelope is scanned in place, the payload is kept as
+// its raw JSON byte range and parsed into a DOM only when payload_json() is
+// called. envelope() decodes the rest and leaves the payload to the caller;
+// to_message() also parses it and copies its bytes, for a message that has
+// to outlive the text.
+//
+// String views are the raw JSON string contents (without quotes). If any of
+// them contains a backslash escape, `escaped` is set and the views must be
+// decoded (to_message() does this) before being compared with plain text.
+
+struct OcppFrame {
+    MessageType      type = MessageType::Call;
+    std::string_view unique_id;
+    std::string_view action;            // only for Call
+    std::string_view error_code;        // only for CallError
+    std::string_view error_description; // only for CallError
+    std::string_view payload;           // raw JSON value, e.g. {"status":"Accepted"}
+    bool             escaped = false;
+
+    nlohmann::json payload_json() const { return nlohmann::json::parse(payload); }
+
+    OcppMessage envelope() const;
+    OcppMessage to_message() const;
+};
 
-inline OcppMessage parse_ocpp_json(std::string_view text)
+namespace detail
 {
-    auto arr = nlohmann::json::parse(text);
 
-    if (!arr.is_array() || arr.size() < 3)
-        throw std::invalid_argument("OCPP message must be a JSON array with at least 3 elements");
+class FrameScanner
+{
+public:
+    explicit FrameScanner(std::string_view text) : text_(text) {}
+
+    void skip_ws()
+    {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+            ++pos_;
+        }
+    }
 
-    OcppMessage msg;
-    int type_id = arr[0].get<int>();
+    bool at_end() { skip_ws(); return pos_ >= text_.size(); }
+
+    char peek() { skip_ws(); return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+    void expect(char c)
+    {
+        if (peek() != c)
+            fail(fmt::format("expected '{}'", c));
+        ++pos_;
+    }
+
+    // Consume ',' or return false on ']' (not consumed).
+    bool next_element()
+    {
+        char c = peek();
+        if (c == ',') { ++pos_; return true; }
+        if (c == ']') return false;
+        fail("expected ',' or ']'");
+    }
+
+    int scan_int()
+    {
+        skip_ws();
+        std::size_t start = pos_;
+        int value = 0;
+        while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9' && pos_ - start < 9)
+            value = value * 10 + (text_[pos_++] - '0');
+        if (pos_ == start)
+            fail("message type must be an integer");
+        return value;
+    }
+
+    // Scan a JSON string, return its raw contents (escapes are left intact).
+    std::string_view scan_string(bool& escaped)
+    {
+        if (peek() != '"')
+            fail("expected string");
+        std::size_t start = ++pos_;
+        while (pos_ < text_.size()) {
+            auto c = static_cast<unsigned char>(text_[pos_]);
+            if (c == '"')
+                return text_.substr(start, pos_++ - start);
+            if (c == '\\') {
+                escaped = true;
+                pos_ += 2;
+                continue;
+            }
+            if (c < 0x20)
+                fail("control character in string");
+            ++pos_;
+        }
+        fail("unterminated string");
+    }
+
+    // Skip any JSON value and return its raw byte range. Nested structure is
+    // only bracket-matched here; full validation happens when (and if) the
+    // range is parsed.
+    std::string_view scan_value()
+    {
+        char c = peek();
+        std::size_t start = pos_;
+        bool escaped = false;
+
+        if (c == '"') {
+            scan_string(escaped);
+            return text_.substr(start, pos_ - start);
+        }
+
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (pos_ < text_.size()) {
+                char ch = text_[pos_];
+                if (ch == '"') {
+                    scan_string(escaped);
+                    continue;
+                }
+                if (ch == '{' || ch == '[') {
+                    ++depth;
+                } else if (ch == '}' || ch == ']') {
+                    if (--depth == 0)
+                        return text_.substr(start, ++pos_ - start);
+                }
+                ++pos_;
+            }
+            fail("unterminated object or array");
+        }
+
+        // number / true / false / null
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_];
+            if (ch == ',' || ch == ']' || ch == '}' || ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r')
+                break;
+            ++pos_;
+        }
+        if (pos_ == start)
+            fail("expected value");
+        return text_.substr(start, pos_ - start);
+    }
+
+    [[noreturn]] void fail(std::string_view what) const
+    {
+        throw std::invalid_argument(fmt::format("Invalid OCPP frame at offset {}: {}", pos_, what));
+    }
+
+private:
+    std::string_view text_;
+    std::size_t      pos_ = 0;
+};
+
+// Decode a raw JSON string body (as returned by the scanner) into text.
+inline std::string unescape_json_string(std::string_view raw)
+{
+    if (raw.find('\\') == std::string_view::npos)
+        return std::string(raw);
+
+    std::string quoted;
+    quoted.reserve(raw.size() + 2);
+    quoted += '"';
+    quoted += raw;
+    quoted += '"';
+    return nlohmann::json::parse(quoted).get<std::string>();
+}
+
+} // namespace detail
+
+// Append @p text to @p out as a quoted JSON string.
+inline void append_json_string(std::string& out, std::string_view text)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    out += '"';
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        out.append(text.data() + run, i - run);
+        run = i + 1;
+
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0x0f];
+                break;
+        }
+    }
+    out.append(text.data() + run, text.size() - run);
+    out += '"';
+}
+
+inline OcppFrame parse_ocpp_frame(std::string_view text)
+{
+    detail::FrameScanner sc(text);
+    OcppFrame frame;
+
+    sc.expect('[');
+    int type_id = sc.scan_int();
+
+    auto need = [&sc](const char* what) {
+        if (!sc.next_element())
+            throw std::invalid_argument(what);
+    };
 
     switch (type_id) {
     case 2: // Call
-        if (arr.size() < 4)
-            throw std::invalid_argument("OCPP Call must have 4 elements");
-        msg.type      = MessageType::Call;
-        msg.unique_id = arr[1].get<std::string>();
-        msg.action    = arr[2].get<std::string>();
-        msg.payload   = arr[3];
+        need("OCPP message must be a JSON array with at least 3 elements");
+        frame.unique_id = sc.scan_string(frame.escaped);
+        need("OCPP message must be a JSON array with at least 3 elements");
+        frame.action    = sc.scan_string(frame.escaped);
+        need("OCPP Call must have 4 elements");
+        frame.type      = MessageType::Call;
+        frame.payload   = sc.scan_value();
         break;
 
     case 3: // CallResult
-        msg.type      = MessageType::CallResult;
-        msg.unique_id = arr[1].get<std::string>();
-        msg.payload   = arr[2];
+        need("OCPP message must be a JSON array with at least 3 elements");
+        frame.unique_id = sc.scan_string(frame.escaped);
+        need("OCPP message must be a JSON array with at least 3 elements");
+        frame.type      = MessageType::CallResult;
+        frame.payload   = sc.scan_value();
         break;
 
     case 4: // CallError
-        if (arr.size() < 5)
-            throw std::invalid_argument("OCPP CallError must have 5 elements");
-        msg.type              = MessageType::CallError;
-        msg.unique_id         = arr[1].get<std::string>();
-        msg.error_code        = arr[2].get<std::string>();
-        msg.error_description = arr[3].get<std::string>();
-        msg.payload           = arr[4];
+        need("OCPP message must be a JSON array with at least 3 elements");
+        frame.unique_id         = sc.scan_string(frame.escaped);
+        need("OCPP message must be a JSON array with at least 3 elements");
+        frame.error_code        = sc.scan_string(frame.escaped);
+        need("OCPP CallError must have 5 elements");
+        frame.error_description = sc.scan_string(frame.escaped);
+        need("OCPP CallError must have 5 elements");
+        frame.type              = MessageType::CallError;
+        frame.payload           = sc.scan_value();
         break;
 
     default:
         throw std::invalid_argument("Unknown OCPP message type: " + std::to_string(type_id));
     }
 
+    // Tolerate (and ignore) trailing elements, as the DOM parser did.
+    while (sc.next_element())
+        sc.scan_value();
+    sc.expect(']');
+
+    if (!sc.at_end())
+        sc.fail("trailing characters after frame");
+
+    return frame;
+}
+
+inline OcppMessage OcppFrame::envelope() const
+{
+    OcppMessage msg;
+    msg.type = type;
+
+    if (escaped) {
+        msg.unique_id         = detail::unescape_json_string(unique_id);
+        msg.action            = detail::unescape_json_string(action);
+        msg.error_code        = detail::unescape_json_string(error_code);
+        msg.error_description = detail::unescape_json_string(error_description);
+    } else {
+        msg.unique_id         = std::string(unique_id);
+        msg.action            = std::string(action);
+        msg.error_code        = std::string(error_code);
+        msg.error_description = std::string(error_description);
+    }
+
+    msg.action_id = action_from_string(msg.action);
+    msg.raw_view  = payload;
     return msg;
 }
 
-inline std::string serialize_ocpp_json(const OcppMessage& msg)
+inline OcppMessage OcppFrame::to_message() const
+{
+    OcppMessage msg = envelope();
+    msg.payload     = payload_json();
+    msg.raw_payload = std::string(payload);
+    msg.raw_view    = {};
+    return msg;
+}
+
+// ── JSON Wire Format: Parse / Serialize ─────────────────────────────────────
+
+inline OcppMessage parse_ocpp_json(std::string_view text)
+{
+    return parse_ocpp_frame(text).to_message();
+}
+
+// Append one frame to @p out in a single pass: the envelope is written as text
+// and the payload is serialized straight after it, so nothing is copied into
+// an intermediate JSON array. `action` is only used for Call, `error_code` and
+// `error_description` only for CallError.
+inline void append_ocpp_frame(std::string& out, MessageType type,
+                              std::string_view unique_id,
+                              std::string_view action,
+                              std::string_view error_code,
+                              std::string_view error_description,
+                              const nlohmann::json& payload)
 {
-    nlohmann::json arr;
+    out += '[';
+    out += static_cast<char>('0' + static_cast<int>(type));
+    out += ',';
+    append_json_string(out, unique_id);
+    out += ',';
 
-    switch (msg.type) {
+    switch (type) {
     case MessageType::Call:
-        arr = nlohmann::json::array({
-            static_cast<int>(msg.type),
-            msg.unique_id,
-            msg.action,
-            msg.payload
-        });
+        append_json_string(out, action);
+        out += ',';
         break;
-
     case MessageType::CallResult:
-        arr = nlohmann::json::array({
-            static_cast<int>(msg.type),
-            msg.unique_id,
-            msg.payload
-        });
         break;
-
     case MessageType::CallError:
-        arr = nlohmann::json::array({
-            static_cast<int>(msg.type),
-            msg.unique_id,
-            msg.error_code,
-            msg.error_description,
-            msg.payload
-        });
+        append_json_string(out, error_code);
+        out += ',';
+        append_json_string(out, error_description);
+        out += ',';
         break;
     }
 
-    return arr.dump();
+    append_json(out, payload);
+    out += ']';
+}
+
+inline void append_ocpp_json(std::string& out, const OcppMessage& msg)
+{
+    append_ocpp_frame(out, msg.type, msg.unique_id, msg.action,
+                      msg.error_code, msg.error_description, msg.payload);
+}
+
+inline std::string serialize_ocpp_json(const OcppMessage& msg)
+{
+    std::string out;
+    append_ocpp_json(out, msg);
+    return out;
 }
 
 // ── Unique ID Generator ─────────────────────────────────────────────────────
@@ -306,10 +648,16 @@ inline OcppMessage make_call(std::string_view action, nlohmann::json payload)
     msg.type      = MessageType::Call;
     msg.unique_id = generate_unique_id();
     msg.action    = std::string(action);
+    msg.action_id = action_from_string(action);
     msg.payload   = std::move(payload);
     return msg;
 }
 
+inline OcppMessage make_call(Action action, nlohmann::json payload)
+{
+    return make_call(action_name(action), std::move(payload));
+}
+
 inline OcppMessage make_call_result(std::string_view unique_id, nlohmann::json payload)
 {
     OcppMessage msg;
@@ -334,4 +682,35 @@ inline OcppMessage make_call_error(
     return msg;
 }
 
+// ── Backend Replies ─────────────────────────────────────────────────────────
+
+/// Convert an ocpp.parse() result — {uniqueId, messageTypeId, payload} or
+/// {uniqueId, messageTypeId: "CallError", errorCode, errorDescription,
+/// errorDetails} — into the reply for the station. Returns nullopt when the
+/// text is not such an object, so the caller can answer with a CallError.
+inline std::optional<OcppMessage> parse_backend_reply(std::string_view text)
+{
+    try {
+        auto j = nlohmann::json::parse(text);
+        if (!j.is_object())
+            return std::nullopt;
+
+        OcppMessage msg;
+        msg.unique_id = j.value("uniqueId", "");
+
+        if (j.value("messageTypeId", "CallResult") == "CallError") {
+            msg.type              = MessageType::CallError;
+            msg.error_code        = j.value("errorCode", "InternalError");
+            msg.error_description = j.value("errorDescription", "");
+            msg.payload           = j.value("errorDetails", nlohmann::json::object());
+        } else {
+            msg.type    = MessageType::CallResult;
+            msg.payload = j.value("payload", nlohmann::json::object());
+        }
+        return msg;
+    } catch (const nlohmann::json::exception&) {
+        return std::nullopt;
+    }
+}
+
 } // namespace ocpp
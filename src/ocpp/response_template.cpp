@@ -0,0 +1,79 @@
+#include "ocpp/response_template.hpp"
+#include "ocpp/protocol.hpp"
+
+#include <fmt/format.h>
+
+namespace ocpp
+{
+
+nlohmann::json ResponseTemplate::placeholder(Slot slot)
+{
+    // A control character cannot reach the wire unescaped, so the dumped
+    // placeholder never collides with real payload text.
+    return std::string{'\x01', static_cast<char>('0' + static_cast<int>(slot))};
+}
+
+ResponseTemplate::ResponseTemplate(const nlohmann::json& payload)
+    : text_(payload.dump())
+{
+    struct Marker {
+        Slot        slot;
+        std::string text;
+    };
+
+    std::vector<Marker> markers;
+    for (auto slot : {Slot::CurrentTime, Slot::ExpiryDate, Slot::TransactionId})
+        markers.push_back({slot, placeholder(slot).dump()});
+
+    std::size_t pos = 0;
+    for (;;) {
+        // Nearest placeholder after pos
+        const Marker* next = nullptr;
+        std::size_t   at = std::string::npos;
+        for (const auto& m : markers) {
+            auto found = text_.find(m.text, pos);
+            if (found < at) {
+                at = found;
+                next = &m;
+            }
+        }
+
+        if (!next) {
+            segments_.push_back({pos, text_.size() - pos});
+            break;
+        }
+
+        segments_.push_back({pos, at - pos, true, next->slot});
+        slots_ |= 1u << static_cast<unsigned>(next->slot);
+        pos = at + next->text.size();
+    }
+}
+
+void ResponseTemplate::render(std::string& out, std::string_view unique_id, const Values& values) const
+{
+    out += "[3,";
+    append_json_string(out, unique_id);
+    out += ',';
+
+    for (const auto& s : segments_) {
+        out.append(text_, s.offset, s.length);
+        if (!s.has_slot)
+            continue;
+
+        switch (s.slot) {
+        case Slot::CurrentTime:
+            append_json_string(out, values.current_time);
+            break;
+        case Slot::ExpiryDate:
+            append_json_string(out, values.expiry_date);
+            break;
+        case Slot::TransactionId:
+            fmt::format_to(std::back_inserter(out), "{}", values.transaction_id);
+            break;
+        }
+    }
+
+    out += ']';
+}
+
+} // namespace ocpp
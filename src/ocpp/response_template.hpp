@@ -0,0 +1,60 @@
+#pragma once
+//
+// Pre-rendered CallResult frames.
+//
+// A ResponseTemplate is built once from a payload DOM that contains slot
+// placeholders. The payload is serialized at construction and split into
+// literal byte runs and slots, so producing a reply is a few appends:
+//
+//   [3,"<uniqueId>",{"currentTime":"<slot>","interval":60,"status":"Accepted"}]
+//
+// The output is byte-for-byte what serialize_ocpp_json() gives for the same
+// payload with the slot values filled in.
+//
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ocpp
+{
+
+class ResponseTemplate
+{
+public:
+    enum class Slot : uint8_t { CurrentTime, ExpiryDate, TransactionId };
+
+    // Values for the slots of one reply. Only the slots the template uses
+    // are read (see uses()).
+    struct Values {
+        std::string_view current_time;  // ISO 8601, e.g. iso_time_now()
+        std::string_view expiry_date;   // ISO 8601
+        int64_t          transaction_id = 0;
+    };
+
+    // Placeholder to put into the payload where a slot's value goes.
+    static nlohmann::json placeholder(Slot slot);
+
+    explicit ResponseTemplate(const nlohmann::json& payload);
+
+    bool uses(Slot slot) const { return (slots_ & (1u << static_cast<unsigned>(slot))) != 0; }
+
+    // Append the CallResult frame for @p unique_id to @p out.
+    void render(std::string& out, std::string_view unique_id, const Values& values) const;
+
+private:
+    struct Segment {
+        std::size_t offset = 0;  // literal run in text_
+        std::size_t length = 0;
+        bool        has_slot = false;
+        Slot        slot = Slot::CurrentTime;  // written after the literal run
+    };
+
+    std::string          text_;
+    std::vector<Segment> segments_;
+    unsigned             slots_ = 0;
+};
+
+} // namespace ocpp
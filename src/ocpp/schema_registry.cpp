@@ -5,9 +5,42 @@
 namespace ocpp
 {
 
+namespace
+{
+
+std::optional<SchemaDirection> direction_from_string(std::string_view direction)
+{
+    if (direction == "Request")  return SchemaDirection::Request;
+    if (direction == "Response") return SchemaDirection::Response;
+    return std::nullopt;
+}
+
+std::string_view direction_name(SchemaDirection direction)
+{
+    return direction == SchemaDirection::Request ? "Request" : "Response";
+}
+
+} // namespace
+
+std::optional<std::string> SchemaRegistry::Handle::validate(const nlohmann::json& payload) const
+{
+    if (!compiled_ && !validator_)
+        return std::nullopt;  // No schema = no validation (passthrough)
+
+    try {
+        if (compiled_)
+            compiled_(payload, nullptr);
+        else
+            validator_->validate(payload);
+        return std::nullopt;  // Valid
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+}
+
 std::string SchemaRegistry::make_key(const std::string& version,
-                                     const std::string& action,
-                                     const std::string& direction)
+                                     std::string_view action,
+                                     std::string_view direction)
 {
     return fmt::format("{}/{}{}", version, action, direction);
 }
@@ -18,34 +51,57 @@ void SchemaRegistry::load(const std::string& version,
     if (!std::filesystem::exists(dir))
         throw std::runtime_error(fmt::format("Schema directory not found: {}", dir.string()));
 
+    const auto version_enum = ocpp_version_from_string(version);
+    const auto version_index = static_cast<std::size_t>(version_enum);
+
     for (const auto& entry : std::filesystem::directory_iterator(dir)) {
         if (!entry.is_regular_file() || entry.path().extension() != ".json")
             continue;
 
         auto filename = entry.path().stem().string();  // e.g. "BootNotificationRequest"
 
+        // 1.6 compatibility: "BootNotification.json" is the request schema
+        std::string_view action_name = filename;
+        auto direction = SchemaDirection::Request;
+        if (action_name.ends_with("Response")) {
+            action_name.remove_suffix(8);
+            direction = SchemaDirection::Response;
+        } else if (action_name.ends_with("Request")) {
+            action_name.remove_suffix(7);
+        }
+
         std::ifstream f(entry.path());
         if (!f.is_open()) continue;
 
         try {
             auto schema = nlohmann::json::parse(f);
-            nlohmann::json_schema::json_validator validator;
-            validator.set_root_schema(schema);
-            validators_.emplace(fmt::format("{}/{}", version, filename),
-                                std::move(validator));
-
-            // 1.6 compatibility: "BootNotification.json" -> also register as "BootNotificationRequest"
-            if (!filename.ends_with("Response") && !filename.ends_with("Request")) {
-                try {
-                    nlohmann::json_schema::json_validator validator2;
-                    validator2.set_root_schema(schema);
-                    validators_.emplace(fmt::format("{}/{}Request", version, filename),
-                                        std::move(validator2));
-                } catch (const std::exception& e2) {
-                    fmt::print(stderr, "Warning: failed to create 1.6 alias {}Request: {}\n",
-                               filename, e2.what());
+            auto action = action_from_string(action_name);
+
+            // Compiled validator generated from this very schema: no json_validator needed
+            if (action != Action::Unknown) {
+                const auto* compiled = find_compiled_schema(version_enum, action, direction);
+                if (compiled && compiled->hash == schema_hash(schema)) {
+                    auto& slot = table_[version_index][action_index(action)][static_cast<std::size_t>(direction)];
+                    if (!slot) ++count_;
+                    slot.compiled = compiled->validate;
+                    slot.validator.reset();
+                    continue;
                 }
             }
+
+            auto validator = std::make_unique<Validator>();
+            validator->set_root_schema(schema);
+
+            if (action != Action::Unknown) {
+                auto& slot = table_[version_index][action_index(action)][static_cast<std::size_t>(direction)];
+                if (!slot) ++count_;
+                slot.compiled = nullptr;
+                slot.validator = std::move(validator);
+            } else {
+                auto key = make_key(version, action_name, direction_name(direction));
+                if (other_.insert_or_assign(std::move(key), std::move(*validator)).second)
+                    ++count_;
+            }
         } catch (const std::exception& e) {
             fmt::print(stderr, "Warning: failed to load schema {}: {}\n",
                        entry.path().string(), e.what());
@@ -53,30 +109,50 @@ void SchemaRegistry::load(const std::string& version,
     }
 }
 
+SchemaRegistry::Handle SchemaRegistry::find(OcppVersion version, Action action,
+                                            SchemaDirection direction) const
+{
+    if (action == Action::Unknown)
+        return {};
+
+    const auto& slot = table_[static_cast<std::size_t>(version)][action_index(action)]
+                             [static_cast<std::size_t>(direction)];
+    return slot.compiled ? Handle(slot.compiled) : Handle(slot.validator.get());
+}
+
+SchemaRegistry::Handle SchemaRegistry::find(const std::string& version,
+                                            std::string_view action,
+                                            const std::string& direction) const
+{
+    auto dir = direction_from_string(direction);
+    if (!dir)
+        return {};
+
+    auto id = action_from_string(action);
+    if (id != Action::Unknown)
+        return find(ocpp_version_from_string(version), id, *dir);
+
+    if (other_.empty())
+        return {};
+
+    auto it = other_.find(make_key(version, action, direction));
+    return it != other_.end() ? Handle(&it->second) : Handle();
+}
+
 std::optional<std::string> SchemaRegistry::validate(
     const std::string& version,
-    const std::string& action,
+    std::string_view action,
     const std::string& direction,
     const nlohmann::json& payload) const
 {
-    auto key = make_key(version, action, direction);
-    auto it = validators_.find(key);
-    if (it == validators_.end())
-        return std::nullopt;  // No schema = no validation (passthrough)
-
-    try {
-        it->second.validate(payload);
-        return std::nullopt;  // Valid
-    } catch (const std::exception& e) {
-        return e.what();
-    }
+    return find(version, action, direction).validate(payload);
 }
 
 bool SchemaRegistry::has_schema(const std::string& version,
-                                const std::string& action,
+                                std::string_view action,
                                 const std::string& direction) const
 {
-    return validators_.contains(make_key(version, action, direction));
+    return static_cast<bool>(find(version, action, direction));
 }
 
 } // namespace ocpp
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "ocpp/action.hpp"
+#include "ocpp/compiled_schemas.hpp"
+#include "ocpp/protocol.hpp"
+
 #include <nlohmann/json.hpp>
 #include <nlohmann/json-schema.hpp>
+#include <array>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <memory>
 #include <unordered_map>
 #include <filesystem>
 
@@ -16,41 +23,95 @@ namespace ocpp
 //   SchemaRegistry registry;
 //   registry.load("1.6", "/etc/cs/schemas/1.6");
 //   registry.load("2.0.1", "/etc/cs/schemas/2.0.1");
-//   auto err = registry.validate("1.6", "BootNotification", "Request", payload);
+//   auto err = registry.validate(OcppVersion::V16, Action::BootNotification,
+//                                SchemaDirection::Request, payload);
 //   if (err) { /* send CallError(FormatViolation, *err) */ }
 //
+// Validators of known actions live in a table indexed by (version, action,
+// direction), so resolving one is an array lookup. find() returns a handle
+// that stays valid for the lifetime of the registry. Where a compiled
+// validator was generated from the same schema (compiled_schemas.hpp), it is
+// used instead of json_validator.
+//
 class SchemaRegistry
 {
 public:
+    using Validator = nlohmann::json_schema::json_validator;
+
+    // Resolved validator (empty = no schema, payload passes through).
+    class Handle
+    {
+    public:
+        Handle() = default;
+        explicit operator bool() const { return compiled_ != nullptr || validator_ != nullptr; }
+
+        bool compiled() const { return compiled_ != nullptr; }
+
+        // Returns std::nullopt if valid (or no schema), error string if invalid.
+        std::optional<std::string> validate(const nlohmann::json& payload) const;
+
+    private:
+        friend class SchemaRegistry;
+        explicit Handle(const Validator* validator) : validator_(validator) {}
+        explicit Handle(CompiledValidator compiled) : compiled_(compiled) {}
+
+        CompiledValidator compiled_ = nullptr;
+        const Validator*  validator_ = nullptr;
+    };
+
     // Load all *.json schemas from directory for given OCPP version.
     // Schema files named "{Action}Request.json" / "{Action}Response.json"
     // (2.0.1) or "{Action}.json" (1.6 request) / "{Action}Response.json" (1.6 response).
     void load(const std::string& version, const std::filesystem::path& dir);
 
+    // Resolve the validator for (version, action, direction).
+    Handle find(OcppVersion version, Action action, SchemaDirection direction) const;
+
     // Validate payload against schema for (version, action, direction).
     // Returns std::nullopt if valid, error string if invalid.
-    // direction: "Request" for CP->CSMS, "Response" for CSMS->CP replies.
+    std::optional<std::string> validate(OcppVersion version, Action action,
+                                        SchemaDirection direction,
+                                        const nlohmann::json& payload) const
+    {
+        return find(version, action, direction).validate(payload);
+    }
+
+    // String form. direction: "Request" for CP->CSMS, "Response" for CSMS->CP replies.
     std::optional<std::string> validate(const std::string& version,
-                                        const std::string& action,
+                                        std::string_view action,
                                         const std::string& direction,
                                         const nlohmann::json& payload) const;
 
     // Check if schema exists for (version, action, direction).
     bool has_schema(const std::string& version,
-                    const std::string& action,
+                    std::string_view action,
                     const std::string& direction) const;
 
     // Number of loaded schemas.
-    std::size_t schema_count() const { return validators_.size(); }
+    std::size_t schema_count() const { return count_; }
 
 private:
-    // Key: "version/ActionDirection" e.g. "2.0.1/BootNotificationRequest"
+    Handle find(const std::string& version, std::string_view action,
+                const std::string& direction) const;
+
+    // Key for schemas of actions outside the Action enum:
+    // "version/ActionDirection" e.g. "2.0.1/VendorActionRequest"
     static std::string make_key(const std::string& version,
-                                const std::string& action,
-                                const std::string& direction);
+                                std::string_view action,
+                                std::string_view direction);
+
+    struct Slot {
+        CompiledValidator          compiled = nullptr;
+        std::unique_ptr<Validator> validator;
+
+        explicit operator bool() const { return compiled != nullptr || validator != nullptr; }
+    };
+
+    using DirectionSlots = std::array<Slot, 2>;
 
-    std::unordered_map<std::string,
-        nlohmann::json_schema::json_validator> validators_;
+    std::array<std::array<DirectionSlots, kActionCount>, kOcppVersionCount> table_;
+    std::unordered_map<std::string, Validator> other_;
+    std::size_t count_ = 0;
 };
 
 } // namespace ocpp
@@ -0,0 +1,77 @@
+#pragma once
+//
+// SpscRing — bounded lock-free queue between exactly one producer thread and
+// one consumer thread.
+//
+// The capacity is rounded up to a power of two. Each side owns one index and
+// only reads the other's; a full ring makes try_push() fail instead of
+// blocking the producer, so the caller decides whether to drop or retry.
+//
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace ocpp
+{
+
+template<typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1)
+        , slots_(std::make_unique<T[]>(mask_ + 1))
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /// Producer: false if the ring is full (@p value is left untouched).
+    bool try_push(T&& value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: the oldest value, if any.
+    std::optional<T> try_pop()
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return std::nullopt;
+        }
+        std::optional<T> value(std::move(slots_[head & mask_]));
+        slots_[head & mask_] = T{};
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    const std::size_t    mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Producer and consumer indices on separate cache lines, each with the
+    // owner's last view of the other side
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t                          head_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t                          tail_cache_ = 0;
+};
+
+} // namespace ocpp
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ocpp
+{
+
+/// Transparent hash for std::string keys: find()/contains() accept
+/// std::string_view and const char* without building a temporary std::string.
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    std::size_t operator()(const std::string& s) const noexcept { return (*this)(std::string_view(s)); }
+    std::size_t operator()(const char* s) const noexcept { return (*this)(std::string_view(s)); }
+};
+
+template<typename T>
+using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+using StringSet = std::unordered_set<std::string, StringHash, std::equal_to<>>;
+
+} // namespace ocpp
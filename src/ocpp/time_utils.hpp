@@ -1,42 +1,250 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <chrono>
-#include <ctime>
+#include <cstdint>
+#include <optional>
 #include <string>
-
-#include <fmt/format.h>
+#include <string_view>
 
 namespace ocpp
 {
 
+// ── Formatting ──────────────────────────────────────────────────────────────
+// Timestamps are written as "YYYY-MM-DDTHH:MM:SS.mmmZ" (UTC, milliseconds).
+// The "YYYY-MM-DDTHH:MM:SS" prefix is cached per thread for the current
+// second, so formatting "now" is a 19-byte copy plus three digits; a miss is
+// plain integer arithmetic (no gmtime_r, no locale, no allocation).
+
+inline constexpr std::size_t kIsoTimeLength = 24;
+
+using IsoTimeBuffer = std::array<char, kIsoTimeLength>;
+
+namespace detail
+{
+
+// Days since 1970-01-01 -> civil date (proleptic Gregorian).
+constexpr void civil_from_days(int64_t days, int64_t& y, unsigned& m, unsigned& d)
+{
+    days += 719468;
+    const int64_t  era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+// Civil date -> days since 1970-01-01.
+constexpr int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const int64_t  era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+constexpr void put2(char* p, unsigned v)
+{
+    p[0] = static_cast<char>('0' + v / 10);
+    p[1] = static_cast<char>('0' + v % 10);
+}
+
+// "YYYY-MM-DDTHH:MM:SS" for a Unix second (years 0..9999).
+constexpr void format_second(char* p, int64_t second)
+{
+    int64_t days = second / 86400;
+    int64_t rem  = second % 86400;
+    if (rem < 0) {
+        rem += 86400;
+        --days;
+    }
+
+    int64_t  y = 0;
+    unsigned m = 0, d = 0;
+    civil_from_days(days, y, m, d);
+
+    const auto year = static_cast<unsigned>(y < 0 ? 0 : y > 9999 ? 9999 : y);
+    put2(p, year / 100);
+    put2(p + 2, year % 100);
+    p[4] = '-';
+    put2(p + 5, m);
+    p[7] = '-';
+    put2(p + 8, d);
+    p[10] = 'T';
+    put2(p + 11, static_cast<unsigned>(rem / 3600));
+    p[13] = ':';
+    put2(p + 14, static_cast<unsigned>(rem / 60 % 60));
+    p[16] = ':';
+    put2(p + 17, static_cast<unsigned>(rem % 60));
+}
+
+} // namespace detail
+
+/// Write @p tp as "YYYY-MM-DDTHH:MM:SS.mmmZ" to @p out (kIsoTimeLength bytes,
+/// no terminator). Returns the end of the written range.
+inline char* format_iso_time(char* out, std::chrono::system_clock::time_point tp)
+{
+    using namespace std::chrono;
+
+    const int64_t ms     = duration_cast<milliseconds>(tp.time_since_epoch()).count();
+    int64_t       second = ms / 1000;
+    int64_t       milli  = ms % 1000;
+    if (milli < 0) {
+        milli += 1000;
+        --second;
+    }
+
+    struct Cache {
+        int64_t second = INT64_MIN;
+        char    prefix[19] = {};
+    };
+    static thread_local Cache cache;
+
+    if (cache.second != second) {
+        detail::format_second(cache.prefix, second);
+        cache.second = second;
+    }
+
+    std::copy(cache.prefix, cache.prefix + 19, out);
+    out[19] = '.';
+    out[20] = static_cast<char>('0' + milli / 100);
+    detail::put2(out + 21, static_cast<unsigned>(milli % 100));
+    out[23] = 'Z';
+    return out + kIsoTimeLength;
+}
+
+/// Format into @p buf; the view stays valid as long as the buffer.
+inline std::string_view format_iso_time(std::chrono::system_clock::time_point tp, IsoTimeBuffer& buf)
+{
+    format_iso_time(buf.data(), tp);
+    return {buf.data(), buf.size()};
+}
+
+inline void append_iso_time(std::string& out, std::chrono::system_clock::time_point tp)
+{
+    IsoTimeBuffer buf;
+    out.append(format_iso_time(tp, buf));
+}
+
+/// Current UTC time, optionally shifted by @p delta_seconds, into @p buf.
+inline std::string_view iso_time_now(IsoTimeBuffer& buf, int delta_seconds = 0)
+{
+    return format_iso_time(std::chrono::system_clock::now() + std::chrono::seconds(delta_seconds), buf);
+}
+
 /// Format current UTC time as ISO 8601 string with milliseconds.
 /// Optional @p delta_seconds shifts the timestamp (e.g. +300 for expiry).
 inline std::string iso_time_now(int delta_seconds = 0)
 {
-    auto now = std::chrono::system_clock::now();
-    if (delta_seconds != 0)
-        now += std::chrono::seconds(delta_seconds);
+    IsoTimeBuffer buf;
+    return std::string(iso_time_now(buf, delta_seconds));
+}
+
+// ── Parsing ─────────────────────────────────────────────────────────────────
+
+/// Parse an RFC 3339 date-time: "YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM)".
+/// The fraction is kept (to the clock's precision) and the offset is applied,
+/// so the result is the UTC instant. 't'/' ' separators and 'z' are accepted;
+/// a missing offset is read as UTC, as many charge points omit it.
+/// Returns std::nullopt for malformed input. Locale-independent; no allocation.
+inline std::optional<std::chrono::system_clock::time_point> parse_rfc3339(std::string_view s)
+{
+    using namespace std::chrono;
+
+    std::size_t pos = 0;
+    bool ok = true;
+
+    auto digits = [&](std::size_t count) -> unsigned {
+        unsigned v = 0;
+        for (std::size_t i = 0; i < count; ++i, ++pos) {
+            if (pos >= s.size() || s[pos] < '0' || s[pos] > '9') {
+                ok = false;
+                return 0;
+            }
+            v = v * 10 + static_cast<unsigned>(s[pos] - '0');
+        }
+        return v;
+    };
+    auto expect = [&](auto... accepted) {
+        if (pos < s.size() && ((s[pos] == accepted) || ...))
+            ++pos;
+        else
+            ok = false;
+        return ok;
+    };
+
+    const unsigned year = digits(4);
+    if (!ok || !expect('-')) return std::nullopt;
+    const unsigned month = digits(2);
+    if (!ok || !expect('-')) return std::nullopt;
+    const unsigned day = digits(2);
+    if (!ok || !expect('T', 't', ' ')) return std::nullopt;
+    const unsigned hour = digits(2);
+    if (!ok || !expect(':')) return std::nullopt;
+    const unsigned minute = digits(2);
+    if (!ok || !expect(':')) return std::nullopt;
+    const unsigned second = digits(2);
+    if (!ok) return std::nullopt;
+
+    static constexpr unsigned kDaysInMonth[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month < 1 || month > 12 || day < 1 || day > kDaysInMonth[month - 1] ||
+        (month == 2 && day == 29 && !leap) || hour > 23 || minute > 59 || second > 60)
+        return std::nullopt;
+
+    // Fraction: keep up to nanoseconds, ignore further digits
+    int64_t nanos = 0;
+    if (pos < s.size() && s[pos] == '.') {
+        ++pos;
+        std::size_t count = 0;
+        int64_t scale = 100000000;
+        while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9') {
+            nanos += (s[pos] - '0') * scale;
+            scale /= 10;
+            ++pos;
+            ++count;
+        }
+        if (count == 0) return std::nullopt;
+    }
+
+    int64_t offset = 0;  // seconds east of UTC
+    if (pos < s.size()) {
+        const char c = s[pos++];
+        if (c == 'Z' || c == 'z') {
+            offset = 0;
+        } else if (c == '+' || c == '-') {
+            const unsigned oh = digits(2);
+            if (!ok || !expect(':')) return std::nullopt;
+            const unsigned om = digits(2);
+            if (!ok || oh > 23 || om > 59) return std::nullopt;
+            offset = (c == '+' ? 1 : -1) * static_cast<int64_t>(oh * 3600 + om * 60);
+        } else {
+            return std::nullopt;
+        }
+    }
 
-    auto tt = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+    if (pos != s.size())
+        return std::nullopt;
 
-    std::tm utc{};
-    gmtime_r(&tt, &utc);
+    const int64_t unix_seconds = detail::days_from_civil(year, month, day) * 86400 +
+                                 hour * 3600 + minute * 60 + second - offset;
 
-    return fmt::format("{:04d}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}.{:03d}Z",
-        utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
-        utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(ms.count()));
+    return system_clock::time_point(
+        duration_cast<system_clock::duration>(seconds(unix_seconds) + nanoseconds(nanos)));
 }
 
-/// Parse ISO 8601 UTC string (YYYY-MM-DDTHH:MM:SS) to time_point.
-/// Milliseconds/timezone suffix are ignored.
-inline std::chrono::system_clock::time_point parse_iso_time(const std::string& s)
+/// Parse an ISO 8601 / RFC 3339 timestamp (see parse_rfc3339), returning the
+/// epoch for malformed input.
+inline std::chrono::system_clock::time_point parse_iso_time(std::string_view s)
 {
-    std::tm tm{};
-    if (strptime(s.c_str(), "%Y-%m-%dT%H:%M:%S", &tm))
-        return std::chrono::system_clock::from_time_t(timegm(&tm));
-    return {};
+    return parse_rfc3339(s).value_or(std::chrono::system_clock::time_point{});
 }
 
 } // namespace ocpp
@@ -0,0 +1,421 @@
+#include "ocpp/traffic_journal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ocpp
+{
+
+namespace
+{
+
+// ── On-disk layout ──────────────────────────────────────────────────────────
+
+constexpr char     kMagic[8] = {'O', 'C', 'P', 'P', 'J', 'R', 'N', '1'};
+constexpr uint32_t kVersion  = 1;
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    int64_t  created;      // µs since the epoch
+    int64_t  first;        // time of the first frame; 0 until it is written
+    int32_t  pid;
+    uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 40);
+
+enum class RecordKind : uint8_t { Frame = 1, Identity = 2 };
+
+struct RecordHeader {
+    uint32_t size;            // whole record, aligned; written last
+    uint8_t  kind;
+    uint8_t  direction;
+    uint8_t  type;
+    uint8_t  action;
+    uint32_t identity;
+    uint16_t unique_id_size;
+    uint16_t reserved;
+    uint32_t payload_size;
+    uint32_t reserved2;
+    int64_t  time;            // µs since the epoch
+};
+static_assert(sizeof(RecordHeader) == 32);
+
+constexpr std::size_t kAlign          = 8;
+constexpr std::size_t kMinSegmentSize = 64 * 1024;
+
+constexpr std::size_t record_size(std::size_t body)
+{
+    return (sizeof(RecordHeader) + body + kAlign - 1) & ~(kAlign - 1);
+}
+
+int64_t to_micros(TrafficJournal::time_point tp)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+}
+
+TrafficJournal::time_point from_micros(int64_t us)
+{
+    return TrafficJournal::time_point(
+        std::chrono::duration_cast<TrafficJournal::clock::duration>(std::chrono::microseconds(us)));
+}
+
+// "journal-<created>-<pid>.ocj"
+std::string segment_name(int64_t created, int pid)
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "journal-%016" PRId64 "-%d.ocj", created, pid);
+    return name;
+}
+
+bool parse_segment_name(const std::string& name, int64_t& created, int& pid)
+{
+    char tail = 0;
+    return std::sscanf(name.c_str(), "journal-%16" SCNd64 "-%d.oc%c", &created, &pid, &tail) == 3 &&
+           tail == 'j' && name.ends_with(".ocj");
+}
+
+struct SegmentFile {
+    std::string path;
+    int64_t     created = 0;
+    int         pid = 0;
+};
+
+// Segments in `dir`, oldest first
+std::vector<SegmentFile> list_segments(const std::string& dir)
+{
+    std::vector<SegmentFile> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        SegmentFile file;
+        if (!entry.is_regular_file(ec) ||
+            !parse_segment_name(entry.path().filename().string(), file.created, file.pid))
+            continue;
+        file.path = entry.path().string();
+        files.push_back(std::move(file));
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.path < b.path; });
+    return files;
+}
+
+uint32_t load_size(const RecordHeader* header)
+{
+    // Mapped read-only in readers; an atomic 32-bit load does not write
+    return std::atomic_ref<uint32_t>(const_cast<uint32_t&>(header->size)).load(std::memory_order_acquire);
+}
+
+} // namespace
+
+// ── Writer ──────────────────────────────────────────────────────────────────
+
+TrafficJournal::TrafficJournal(Options options)
+    : options_(std::move(options))
+{
+    options_.segment_size = std::max(options_.segment_size, kMinSegmentSize);
+    options_.segments     = std::max<std::size_t>(options_.segments, 2);
+}
+
+TrafficJournal::~TrafficJournal()
+{
+    close();
+}
+
+void TrafficJournal::close()
+{
+    if (map_) {
+        ::munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+        used_ = 0;
+    }
+}
+
+void TrafficJournal::open_segment(std::size_t min_size)
+{
+    close();
+
+    std::error_code ec;
+    std::filesystem::create_directories(options_.dir, ec);
+
+    const auto size = std::max(options_.segment_size, min_size + sizeof(FileHeader));
+    int64_t created = to_micros(clock::now());
+
+    int fd = -1;
+    for (;;) {
+        path_ = options_.dir + "/" + segment_name(created, ::getpid());
+        fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd >= 0 || errno != EEXIST)
+            break;
+        ++created;  // two segments within the same microsecond
+    }
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "journal: " + path_);
+
+    // Reserve the blocks up front: a store to an unbacked page of a full disk
+    // would raise SIGBUS in the middle of append()
+    if (const int err = ::posix_fallocate(fd, 0, static_cast<off_t>(size)); err != 0) {
+        ::close(fd);
+        ::unlink(path_.c_str());
+        throw std::system_error(err, std::generic_category(), "journal: " + path_);
+    }
+
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        ::unlink(path_.c_str());
+        throw std::system_error(err, std::generic_category(), "journal: " + path_);
+    }
+
+    map_      = static_cast<std::byte*>(map);
+    map_size_ = size;
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version     = kVersion;
+    header.header_size = sizeof(FileHeader);
+    header.created     = created;
+    header.pid         = ::getpid();
+    std::memcpy(map_, &header, sizeof(header));
+    used_ = sizeof(FileHeader);
+
+    ++generation_;
+    ++counters_.segments;
+    prune();
+}
+
+// Delete the oldest segments beyond the limit; never the one just opened
+void TrafficJournal::prune()
+{
+    auto files = list_segments(options_.dir);
+    if (files.size() <= options_.segments)
+        return;
+
+    const auto excess = files.size() - options_.segments;
+    for (std::size_t i = 0; i < excess; ++i) {
+        if (files[i].path != path_)
+            ::unlink(files[i].path.c_str());
+    }
+}
+
+std::byte* TrafficJournal::reserve(std::size_t size)
+{
+    auto* p = map_ + used_;
+    used_ += size;
+    return p;
+}
+
+void TrafficJournal::append(const Record& record)
+{
+    const auto unique_id = record.unique_id.substr(0, UINT16_MAX);
+    const auto frame_size    = record_size(unique_id.size() + record.payload.size());
+    const auto identity_size = record_size(record.identity.size());
+
+    if (frame_size + identity_size > UINT32_MAX) {
+        ++counters_.dropped;
+        return;
+    }
+
+    auto it = ids_.find(record.identity);
+    if (it == ids_.end()) {
+        it = ids_.emplace(std::string(record.identity), static_cast<uint32_t>(defined_.size())).first;
+        defined_.push_back(0);
+    }
+    const uint32_t id = it->second;
+
+    auto needed = [&] { return frame_size + (defined_[id] == generation_ ? 0 : identity_size); };
+    if (!map_ || used_ + needed() > map_size_)
+        open_segment(frame_size + identity_size);
+
+    auto write = [&](RecordKind kind, std::size_t size, std::string_view first, std::string_view second,
+                     auto&& fill) {
+        auto* p = reserve(size);
+        RecordHeader header{};
+        header.kind     = static_cast<uint8_t>(kind);
+        header.identity = id;
+        fill(header);
+        if (!first.empty())
+            std::memcpy(p + sizeof(RecordHeader), first.data(), first.size());
+        if (!second.empty())
+            std::memcpy(p + sizeof(RecordHeader) + first.size(), second.data(), second.size());
+        std::memcpy(p, &header, sizeof(header));   // size still 0
+        std::atomic_ref<uint32_t>(reinterpret_cast<RecordHeader*>(p)->size)
+            .store(static_cast<uint32_t>(size), std::memory_order_release);
+    };
+
+    if (defined_[id] != generation_) {
+        write(RecordKind::Identity, identity_size, record.identity, {}, [&](RecordHeader& h) {
+            h.payload_size = static_cast<uint32_t>(record.identity.size());
+        });
+        defined_[id] = generation_;
+    }
+
+    write(RecordKind::Frame, frame_size, unique_id, record.payload, [&](RecordHeader& h) {
+        h.direction      = static_cast<uint8_t>(record.direction);
+        h.type           = static_cast<uint8_t>(record.type);
+        h.action         = static_cast<uint8_t>(record.action);
+        h.unique_id_size = static_cast<uint16_t>(unique_id.size());
+        h.payload_size   = static_cast<uint32_t>(record.payload.size());
+        h.time           = to_micros(record.time);
+    });
+
+    auto* header = reinterpret_cast<FileHeader*>(map_);
+    if (header->first == 0)
+        std::atomic_ref<int64_t>(header->first).store(to_micros(record.time), std::memory_order_release);
+
+    ++counters_.records;
+    counters_.bytes += frame_size;
+}
+
+// ── Reader ──────────────────────────────────────────────────────────────────
+
+namespace
+{
+
+struct MappedSegment {
+    const std::byte* base = nullptr;
+    std::size_t      size = 0;
+    int64_t          first = 0;   // 0: no frame yet
+    int              pid = 0;
+
+    MappedSegment() = default;
+    MappedSegment(MappedSegment&& other) noexcept
+        : base(std::exchange(other.base, nullptr)), size(other.size), first(other.first), pid(other.pid)
+    {
+    }
+    MappedSegment& operator=(MappedSegment&&) = delete;
+
+    ~MappedSegment()
+    {
+        if (base)
+            ::munmap(const_cast<std::byte*>(base), size);
+    }
+};
+
+// Map @p file read-only; false if it is not a readable journal segment
+bool map_segment(const SegmentFile& file, MappedSegment& segment)
+{
+    int fd = ::open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st {};
+    void* map = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(FileHeader))
+        map = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    segment.base = static_cast<const std::byte*>(map);
+    segment.size = static_cast<std::size_t>(st.st_size);
+    segment.pid  = file.pid;
+
+    const auto* header = reinterpret_cast<const FileHeader*>(segment.base);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->header_size < sizeof(FileHeader) || header->header_size > segment.size)
+        return false;
+
+    segment.first = std::atomic_ref<int64_t>(const_cast<int64_t&>(header->first)).load(std::memory_order_acquire);
+    return true;
+}
+
+} // namespace
+
+TrafficJournal::ReadResult TrafficJournal::read(const std::string& dir, const Query& query,
+                                                const std::function<void(const Record&)>& visit)
+{
+    const int64_t from = query.from == time_point::min() ? INT64_MIN : to_micros(query.from);
+    const int64_t to   = query.to == time_point::max() ? INT64_MAX : to_micros(query.to);
+
+    std::vector<MappedSegment> segments;
+    {
+        const auto files = list_segments(dir);
+        segments.reserve(files.size());
+        for (const auto& file : files) {
+            if (!map_segment(file, segments.emplace_back()))
+                segments.pop_back();
+        }
+    }
+
+    // A segment ends where the next one of the same writer begins
+    std::vector<int64_t> ends(segments.size(), INT64_MAX);
+    std::unordered_map<int, std::size_t> last_of_pid;
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        auto [it, inserted] = last_of_pid.try_emplace(segments[i].pid, i);
+        if (!inserted) {
+            if (segments[i].first != 0)
+                ends[it->second] = segments[i].first;
+            it->second = i;
+        }
+    }
+
+    ReadResult result;
+    std::size_t scanned = 0;
+    for (std::size_t i = 0; i < segments.size() && result.complete; ++i) {
+        const auto& segment = segments[i];
+        if (segment.first == 0 || segment.first > to || ends[i] < from)
+            continue;
+
+        const auto* base = segment.base;
+        const auto  size = segment.size;
+        std::vector<std::string_view> identities;
+        std::size_t pos = reinterpret_cast<const FileHeader*>(base)->header_size;
+        while (pos + sizeof(RecordHeader) <= size) {
+            const auto* rh = reinterpret_cast<const RecordHeader*>(base + pos);
+            const uint32_t record_bytes = load_size(rh);
+            if (record_bytes < sizeof(RecordHeader) || record_bytes > size - pos)
+                break;   // end of data (or a torn tail)
+            if (record_bytes > query.max_scan - scanned) {
+                result.complete = false;
+                break;
+            }
+            scanned += record_bytes;
+
+            const auto* body = reinterpret_cast<const char*>(rh + 1);
+            if (sizeof(RecordHeader) + rh->unique_id_size + std::size_t{rh->payload_size} > record_bytes)
+                break;
+
+            if (rh->kind == static_cast<uint8_t>(RecordKind::Identity)) {
+                if (identities.size() <= rh->identity)
+                    identities.resize(rh->identity + 1);
+                identities[rh->identity] = std::string_view(body, rh->payload_size);
+            } else if (rh->kind == static_cast<uint8_t>(RecordKind::Frame) && rh->time >= from && rh->time <= to) {
+                const auto identity = rh->identity < identities.size() ? identities[rh->identity]
+                                                                       : std::string_view{};
+                if (query.identity.empty() || identity == query.identity) {
+                    Record record;
+                    record.time      = from_micros(rh->time);
+                    record.identity  = identity;
+                    record.direction = static_cast<LogDirection>(rh->direction);
+                    record.type      = static_cast<MessageType>(rh->type);
+                    record.action    = rh->action < kActionCount ? static_cast<Action>(rh->action)
+                                                                 : Action::Unknown;
+                    record.unique_id = std::string_view(body, rh->unique_id_size);
+                    record.payload   = std::string_view(body + rh->unique_id_size, rh->payload_size);
+                    visit(record);
+                    ++result.visited;
+                }
+            }
+            pos += record_bytes;
+        }
+    }
+
+    return result;
+}
+
+} // namespace ocpp
@@ -0,0 +1,139 @@
+#pragma once
+//
+// TrafficJournal — append-only binary journal of OCPP JSON frames.
+//
+// Records are copied into a memory-mapped segment file; nothing is formatted
+// and no system call is made per record, the kernel writes the pages back.
+// A segment's disk blocks are reserved when it is created, so a full disk
+// fails the rotation (std::system_error) rather than a later store into the
+// mapping; a new segment is started when a record does not fit, and a record
+// larger than a segment gets a segment of its own.
+// Beyond `segments` files in the directory the oldest are deleted.
+//
+// Segment file "journal-<created µs>-<pid>.ocj":
+//
+//   FileHeader   magic "OCPPJRN1", version, creation time, time of the
+//                first frame, writer pid
+//   records      8-byte aligned; a zero size marks the end of the data
+//
+// Each record is a RecordHeader followed by its body. A Frame record's body
+// is the uniqueId followed by the raw payload bytes; the station is an id
+// that an Identity record (body: the identity) defines earlier in the same
+// segment, so every segment can be read on its own. The size field is
+// published last, so a reader in another process never sees a partly
+// written record.
+//
+
+#include "ocpp/action.hpp"
+#include "ocpp/log_stream.hpp"
+#include "ocpp/protocol.hpp"
+#include "ocpp/string_map.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ocpp
+{
+
+class TrafficJournal
+{
+public:
+    using clock      = std::chrono::system_clock;
+    using time_point = clock::time_point;
+
+    struct Options {
+        std::string dir;
+        std::size_t segment_size = 64 * 1024 * 1024;
+        std::size_t segments = 16;   // files kept in `dir`, all writers together
+    };
+
+    struct Record {
+        time_point       time;
+        std::string_view identity;
+        LogDirection     direction = LogDirection::In;
+        MessageType      type = MessageType::Call;
+        Action           action = Action::Unknown;
+        std::string_view unique_id;
+        std::string_view payload;
+    };
+
+    struct Query {
+        time_point  from = time_point::min();
+        time_point  to = time_point::max();
+        std::string identity;   // empty: any
+        std::size_t max_scan = SIZE_MAX;   // record bytes examined at most
+    };
+
+    struct ReadResult {
+        std::size_t visited = 0;
+        bool        complete = true;   // false: stopped at max_scan
+    };
+
+    struct Counters {
+        uint64_t records = 0;
+        uint64_t bytes = 0;
+        uint64_t segments = 0;  // segments started
+        uint64_t dropped = 0;   // records too large to journal
+    };
+
+    explicit TrafficJournal(Options options);
+    ~TrafficJournal();
+
+    TrafficJournal(const TrafficJournal&) = delete;
+    TrafficJournal& operator=(const TrafficJournal&) = delete;
+
+    /// Append one frame. Throws std::system_error if a segment cannot be created.
+    void append(const Record& record);
+
+    /// Unmap the current segment; the next append() starts a new one.
+    void close();
+
+    const Counters& counters() const { return counters_; }
+
+    /// Call @p visit for every record in @p dir matching @p query, segment by
+    /// segment (oldest first); the views are valid during the call only.
+    /// Unreadable or foreign files are skipped. Segments outside the time
+    /// range are not scanned; the rest stop after `max_scan` bytes.
+    static ReadResult read(const std::string& dir, const Query& query,
+                           const std::function<void(const Record&)>& visit);
+
+private:
+    void open_segment(std::size_t min_size);
+    void prune();
+    std::byte* reserve(std::size_t size);
+
+    Options               options_;
+    std::byte*            map_ = nullptr;
+    std::size_t           map_size_ = 0;
+    std::size_t           used_ = 0;
+    std::string           path_;
+
+    // Identity ids are stable for the writer; an id is (re)defined in each
+    // segment it is used in: defined_[id] == generation_.
+    StringMap<uint32_t>   ids_;
+    std::vector<uint64_t> defined_;
+    uint64_t              generation_ = 0;
+
+    Counters              counters_;
+};
+
+/// The /ws/log entry for a journal record.
+inline LogEvent to_log_event(const TrafficJournal::Record& record)
+{
+    LogEvent event;
+    event.identity  = record.identity;
+    event.direction = record.direction;
+    event.type      = record.type;
+    event.unique_id = record.unique_id;
+    event.action    = action_name(record.action);
+    event.payload   = record.payload;
+    event.time      = record.time;
+    return event;
+}
+
+} // namespace ocpp
@@ -0,0 +1,285 @@
+#include "ocpp/worker_directory.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ocpp
+{
+
+// One cache line pair per slot. `hash` is claimed first (0 -> hash), then the
+// identity is copied and published by a release store of `length`. `owner`
+// packs (master pid << 32 | worker pid) so both change in one atomic store.
+struct alignas(64) WorkerDirectory::Slot {
+    uint64_t hash;
+    uint64_t owner;
+    uint16_t length;
+    char     identity[kMaxIdentity];
+};
+
+// Worker table at the start of the segment, one owner_tag() per entry.
+struct alignas(64) WorkerDirectory::Header {
+    uint64_t workers[kMaxWorkers];
+};
+
+namespace
+{
+
+uint64_t identity_hash(std::string_view identity)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : identity) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h ? h : 1;
+}
+
+bool alive(pid_t pid)
+{
+    return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+} // namespace
+
+WorkerDirectory::~WorkerDirectory()
+{
+    close();
+}
+
+void WorkerDirectory::create(const std::string& name, std::size_t capacity)
+{
+    // A new name, not a truncation: workers of a previous master that still
+    // map the old segment keep it to themselves
+    ::shm_unlink(name.c_str());
+
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("shm_open({}) failed: {}", name, std::strerror(errno)));
+
+    const auto size = sizeof(Header) + std::max<std::size_t>(capacity, 1) * sizeof(Slot);
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        int err = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error(fmt::format("ftruncate({}) failed: {}", name, std::strerror(err)));
+    }
+    ::close(fd);
+}
+
+void WorkerDirectory::open(const std::string& name, std::size_t capacity, pid_t master)
+{
+    close();
+
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("shm_open({}) failed: {}", name, std::strerror(errno)));
+
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size == 0) {
+        // Zero-filled memory is a valid empty table, no further init needed.
+        // Workers racing here truncate to the same size.
+        if (::ftruncate(fd, static_cast<off_t>(sizeof(Header) + capacity * sizeof(Slot))) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error(fmt::format("ftruncate({}) failed: {}", name, std::strerror(err)));
+        }
+    }
+
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header) + sizeof(Slot))) {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("shared memory {} has invalid size", name));
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (p == MAP_FAILED)
+        throw std::runtime_error(fmt::format("mmap({}) failed: {}", name, std::strerror(errno)));
+
+    header_   = static_cast<Header*>(p);
+    slots_    = reinterpret_cast<Slot*>(header_ + 1);
+    capacity_ = (size_ - sizeof(Header)) / sizeof(Slot);
+    master_   = master;
+}
+
+void WorkerDirectory::close()
+{
+    if (slots_) {
+        ::munmap(header_, size_);
+        header_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+    }
+}
+
+void WorkerDirectory::unlink(const std::string& name)
+{
+    ::shm_unlink(name.c_str());
+}
+
+uint64_t WorkerDirectory::owner_tag(pid_t pid) const
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(master_)) << 32) | static_cast<uint32_t>(pid);
+}
+
+WorkerDirectory::Slot* WorkerDirectory::find(std::string_view identity, bool create) const
+{
+    if (!slots_ || identity.empty() || identity.size() > kMaxIdentity)
+        return nullptr;
+
+    const uint64_t h = identity_hash(identity);
+
+    for (std::size_t i = 0, idx = h % capacity_; i < capacity_; ++i, idx = (idx + 1) % capacity_) {
+        Slot& slot = slots_[idx];
+        std::atomic_ref<uint64_t> slot_hash(slot.hash);
+
+        uint64_t current = slot_hash.load(std::memory_order_acquire);
+
+        if (current == 0) {
+            if (!create)
+                return nullptr;
+
+            if (slot_hash.compare_exchange_strong(current, h, std::memory_order_acq_rel)) {
+                std::memcpy(slot.identity, identity.data(), identity.size());
+                std::atomic_ref<uint16_t>(slot.length).store(
+                    static_cast<uint16_t>(identity.size()), std::memory_order_release);
+                return &slot;
+            }
+            // Lost the race: `current` now holds the winner's hash, fall through.
+        }
+
+        if (current != h)
+            continue;
+
+        // Same hash: wait for the claimer to publish the identity, then compare.
+        std::atomic_ref<uint16_t> length(slot.length);
+        uint16_t len = length.load(std::memory_order_acquire);
+        for (int spin = 0; len == 0 && spin < 1000; ++spin) {
+            std::this_thread::yield();
+            len = length.load(std::memory_order_acquire);
+        }
+
+        if (len == identity.size() && std::memcmp(slot.identity, identity.data(), len) == 0)
+            return &slot;
+    }
+
+    return nullptr;
+}
+
+bool WorkerDirectory::claim(std::string_view identity, pid_t pid)
+{
+    Slot* slot = find(identity, true);
+    if (!slot)
+        return false;
+
+    std::atomic_ref<uint64_t>(slot->owner).store(owner_tag(pid), std::memory_order_release);
+    return true;
+}
+
+void WorkerDirectory::release(std::string_view identity, pid_t pid)
+{
+    Slot* slot = find(identity, false);
+    if (!slot)
+        return;
+
+    uint64_t expected = owner_tag(pid);
+    std::atomic_ref<uint64_t>(slot->owner).compare_exchange_strong(
+        expected, 0, std::memory_order_acq_rel);
+}
+
+pid_t WorkerDirectory::owner(std::string_view identity) const
+{
+    Slot* slot = find(identity, false);
+    if (!slot)
+        return 0;
+
+    uint64_t tag = std::atomic_ref<uint64_t>(slot->owner).load(std::memory_order_acquire);
+    if (tag == 0 || static_cast<pid_t>(tag >> 32) != master_)
+        return 0;
+
+    auto pid = static_cast<pid_t>(tag & 0xffffffffu);
+    return alive(pid) ? pid : 0;
+}
+
+std::vector<pid_t> WorkerDirectory::owners() const
+{
+    std::vector<pid_t> result;
+
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        uint64_t tag = std::atomic_ref<uint64_t>(slots_[i].owner).load(std::memory_order_acquire);
+        if (tag == 0 || static_cast<pid_t>(tag >> 32) != master_)
+            continue;
+
+        auto pid = static_cast<pid_t>(tag & 0xffffffffu);
+        if (std::find(result.begin(), result.end(), pid) == result.end())
+            result.push_back(pid);
+    }
+
+    std::erase_if(result, [](pid_t pid) { return !alive(pid); });
+    return result;
+}
+
+bool WorkerDirectory::join(pid_t pid)
+{
+    if (!header_)
+        return false;
+
+    const uint64_t tag = owner_tag(pid);
+    for (auto& entry : header_->workers) {
+        std::atomic_ref<uint64_t> worker(entry);
+        uint64_t current = worker.load(std::memory_order_acquire);
+        if (current == tag)
+            return true;
+
+        const bool stale = current == 0 || static_cast<pid_t>(current >> 32) != master_ ||
+                           !alive(static_cast<pid_t>(current & 0xffffffffu));
+        if (stale && worker.compare_exchange_strong(current, tag, std::memory_order_acq_rel))
+            return true;
+    }
+    return false;
+}
+
+void WorkerDirectory::leave(pid_t pid)
+{
+    if (!header_)
+        return;
+
+    for (auto& entry : header_->workers) {
+        uint64_t expected = owner_tag(pid);
+        std::atomic_ref<uint64_t>(entry).compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+    }
+}
+
+std::vector<pid_t> WorkerDirectory::workers() const
+{
+    std::vector<pid_t> result;
+    if (!header_)
+        return result;
+
+    for (auto& entry : header_->workers) {
+        uint64_t tag = std::atomic_ref<uint64_t>(entry).load(std::memory_order_acquire);
+        if (tag == 0 || static_cast<pid_t>(tag >> 32) != master_)
+            continue;
+
+        auto pid = static_cast<pid_t>(tag & 0xffffffffu);
+        if (alive(pid) && std::find(result.begin(), result.end(), pid) == result.end())
+            result.push_back(pid);
+    }
+    return result;
+}
+
+} // namespace ocpp
@@ -0,0 +1,94 @@
+#pragma once
+//
+// WorkerDirectory — shared-memory map: station identity -> owning worker pid.
+//
+// All workers of one master map the same POSIX shared memory segment. Each
+// slot holds an identity and its owner; ownership is taken and released with
+// atomic operations, so workers never share a lock. Slots are never freed —
+// a released identity keeps its slot (owner 0) and reuses it on the next
+// connect, so the table only has to be sized for the number of stations.
+//
+// Ahead of the slots, a small table lists the workers themselves (whether or
+// not they own a station), so a notice can reach every one of them.
+//
+// The master creates the segment afresh (create()) before it forks the
+// workers and removes it when it exits, so the size always follows the
+// configured capacity. Entries written under another master pid and entries
+// whose worker has exited are treated as unowned.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace ocpp
+{
+
+class WorkerDirectory
+{
+public:
+    static constexpr std::size_t kMaxIdentity = 110;
+    static constexpr std::size_t kMaxWorkers = 256;
+
+    WorkerDirectory() = default;
+    ~WorkerDirectory();
+
+    WorkerDirectory(const WorkerDirectory&) = delete;
+    WorkerDirectory& operator=(const WorkerDirectory&) = delete;
+
+    // Replace the segment @p name with an empty one for @p capacity
+    // identities. Throws std::runtime_error on failure.
+    static void create(const std::string& name, std::size_t capacity);
+
+    // Map (creating if needed) the segment @p name (e.g. "/cs.directory").
+    // @p capacity is only used when the segment is created. Throws
+    // std::runtime_error on failure.
+    void open(const std::string& name, std::size_t capacity, pid_t master);
+    void close();
+
+    bool is_open() const { return slots_ != nullptr; }
+    std::size_t capacity() const { return capacity_; }
+
+    // Record @p pid as owner of @p identity. Returns false if the identity is
+    // too long or the table is full.
+    bool claim(std::string_view identity, pid_t pid);
+
+    // Clear ownership of @p identity, only if it is still owned by @p pid.
+    void release(std::string_view identity, pid_t pid);
+
+    // Owner of @p identity, or 0 if unknown, released or no longer alive.
+    pid_t owner(std::string_view identity) const;
+
+    // Distinct live workers that own at least one identity.
+    std::vector<pid_t> owners() const;
+
+    // Register @p pid as a live worker; an entry left by an exited worker or
+    // another master is reused. Returns false if the worker table is full.
+    bool join(pid_t pid);
+    void leave(pid_t pid);
+
+    // Live workers that joined under this master.
+    std::vector<pid_t> workers() const;
+
+    // Remove the segment name (mapped instances stay valid).
+    static void unlink(const std::string& name);
+
+private:
+    struct Slot;
+    struct Header;
+
+    Slot* find(std::string_view identity, bool create) const;
+    uint64_t owner_tag(pid_t pid) const;
+
+    Header*     header_ = nullptr;
+    Slot*       slots_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    pid_t       master_ = 0;
+};
+
+} // namespace ocpp
@@ -0,0 +1,465 @@
+//
+// ocpp_schemagen — compiles OCPP JSON schemas into C++ validation functions.
+//
+// Usage: ocpp_schemagen <output.cpp> <version>=<schema.json> [...]
+//
+//   version   "1.6" or "2.0.1"
+//   schema    "{Action}.json" (1.6 request), "{Action}Request.json" or
+//             "{Action}Response.json"
+//
+// The generated source defines ocpp::find_compiled_schema() (see
+// src/ocpp/compiled_schemas.hpp). Only the keywords used by the OCPP schemas
+// are supported; anything else is a generation error, so a schema change that
+// the generator cannot express fails the build instead of being skipped.
+// "format" is an annotation here, like in json_validator without a format
+// checker.
+//
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace
+{
+
+// Must match ocpp::schema_hash() (src/ocpp/compiled_schemas.cpp)
+uint64_t schema_hash(const json& schema)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : schema.dump()) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// C++ string literal for @p s (octal escapes, so no digit can extend them)
+std::string literal(std::string_view s)
+{
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20 || c >= 0x7f) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\%03o", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+    return out;
+}
+
+const std::set<std::string, std::less<>> kAnnotations = {
+    "$schema", "$id", "id", "title", "description", "comment", "$comment",
+    "javaType", "default", "format", "definitions", "$defs",
+};
+
+const std::set<std::string, std::less<>> kKeywords = {
+    "$ref", "type", "enum",
+    "properties", "required", "additionalProperties",
+    "items", "additionalItems", "minItems", "maxItems",
+    "minLength", "maxLength",
+};
+
+class Generator
+{
+public:
+    explicit Generator(std::string prefix, const json& root)
+        : prefix_(std::move(prefix)), root_(root) {}
+
+    // Emit the functions for the schema root; returns the entry function name.
+    std::string generate() { return node(root_, "#"); }
+
+    const std::string& declarations() const { return declarations_; }
+    const std::string& definitions() const { return definitions_; }
+
+private:
+    [[noreturn]] static void unsupported(std::string_view where, std::string_view what)
+    {
+        throw std::runtime_error(std::string(where) + ": unsupported " + std::string(what));
+    }
+
+    std::string declare()
+    {
+        auto name = prefix_ + "_" + std::to_string(next_++);
+        declarations_ += "void " + name + "(const nlohmann::json& j, const Path* path);\n";
+        return name;
+    }
+
+    std::string ref(const std::string& target, std::string_view where)
+    {
+        if (auto it = refs_.find(target); it != refs_.end())
+            return it->second;
+
+        if (!target.starts_with("#/"))
+            unsupported(where, "$ref " + target);
+
+        const json* schema = &root_;
+        try {
+            schema = &root_.at(json::json_pointer(target.substr(1)));
+        } catch (const std::exception&) {
+            throw std::runtime_error(std::string(where) + ": unresolved $ref " + target);
+        }
+
+        // Register first: a definition may refer to itself
+        auto name = declare();
+        refs_.emplace(target, name);
+        emit(name, *schema, target);
+        return name;
+    }
+
+    std::string node(const json& schema, const std::string& where)
+    {
+        if (schema.is_object() && schema.contains("$ref")) {
+            for (const auto& [key, value] : schema.items())
+                if (key != "$ref" && !kAnnotations.contains(key))
+                    unsupported(where, "keyword '" + key + "' next to $ref");
+            return ref(schema["$ref"].get<std::string>(), where);
+        }
+
+        auto name = declare();
+        emit(name, schema, where);
+        return name;
+    }
+
+    void emit(const std::string& name, const json& schema, const std::string& where)
+    {
+        std::string body;
+
+        if (schema.is_boolean()) {
+            if (!schema.get<bool>())
+                body += "    fail(path, j, \"instance invalid as per false-schema\");\n";
+        } else if (!schema.is_object()) {
+            unsupported(where, "schema type");
+        } else {
+            for (const auto& [key, value] : schema.items())
+                if (!kKeywords.contains(key) && !kAnnotations.contains(key))
+                    unsupported(where, "keyword '" + key + "'");
+
+            body = emit_typed(schema, where);
+        }
+
+        definitions_ += "void " + name + "(const nlohmann::json& j, const Path* path)\n{\n";
+        definitions_ += body.empty() ? "    (void) j;\n    (void) path;\n" : body;
+        definitions_ += "}\n\n";
+    }
+
+    std::string emit_typed(const json& schema, const std::string& where)
+    {
+        if (!schema.contains("type"))
+            unsupported(where, "schema without \"type\"");
+        if (!schema["type"].is_string())
+            unsupported(where, "\"type\" list");
+
+        const auto type = schema["type"].get<std::string>();
+        std::string body;
+
+        // json_validator: type-specific checks first, then "enum"
+        if (type == "object") {
+            body += "    if (!j.is_object()) fail(path, j, \"unexpected instance type\");\n";
+            body += emit_object(schema, where);
+        } else if (type == "array") {
+            body += "    if (!j.is_array()) fail(path, j, \"unexpected instance type\");\n";
+            body += emit_array(schema, where);
+        } else if (type == "string") {
+            body += "    if (!j.is_string()) fail(path, j, \"unexpected instance type\");\n";
+            body += emit_string(schema);
+        } else if (type == "integer") {
+            body += "    if (!j.is_number_integer()) fail(path, j, \"unexpected instance type\");\n";
+        } else if (type == "number") {
+            body += "    if (!j.is_number()) fail(path, j, \"unexpected instance type\");\n";
+        } else if (type == "boolean") {
+            body += "    if (!j.is_boolean()) fail(path, j, \"unexpected instance type\");\n";
+        } else if (type == "null") {
+            body += "    if (!j.is_null()) fail(path, j, \"unexpected instance type\");\n";
+        } else {
+            unsupported(where, "type '" + type + "'");
+        }
+
+        if (schema.contains("enum"))
+            body += emit_enum(schema["enum"], type);
+
+        return body;
+    }
+
+    std::string emit_object(const json& schema, const std::string& where)
+    {
+        std::string body;
+
+        if (schema.contains("required")) {
+            for (const auto& r : schema["required"]) {
+                auto key = r.get<std::string>();
+                body += "    if (!j.contains(" + literal(key) + "))\n";
+                body += "        fail(path, j, " + literal("required property '" + key + "' not found in object") + ");\n";
+            }
+        }
+
+        bool closed = false;
+        if (schema.contains("additionalProperties")) {
+            const auto& ap = schema["additionalProperties"];
+            if (ap.is_boolean())
+                closed = !ap.get<bool>();
+            else if (!(ap.is_object() && ap.empty()))
+                unsupported(where, "additionalProperties schema");
+        }
+
+        std::vector<std::pair<std::string, std::string>> properties;  // key -> function
+        if (schema.contains("properties")) {
+            for (const auto& [key, value] : schema["properties"].items())
+                properties.emplace_back(key, node(value, where + "/properties/" + key));
+        }
+
+        if (properties.empty() && !closed)
+            return body;
+
+        body += "    for (auto it = j.begin(); it != j.end(); ++it) {\n";
+        body += "        const std::string_view key = it.key();\n";
+
+        bool first = true;
+        for (const auto& [key, fn] : properties) {
+            body += first ? "        if" : "        else if";
+            body += " (key == " + literal(key) + "sv) {\n";
+            body += "            const Path child{path, key};\n";
+            body += "            " + fn + "(*it, &child);\n";
+            body += "        }\n";
+            first = false;
+        }
+
+        if (closed) {
+            body += first ? "        " : "        else\n            ";
+            body += "fail(path, j, \"validation failed for additional property '\" + std::string(key) + "
+                    "\"': instance invalid as per false-schema\");\n";
+        }
+
+        body += "    }\n";
+        return body;
+    }
+
+    std::string emit_array(const json& schema, const std::string& where)
+    {
+        std::string body;
+
+        if (schema.contains("maxItems"))
+            body += "    if (j.size() > " + std::to_string(schema["maxItems"].get<std::size_t>()) +
+                    "u) fail(path, j, \"array has too many items\");\n";
+
+        if (schema.contains("minItems"))
+            body += "    if (j.size() < " + std::to_string(schema["minItems"].get<std::size_t>()) +
+                    "u) fail(path, j, \"array has too few items\");\n";
+
+        if (schema.contains("items")) {
+            // additionalItems only applies to a list of item schemas
+            if (!schema["items"].is_object() && !schema["items"].is_boolean())
+                unsupported(where, "items list");
+
+            auto fn = node(schema["items"], where + "/items");
+            body += "    for (std::size_t i = 0; i < j.size(); ++i) {\n";
+            body += "        const Path child{path, i};\n";
+            body += "        " + fn + "(j[i], &child);\n";
+            body += "    }\n";
+        }
+
+        return body;
+    }
+
+    static std::string emit_string(const json& schema)
+    {
+        std::string body;
+
+        if (schema.contains("minLength")) {
+            auto n = std::to_string(schema["minLength"].get<std::size_t>());
+            body += "    if (utf8_length(j.get_ref<const std::string&>()) < " + n + "u)\n";
+            body += "        fail(path, j, \"instance is too short as per minLength:" + n + "\");\n";
+        }
+
+        if (schema.contains("maxLength")) {
+            auto n = std::to_string(schema["maxLength"].get<std::size_t>());
+            body += "    if (utf8_length(j.get_ref<const std::string&>()) > " + n + "u)\n";
+            body += "        fail(path, j, \"instance is too long as per maxLength: " + n + "\");\n";
+        }
+
+        return body;
+    }
+
+    std::string emit_enum(const json& values, const std::string& type)
+    {
+        bool all_strings = type == "string";
+        for (const auto& v : values)
+            all_strings = all_strings && v.is_string();
+
+        std::string body;
+        if (all_strings) {
+            body += "    {\n";
+            body += "        const std::string_view s = j.get_ref<const std::string&>();\n";
+            body += "        if (";
+            bool first = true;
+            for (const auto& v : values) {
+                if (!first) body += " &&\n            ";
+                body += "s != " + literal(v.get<std::string>()) + "sv";
+                first = false;
+            }
+            body += ")\n";
+            body += "            fail(path, j, \"instance not found in required enum\");\n";
+            body += "    }\n";
+        } else {
+            auto name = prefix_ + "_enum_" + std::to_string(next_++);
+            declarations_ += "const nlohmann::json " + name + " = nlohmann::json::parse(" +
+                             literal(values.dump()) + ");\n";
+            body += "    {\n";
+            body += "        bool found = false;\n";
+            body += "        for (const auto& v : " + name + ")\n";
+            body += "            found = found || v == j;\n";
+            body += "        if (!found) fail(path, j, \"instance not found in required enum\");\n";
+            body += "    }\n";
+        }
+        return body;
+    }
+
+    std::string prefix_;
+    const json& root_;
+    int next_ = 0;
+    std::map<std::string, std::string> refs_;
+    std::string declarations_;
+    std::string definitions_;
+};
+
+struct Input {
+    std::string version;     // "V16" / "V201"
+    std::string action;
+    std::string direction;   // "Request" / "Response"
+    std::string path;
+};
+
+Input parse_argument(std::string_view arg)
+{
+    auto eq = arg.find('=');
+    if (eq == std::string_view::npos)
+        throw std::runtime_error("expected <version>=<schema.json>: " + std::string(arg));
+
+    Input in;
+    auto version = arg.substr(0, eq);
+    if (version == "1.6")        in.version = "V16";
+    else if (version == "2.0.1") in.version = "V201";
+    else throw std::runtime_error("unknown OCPP version: " + std::string(version));
+
+    in.path = std::string(arg.substr(eq + 1));
+
+    std::string_view stem = in.path;
+    if (auto slash = stem.find_last_of('/'); slash != std::string_view::npos)
+        stem.remove_prefix(slash + 1);
+    if (!stem.ends_with(".json"))
+        throw std::runtime_error("not a .json schema: " + in.path);
+    stem.remove_suffix(5);
+
+    in.direction = "Request";
+    if (stem.ends_with("Response")) {
+        stem.remove_suffix(8);
+        in.direction = "Response";
+    } else if (stem.ends_with("Request")) {
+        stem.remove_suffix(7);
+    }
+
+    in.action = std::string(stem);
+    return in;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <output.cpp> <version>=<schema.json>...\n";
+        return 2;
+    }
+
+    try {
+        std::string declarations;
+        std::string definitions;
+        std::string table;
+
+        for (int i = 2; i < argc; ++i) {
+            auto in = parse_argument(argv[i]);
+
+            std::ifstream f(in.path);
+            if (!f.is_open())
+                throw std::runtime_error("cannot open " + in.path);
+            auto schema = json::parse(f);
+
+            Generator gen(in.version + "_" + in.action + "_" + in.direction, schema);
+            std::string entry;
+            try {
+                entry = gen.generate();
+            } catch (const std::exception& e) {
+                throw std::runtime_error(in.path + ": " + e.what());
+            }
+
+            declarations += "\n// " + in.path + "\n" + gen.declarations();
+            definitions += gen.definitions();
+
+            char hash[32];
+            std::snprintf(hash, sizeof(hash), "0x%016llxull",
+                          static_cast<unsigned long long>(schema_hash(schema)));
+
+            table += "        {OcppVersion::" + in.version + ", Action::" + in.action +
+                     ", SchemaDirection::" + in.direction + ", {" + hash + ", " + entry + "}},\n";
+        }
+
+        std::ostringstream out;
+        out << "// Generated by ocpp_schemagen from conf/schemas. Do not edit.\n\n"
+            << "#include \"ocpp/compiled_schemas.hpp\"\n\n"
+            << "namespace ocpp\n{\n\n"
+            << "namespace\n{\n\n"
+            << "using schema_detail::Path;\n"
+            << "using schema_detail::fail;\n"
+            << "using schema_detail::utf8_length;\n"
+            << "using namespace std::string_view_literals;\n"
+            << declarations << "\n"
+            << definitions
+            << "} // namespace\n\n"
+            << "const CompiledSchema* find_compiled_schema(OcppVersion version, Action action,\n"
+            << "                                           SchemaDirection direction)\n{\n"
+            << "    struct Entry {\n"
+            << "        OcppVersion     version;\n"
+            << "        Action          action;\n"
+            << "        SchemaDirection direction;\n"
+            << "        CompiledSchema  schema;\n"
+            << "    };\n\n"
+            << "    static const Entry entries[] = {\n"
+            << table
+            << "    };\n\n"
+            << "    for (const auto& e : entries)\n"
+            << "        if (e.version == version && e.action == action && e.direction == direction)\n"
+            << "            return &e.schema;\n\n"
+            << "    return nullptr;\n"
+            << "}\n\n"
+            << "} // namespace ocpp\n";
+
+        std::string text = out.str();
+
+        std::ofstream f(argv[1], std::ios::trunc);
+        if (!f.is_open())
+            throw std::runtime_error(std::string("cannot write ") + argv[1]);
+        f << text;
+    } catch (const std::exception& e) {
+        std::cerr << "ocpp_schemagen: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/admission_controller.hpp"
+
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace ocpp;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+AdmissionController::Options options()
+{
+    AdmissionController::Options o;
+    o.upgrade_rate    = 100.0;
+    o.upgrade_burst   = 50;
+    o.boot_in_flight  = 20;
+    o.queue_threshold = 200;
+    o.pending_min     = 10s;
+    o.pending_max     = 60s;
+    return o;
+}
+
+const AdmissionController::time_point t0{};
+
+} // namespace
+
+TEST_CASE("AdmissionController: token bucket on upgrades", "[ocpp][admission]")
+{
+    AdmissionController admission(options(), 1);
+
+    for (int i = 0; i < 50; ++i)
+        REQUIRE(admission.admit_upgrade(t0));      // the burst
+    REQUIRE_FALSE(admission.admit_upgrade(t0));
+
+    REQUIRE_FALSE(admission.admit_upgrade(t0 + 5ms));
+    REQUIRE(admission.admit_upgrade(t0 + 10ms));   // 100/s: one token per 10 ms
+    REQUIRE_FALSE(admission.admit_upgrade(t0 + 10ms));
+
+    // Refills up to the burst, not beyond
+    int admitted = 0;
+    while (admission.admit_upgrade(t0 + 100s)) ++admitted;
+    REQUIRE(admitted == 50);
+
+    REQUIRE(admission.stats().upgrades_admitted == 101);
+    REQUIRE(admission.stats().upgrades_rejected == 4);
+}
+
+TEST_CASE("AdmissionController: boots are capped in flight and by queue depth", "[ocpp][admission]")
+{
+    AdmissionController admission(options(), 1);
+
+    for (int i = 0; i < 20; ++i)
+        REQUIRE(admission.admit_boot(0));
+    REQUIRE_FALSE(admission.admit_boot(0));
+    REQUIRE(admission.boots_in_flight() == 20);
+
+    admission.boot_finished();
+    REQUIRE_FALSE(admission.admit_boot(200));      // backend queue too deep
+    REQUIRE(admission.admit_boot(199));
+
+    for (int i = 0; i < 100; ++i) {
+        auto interval = admission.pending_interval();
+        REQUIRE(interval >= 10s);
+        REQUIRE(interval <= 60s);
+    }
+
+    REQUIRE(admission.stats().boots_admitted == 21);
+    REQUIRE(admission.stats().boots_pending == 2);
+}
+
+// 10k stations reconnect at once. Refused upgrades retry after 1-5 s; an
+// admitted station sends BootNotification, which the backend answers within
+// 50 ms, and retries after the Pending interval when refused. The simulation
+// runs in 10 ms steps until every station is Accepted.
+TEST_CASE("AdmissionController: replay of a 10k-station reconnect storm", "[ocpp][admission]")
+{
+    constexpr int kStations = 10000;
+    constexpr auto kStep = 10ms;
+
+    AdmissionController admission(options(), 42);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> backoff_ms(1000, 5000);
+
+    enum class Phase { Connecting, Booting, Accepted };
+    struct Station {
+        Phase                           phase = Phase::Connecting;
+        AdmissionController::time_point retry_at = t0;
+    };
+    std::vector<Station> stations(kStations);
+
+    std::deque<AdmissionController::time_point> backend;   // boots in flight, by answer time
+    std::map<int64_t, int> upgrades_per_second;
+    std::size_t max_in_flight = 0;
+    int accepted = 0;
+
+    auto now = t0;
+    for (; accepted < kStations && now < t0 + 3600s; now += kStep) {
+        // Backend answers: the boot is Accepted
+        while (!backend.empty() && backend.front() <= now) {
+            backend.pop_front();
+            admission.boot_finished();
+        }
+
+        for (auto& station : stations) {
+            if (station.phase == Phase::Accepted || station.retry_at > now)
+                continue;
+
+            if (station.phase == Phase::Connecting) {
+                if (!admission.admit_upgrade(now)) {
+                    station.retry_at = now + std::chrono::milliseconds(backoff_ms(rng));
+                    continue;
+                }
+                ++upgrades_per_second[std::chrono::duration_cast<std::chrono::seconds>(now - t0).count()];
+                station.phase = Phase::Booting;
+            }
+
+            if (admission.admit_boot(backend.size())) {
+                backend.push_back(now + 50ms);
+                station.phase = Phase::Accepted;
+                ++accepted;
+            } else {
+                station.retry_at = now + admission.pending_interval();
+            }
+            max_in_flight = std::max(max_in_flight, admission.boots_in_flight());
+        }
+    }
+
+    REQUIRE(accepted == kStations);
+    REQUIRE(max_in_flight <= 20);
+
+    // No second admits more than the rate plus a refilled burst
+    for (const auto& [second, count] : upgrades_per_second)
+        REQUIRE(count <= 150);
+
+    const auto& stats = admission.stats();
+    REQUIRE(stats.upgrades_admitted == kStations);
+    REQUIRE(stats.upgrades_rejected > 0);
+    REQUIRE(stats.boots_admitted == kStations);
+    REQUIRE(stats.boots_pending > 0);
+
+    // At 100 upgrades per second the storm drains in about 100 s
+    REQUIRE(now - t0 < 200s);
+}
@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/authorization_cache.hpp"
+#include "ocpp/time_utils.hpp"
+
+using namespace ocpp;
+using namespace std::chrono_literals;
+using json = nlohmann::json;
+
+namespace
+{
+
+const auto t0 = AuthorizationCache::time_point(std::chrono::seconds(1704067200));  // 2024-01-01T00:00:00Z
+
+AuthorizationCache::Options options(std::size_t capacity = 3)
+{
+    AuthorizationCache::Options o;
+    o.capacity = capacity;
+    o.ttl      = 60s;
+    return o;
+}
+
+const json accepted = {{"status", "Accepted"}};
+
+} // namespace
+
+TEST_CASE("AuthorizationCache: keeps Accepted results for the TTL", "[ocpp][authcache]")
+{
+    AuthorizationCache cache(options());
+    const auto key = AuthorizationCache::make_key("1.6", "AC0001", "RFID-1");
+
+    REQUIRE(cache.find(key, t0) == nullptr);
+
+    cache.store(key, "RFID-1", accepted, t0);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.find(key, t0 + 59s));
+    REQUIRE(*cache.find(key, t0 + 59s) == accepted);
+
+    // Scoped by account and version
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "AC0002", "RFID-1"), t0) == nullptr);
+    REQUIRE(cache.find(AuthorizationCache::make_key("2.0.1", "AC0001", "RFID-1"), t0) == nullptr);
+
+    REQUIRE(cache.find(key, t0 + 60s) == nullptr);
+    REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("AuthorizationCache: other statuses evict the entry", "[ocpp][authcache]")
+{
+    AuthorizationCache cache(options());
+    const auto key = AuthorizationCache::make_key("1.6", "", "RFID-1");
+
+    cache.store(key, "RFID-1", accepted, t0);
+    cache.store(key, "RFID-1", {{"status", "Blocked"}}, t0 + 1s);
+    REQUIRE(cache.find(key, t0 + 1s) == nullptr);
+
+    cache.store(key, "RFID-1", json::object(), t0);
+    REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("AuthorizationCache: accounts answer the same token independently", "[ocpp][authcache]")
+{
+    AuthorizationCache cache(options());
+    const auto a = AuthorizationCache::make_key("1.6", "AC0001", "RFID-1");
+    const auto b = AuthorizationCache::make_key("1.6", "AC0002", "RFID-1");
+    const json group = {{"status", "Accepted"}, {"parentIdTag", "FLEET-1"}};
+
+    cache.store(a, "RFID-1", accepted, t0);
+    cache.store(b, "RFID-1", group, t0);
+    REQUIRE(*cache.find(a, t0) == accepted);
+    REQUIRE(*cache.find(b, t0) == group);
+
+    // A refusal in one account leaves the other account's answer alone
+    cache.store(b, "RFID-1", {{"status", "Blocked"}}, t0 + 1s);
+    REQUIRE(cache.find(b, t0 + 1s) == nullptr);
+    REQUIRE(*cache.find(a, t0 + 1s) == accepted);
+}
+
+TEST_CASE("AuthorizationCache: honours expiryDate and cacheExpiryDateTime", "[ocpp][authcache]")
+{
+    AuthorizationCache cache(options());
+    const auto k16  = AuthorizationCache::make_key("1.6", "", "A");
+    const auto k201 = AuthorizationCache::make_key("2.0.1", "", "B");
+    const auto k_late = AuthorizationCache::make_key("1.6", "", "C");
+
+    cache.store(k16, "A", {{"status", "Accepted"}, {"expiryDate", "2024-01-01T00:00:10.000Z"}}, t0);
+    cache.store(k201, "B", {{"status", "Accepted"}, {"cacheExpiryDateTime", "2024-01-01T00:00:20Z"}}, t0);
+    cache.store(k_late, "C", {{"status", "Accepted"}, {"expiryDate", "2030-01-01T00:00:00Z"}}, t0);
+
+    REQUIRE(cache.find(k16, t0 + 9s));
+    REQUIRE(cache.find(k16, t0 + 10s) == nullptr);
+    REQUIRE(cache.find(k201, t0 + 19s));
+    REQUIRE(cache.find(k201, t0 + 20s) == nullptr);
+    REQUIRE(cache.find(k_late, t0 + 59s));             // the TTL still applies
+    REQUIRE(cache.find(k_late, t0 + 60s) == nullptr);
+
+    // Already expired: not stored
+    cache.store(k16, "A", {{"status", "Accepted"}, {"expiryDate", "2023-12-31T23:59:59Z"}}, t0);
+    REQUIRE(cache.size() == 0);
+
+    // Present but unreadable: not stored, and the previous answer is dropped
+    cache.store(k16, "A", accepted, t0);
+    cache.store(k16, "A", {{"status", "Accepted"}, {"expiryDate", "2024-01-01T02:00:00+0200"}}, t0);
+    REQUIRE(cache.find(k16, t0) == nullptr);
+    cache.store(k201, "B", {{"status", "Accepted"}, {"cacheExpiryDateTime", 1704067260}}, t0);
+    REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("AuthorizationCache: evicts the least recently used entry", "[ocpp][authcache]")
+{
+    AuthorizationCache cache(options(3));
+    for (const char* token : {"A", "B", "C"})
+        cache.store(AuthorizationCache::make_key("1.6", "", token), token, accepted, t0);
+
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "", "A"), t0));  // A is now the newest
+    cache.store(AuthorizationCache::make_key("1.6", "", "D"), "D", accepted, t0);
+
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "", "B"), t0) == nullptr);
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "", "A"), t0));
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "", "C"), t0));
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "", "D"), t0));
+
+    AuthorizationCache disabled(options(0));
+    disabled.store("k", "A", accepted, t0);
+    REQUIRE(disabled.size() == 0);
+}
+
+TEST_CASE("AuthorizationCache: invalidate by token across scopes", "[ocpp][authcache]")
+{
+    AuthorizationCache cache(options(10));
+    cache.store(AuthorizationCache::make_key("1.6", "AC1", "A"), "A", accepted, t0);
+    cache.store(AuthorizationCache::make_key("2.0.1", "AC2", "A"), "A", accepted, t0);
+    cache.store(AuthorizationCache::make_key("1.6", "AC1", "B"), "B", accepted, t0);
+
+    REQUIRE(cache.invalidate("A") == 2);
+    REQUIRE(cache.invalidate("A") == 0);
+    REQUIRE(cache.size() == 1);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.find(AuthorizationCache::make_key("1.6", "AC1", "B"), t0) == nullptr);
+}
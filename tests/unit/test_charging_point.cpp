@@ -0,0 +1,203 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/charging_point.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <set>
+
+// Counts every allocation in the test binary, for the zero-allocation checks below.
+namespace
+{
+std::atomic<std::size_t> g_allocations{0};
+} // namespace
+
+// Every replaceable form is defined, so each new is paired with its own delete.
+namespace
+{
+void* counted_alloc(std::size_t size, std::size_t alignment = 0)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size = size ? size : 1;
+    void* p = alignment ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                        : std::malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+} // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t al)
+{
+    return counted_alloc(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al)
+{
+    return counted_alloc(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace ocpp;
+
+namespace
+{
+
+// The manager only uses connection pointers as keys; they are never dereferenced.
+apostol::WsConnection* fake_connection(std::uintptr_t n)
+{
+    return reinterpret_cast<apostol::WsConnection*>(n * 64);
+}
+
+} // namespace
+
+TEST_CASE("CSChargingPointManager: get_or_create and find_by_identity", "[ocpp][points]")
+{
+    CSChargingPointManager mgr;
+
+    auto& a = mgr.get_or_create("CP1");
+    auto& b = mgr.get_or_create("CP2");
+
+    REQUIRE(mgr.size() == 2);
+    REQUIRE(&mgr.get_or_create("CP1") == &a);
+    REQUIRE(mgr.find_by_identity("CP2") == &b);
+    REQUIRE(mgr.find_by_identity("CP3") == nullptr);
+
+    REQUIRE(a.handle());
+    REQUIRE(a.handle() != b.handle());
+    REQUIRE(mgr.get(a.handle()) == &a);
+    REQUIRE(mgr.get(PointHandle{}) == nullptr);
+}
+
+TEST_CASE("CSChargingPointManager: connection index follows bind_connection", "[ocpp][points]")
+{
+    CSChargingPointManager mgr;
+    auto& a = mgr.get_or_create("CP1");
+    auto& b = mgr.get_or_create("CP2");
+
+    auto* c1 = fake_connection(1);
+    auto* c2 = fake_connection(2);
+
+    mgr.bind_connection(a, c1);
+    mgr.bind_connection(b, c2);
+
+    REQUIRE(a.connected());
+    REQUIRE(a.ws_connection() == c1);
+    REQUIRE(mgr.find_by_connection(c1) == &a);
+    REQUIRE(mgr.find_by_connection(c2) == &b);
+
+    // Reconnect: the old connection no longer maps to the point
+    auto* c3 = fake_connection(3);
+    mgr.bind_connection(a, c3);
+    REQUIRE(mgr.find_by_connection(c1) == nullptr);
+    REQUIRE(mgr.find_by_connection(c3) == &a);
+
+    mgr.bind_connection(a, nullptr);
+    REQUIRE_FALSE(a.connected());
+    REQUIRE(mgr.find_by_connection(c3) == nullptr);
+    REQUIRE(mgr.find_by_connection(c2) == &b);
+}
+
+TEST_CASE("CSChargingPointManager: remove invalidates handle and connection", "[ocpp][points]")
+{
+    CSChargingPointManager mgr;
+    auto& a = mgr.get_or_create("CP1");
+    auto handle = a.handle();
+    auto* conn = fake_connection(1);
+    mgr.bind_connection(a, conn);
+
+    REQUIRE(mgr.remove("CP1"));
+    REQUIRE_FALSE(mgr.remove("CP1"));
+    REQUIRE(mgr.empty());
+    REQUIRE(mgr.get(handle) == nullptr);
+    REQUIRE(mgr.find_by_identity("CP1") == nullptr);
+    REQUIRE(mgr.find_by_connection(conn) == nullptr);
+
+    // The slot is reused, but the stale handle still resolves to nothing
+    auto& b = mgr.get_or_create("CP2");
+    REQUIRE(b.handle().index == handle.index);
+    REQUIRE(mgr.get(handle) == nullptr);
+    REQUIRE(mgr.get(b.handle()) == &b);
+}
+
+TEST_CASE("CSChargingPointManager: points keep their address as the slab grows", "[ocpp][points]")
+{
+    CSChargingPointManager mgr;
+    auto& first = mgr.get_or_create("CP0");
+
+    std::set<std::string> seen;
+    for (int i = 1; i < 1000; ++i)
+        mgr.get_or_create(fmt::format("CP{}", i));
+
+    REQUIRE(mgr.size() == 1000);
+    REQUIRE(mgr.find_by_identity("CP0") == &first);
+
+    mgr.for_each([&](const CSChargingPoint& p) { seen.insert(p.identity()); });
+    REQUIRE(seen.size() == 1000);
+}
+
+TEST_CASE("CSChargingPointManager: lookups by view do not allocate", "[ocpp][points]")
+{
+    // Longer than any std::string small-buffer, so a temporary key would allocate
+    const std::string identity = "STATION-WITH-A-LONG-IDENTITY-0001";
+    const std::string action   = "StatusNotificationWithLongName";
+
+    CSChargingPointManager mgr;
+    auto& point = mgr.get_or_create(identity);
+    point.store_request(action, nlohmann::json{{"status", "Available"}});
+    const nlohmann::json* stored = &point.last_request(action);
+
+    const auto& cpoint = point;
+    cpoint.last_request("Unknown");  // initialize the shared empty object
+    const std::string_view identity_view = identity;
+    const std::string_view action_view = action;
+
+    // Catch assertions allocate themselves, so probe first and check afterwards
+    const std::size_t before = g_allocations.load();
+
+    auto* by_view     = mgr.find_by_identity(identity_view);
+    auto* missing     = mgr.find_by_identity("STATION-WITH-A-LONG-IDENTITY-0002");
+    auto* by_handle   = mgr.get(point.handle());
+    auto* const_hit   = &cpoint.last_request(action_view);
+    auto* mutable_hit = &point.last_request(action_view);
+
+    const std::size_t after = g_allocations.load();
+
+    REQUIRE(by_view == &point);
+    REQUIRE(missing == nullptr);
+    REQUIRE(by_handle == &point);
+    REQUIRE(const_hit == stored);
+    REQUIRE(mutable_hit == stored);
+    REQUIRE(stored->contains("status"));
+    REQUIRE(after == before);
+}
+
+TEST_CASE("append_ocpp_json: a reused send buffer does not allocate", "[ocpp][protocol]")
+{
+    auto msg = make_call_result("0123456789abcdef", {{"currentTime", "2024-01-01T00:00:00.000Z"},
+                                                     {"status", "Accepted"}, {"interval", 300}});
+    std::string buffer;
+    append_ocpp_json(buffer, msg);
+    const auto expected = buffer;
+
+    const std::size_t before = g_allocations.load();
+    for (int i = 0; i < 100; ++i) {
+        buffer.clear();
+        append_ocpp_json(buffer, msg);
+    }
+    const std::size_t after = g_allocations.load();
+
+    REQUIRE(buffer == expected);
+    REQUIRE(after == before);
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/circuit_breaker.hpp"
+
+using namespace ocpp;
+using namespace std::chrono_literals;
+using State = CircuitBreaker::State;
+
+namespace
+{
+
+CircuitBreaker::Options options()
+{
+    CircuitBreaker::Options o;
+    o.error_rate  = 0.5;
+    o.latency     = 1000ms;
+    o.min_samples = 5;
+    o.alpha       = 0.2;
+    o.open_for    = 10s;
+    o.probes      = 2;
+    return o;
+}
+
+const CircuitBreaker::time_point t0{};
+
+} // namespace
+
+TEST_CASE("CircuitBreaker: opens on errors only after min_samples", "[ocpp][breaker]")
+{
+    CircuitBreaker breaker(options());
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(breaker.allow(t0));
+        breaker.record_failure(t0);
+    }
+    REQUIRE(breaker.state() == State::Closed);
+
+    breaker.record_failure(t0);
+    REQUIRE(breaker.state() == State::Open);
+    REQUIRE_FALSE(breaker.allow(t0 + 9s));
+}
+
+TEST_CASE("CircuitBreaker: healthy traffic absorbs occasional failures", "[ocpp][breaker]")
+{
+    CircuitBreaker breaker(options());
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(breaker.allow(t0));
+        if (i % 5 == 0)
+            breaker.record_failure(t0);
+        else
+            breaker.record_success(50ms, t0);
+    }
+    REQUIRE(breaker.state() == State::Closed);
+    REQUIRE(breaker.error_rate() < 0.5);
+}
+
+TEST_CASE("CircuitBreaker: opens on average latency", "[ocpp][breaker]")
+{
+    CircuitBreaker breaker(options());
+
+    for (int i = 0; i < 5; ++i)
+        breaker.record_success(100ms, t0);
+    REQUIRE(breaker.latency() == 100ms);
+
+    // One slow answer does not trip it, a slow backend does
+    breaker.record_success(1500ms, t0);
+    REQUIRE(breaker.state() == State::Closed);
+
+    int slow = 1;
+    while (breaker.state() == State::Closed && slow < 20) {
+        breaker.record_success(1500ms, t0);
+        ++slow;
+    }
+    REQUIRE(breaker.state() == State::Open);
+    REQUIRE(slow > 3);
+}
+
+TEST_CASE("CircuitBreaker: half-open probes close or re-open it", "[ocpp][breaker]")
+{
+    CircuitBreaker breaker(options());
+    for (int i = 0; i < 5; ++i)
+        breaker.record_failure(t0);
+    REQUIRE(breaker.state() == State::Open);
+
+    SECTION("probes succeed") {
+        REQUIRE(breaker.allow(t0 + 10s));
+        REQUIRE(breaker.state() == State::HalfOpen);
+        REQUIRE(breaker.allow(t0 + 10s));
+        REQUIRE_FALSE(breaker.allow(t0 + 10s));  // only `probes` at a time
+
+        breaker.record_success(10ms, t0 + 11s);
+        REQUIRE(breaker.state() == State::HalfOpen);
+        REQUIRE_FALSE(breaker.allow(t0 + 11s));
+        breaker.record_success(10ms, t0 + 11s);
+
+        REQUIRE(breaker.state() == State::Closed);
+        REQUIRE(breaker.error_rate() == 0.0);
+        REQUIRE(breaker.allow(t0 + 11s));
+    }
+
+    SECTION("a probe fails") {
+        REQUIRE(breaker.allow(t0 + 10s));
+        breaker.record_failure(t0 + 12s);
+        REQUIRE(breaker.state() == State::Open);
+        REQUIRE_FALSE(breaker.allow(t0 + 21s));
+        REQUIRE(breaker.allow(t0 + 22s));
+    }
+
+    SECTION("a probe is too slow") {
+        REQUIRE(breaker.allow(t0 + 10s));
+        breaker.record_success(2000ms, t0 + 12s);
+        REQUIRE(breaker.state() == State::Open);
+    }
+}
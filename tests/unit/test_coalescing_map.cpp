@@ -0,0 +1,32 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/coalescing_map.hpp"
+
+using namespace ocpp;
+
+TEST_CASE("CoalescingMap: keeps the latest value per key", "[ocpp][coalesce]")
+{
+    CoalescingMap<bool> states;
+    REQUIRE(states.empty());
+
+    REQUIRE_FALSE(states.put("CP1", true));
+    REQUIRE_FALSE(states.put("CP2", true));
+    REQUIRE(states.put("CP1", false));      // flap: connect, disconnect, connect
+    REQUIRE(states.put("CP1", true));
+
+    REQUIRE(states.size() == 2);
+    REQUIRE(states.submitted() == 4);
+    REQUIRE(states.coalesced() == 2);
+
+    auto entries = states.take();
+    REQUIRE(entries.size() == 2);
+    REQUIRE(entries[0].first == "CP1");     // first-put order
+    REQUIRE(entries[0].second == true);
+    REQUIRE(entries[1].first == "CP2");
+    REQUIRE(states.empty());
+
+    // A taken key starts over
+    REQUIRE_FALSE(states.put("CP1", false));
+    REQUIRE(states.take().front().second == false);
+    REQUIRE(states.submitted() == 5);
+    REQUIRE(states.coalesced() == 2);
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/http_parser.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ocpp;
+
+namespace
+{
+
+// Feed @p stream in pieces of @p step bytes, collecting complete responses.
+std::vector<HttpResponseParser::Response> parse_all(std::string_view stream, std::size_t step)
+{
+    HttpResponseParser parser;
+    std::vector<HttpResponseParser::Response> out;
+
+    for (std::size_t at = 0; at < stream.size(); at += step) {
+        auto piece = stream.substr(at, step);
+        while (!piece.empty()) {
+            piece.remove_prefix(parser.feed(piece));
+            if (parser.complete())
+                out.push_back(parser.take());
+        }
+    }
+    if (parser.finish() && parser.complete())
+        out.push_back(parser.take());
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("parse_http_url: splits scheme, host, port and target", "[ocpp][http]")
+{
+    auto url = parse_http_url("http://localhost:8080/api/v1/ocpp/parse?x=1#frag");
+    REQUIRE(url);
+    REQUIRE_FALSE(url->tls);
+    REQUIRE(url->host == "localhost");
+    REQUIRE(url->port == 8080);
+    REQUIRE(url->target == "/api/v1/ocpp/parse?x=1");
+    REQUIRE(url->host_header == "localhost:8080");
+
+    url = parse_http_url("https://hooks.example.com");
+    REQUIRE(url);
+    REQUIRE(url->tls);
+    REQUIRE(url->port == 443);
+    REQUIRE(url->target == "/");
+
+    url = parse_http_url("http://[::1]:9000?q");
+    REQUIRE(url);
+    REQUIRE(url->host == "::1");
+    REQUIRE(url->port == 9000);
+    REQUIRE(url->target == "/?q");
+    REQUIRE(url->host_header == "[::1]:9000");
+
+    for (const char* bad : {"", "ftp://host/", "http://", "http://:80/", "http://host:0/",
+                            "http://host:70000/", "http://host:80x/", "http://user@host/", "http://[::1/"})
+        REQUIRE_FALSE(parse_http_url(bad));
+}
+
+TEST_CASE("HttpResponseParser: pipelined responses split at any boundary", "[ocpp][http]")
+{
+    const std::string stream =
+        "HTTP/1.1 100 Continue\r\n\r\n"
+        "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\ncontent-length: 13\r\n\r\n"
+        "{\"status\":1}\n"
+        "HTTP/1.1 201 Created\r\nTransfer-Encoding: gzip, chunked\r\n\r\n"
+        "4;ext=1\r\nWiki\r\n5\r\npedia\r\n0\r\nX-Trailer: 1\r\n\r\n"
+        "HTTP/1.1 204 No Content\r\n\r\n"
+        "HTTP/1.1 500 Internal Server Error\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+
+    for (std::size_t step : {stream.size(), std::size_t{1}, std::size_t{7}, std::size_t{64}}) {
+        auto responses = parse_all(stream, step);
+        REQUIRE(responses.size() == 4);
+
+        REQUIRE(responses[0].status == 200);
+        REQUIRE(responses[0].body == "{\"status\":1}\n");
+        REQUIRE(responses[0].keep_alive);
+        REQUIRE(responses[0].http11);
+
+        REQUIRE(responses[1].status == 201);
+        REQUIRE(responses[1].body == "Wikipedia");
+
+        REQUIRE(responses[2].status == 204);
+        REQUIRE(responses[2].body.empty());
+
+        REQUIRE(responses[3].status == 500);
+        REQUIRE_FALSE(responses[3].keep_alive);
+    }
+}
+
+TEST_CASE("HttpResponseParser: HTTP/1.0 and bodies delimited by close", "[ocpp][http]")
+{
+    auto responses = parse_all("HTTP/1.0 200 OK\r\nContent-Length: 2\r\n\r\nok", 5);
+    REQUIRE(responses.size() == 1);
+    REQUIRE_FALSE(responses[0].http11);
+    REQUIRE_FALSE(responses[0].keep_alive);
+
+    responses = parse_all("HTTP/1.0 200 OK\r\nConnection: keep-alive\r\nContent-Length: 0\r\n\r\n", 3);
+    REQUIRE(responses.size() == 1);
+    REQUIRE(responses[0].keep_alive);
+
+    responses = parse_all("HTTP/1.1 200 OK\r\n\r\nuntil the end", 4);
+    REQUIRE(responses.size() == 1);
+    REQUIRE(responses[0].body == "until the end");
+    REQUIRE_FALSE(responses[0].keep_alive);
+}
+
+TEST_CASE("HttpResponseParser: truncated and malformed responses", "[ocpp][http]")
+{
+    HttpResponseParser parser;
+    REQUIRE_FALSE(parser.started());
+    REQUIRE(parser.finish());
+
+    std::string_view partial = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc";
+    REQUIRE(parser.feed(partial) == partial.size());
+    REQUIRE(parser.started());
+    REQUIRE_FALSE(parser.complete());
+    REQUIRE_FALSE(parser.finish());
+
+    for (const char* bad : {"HTTP/2 200 OK\r\n\r\n", "HTTP/1.1 2x0 OK\r\n\r\n", "HTTP/1.1 200 OK\r\nNoColon\r\n\r\n",
+                            "HTTP/1.1 200 OK\r\nContent-Length: -1\r\n\r\n",
+                            "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n",
+                            "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nab\r\n"}) {
+        HttpResponseParser p;
+        REQUIRE_THROWS_AS(p.feed(bad), std::runtime_error);
+    }
+
+    HttpResponseParser huge;
+    REQUIRE_THROWS_AS(huge.feed(std::string(HttpResponseParser::kMaxHead + 1, 'x')), std::runtime_error);
+}
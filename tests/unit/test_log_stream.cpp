@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/log_stream.hpp"
+
+#include <stdexcept>
+
+using namespace ocpp;
+using json = nlohmann::json;
+
+namespace
+{
+
+LogEvent event(std::string_view identity, LogDirection direction, std::string_view action)
+{
+    LogEvent e;
+    e.identity  = identity;
+    e.direction = direction;
+    e.action    = action;
+    e.unique_id = "42";
+    e.payload   = "{}";
+    return e;
+}
+
+} // namespace
+
+TEST_CASE("append_log_event: same entry as the JSON object it replaces", "[ocpp][log]")
+{
+    OcppMessage msg;
+    msg.type        = MessageType::Call;
+    msg.unique_id   = "u-1";
+    msg.action      = "BootNotification";
+    msg.raw_payload = R"({"chargePointVendor":"V","chargePointModel":"M"})";
+
+    LogEvent e;
+    e.identity  = "CP \"1\"";
+    e.direction = LogDirection::In;
+    e.type      = msg.type;
+    e.unique_id = msg.unique_id;
+    e.action    = msg.action;
+    e.message   = &msg;
+
+    std::string out;
+    append_log_event(out, e);
+
+    auto entry = json::parse(out);
+    REQUIRE(entry["ts"].is_string());
+    entry.erase("ts");
+
+    REQUIRE(entry == json{{"identity", "CP \"1\""}, {"direction", "in"}, {"messageType", "Call"},
+                          {"uniqueId", "u-1"}, {"action", "BootNotification"},
+                          {"payload", {{"chargePointVendor", "V"}, {"chargePointModel", "M"}}}});
+
+    // Payload from the DOM when the original bytes are unknown
+    msg.raw_payload.clear();
+    msg.payload = {{"status", "Accepted"}};
+    e.type = MessageType::CallResult;
+    e.direction = LogDirection::Out;
+    out.clear();
+    append_log_event(out, e);
+    entry = json::parse(out);
+    REQUIRE(entry["payload"] == json{{"status", "Accepted"}});
+    REQUIRE(entry["direction"] == "out");
+    REQUIRE(entry["messageType"] == "CallResult");
+}
+
+TEST_CASE("LogFilter: identity, action and direction", "[ocpp][log]")
+{
+    REQUIRE(LogFilter{}.matches(event("CP1", LogDirection::Out, "")));
+
+    auto filter = LogFilter::parse(json{{"identity", {"CP1", "CP2"}}, {"action", "Heartbeat"},
+                                        {"direction", "in"}});
+    REQUIRE(filter.matches(event("CP1", LogDirection::In, "Heartbeat")));
+    REQUIRE(filter.matches(event("CP2", LogDirection::In, "Heartbeat")));
+    REQUIRE_FALSE(filter.matches(event("CP3", LogDirection::In, "Heartbeat")));
+    REQUIRE_FALSE(filter.matches(event("CP1", LogDirection::Out, "Heartbeat")));
+    REQUIRE_FALSE(filter.matches(event("CP1", LogDirection::In, "")));   // action unknown
+
+    auto out_only = LogFilter::parse(json{{"direction", "out"}});
+    REQUIRE(out_only.matches(event("CP9", LogDirection::Out, "")));
+    REQUIRE_FALSE(out_only.matches(event("CP9", LogDirection::In, "Authorize")));
+
+    REQUIRE(LogFilter::parse(json::object()).matches(event("CP1", LogDirection::In, "x")));
+    REQUIRE_THROWS_AS(LogFilter::parse(json{{"direction", "both"}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(LogFilter::parse(json{{"identity", 5}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(LogFilter::parse(json::array()), std::invalid_argument);
+}
+
+TEST_CASE("LogPayload: formats the event's payload", "[ocpp][log]")
+{
+    auto e = event("CP1", LogDirection::In, "Heartbeat");
+    REQUIRE(fmt::format("[{}] {}", message_type_name(e.type), LogPayload{e}) == "[Call] {}");
+
+    OcppMessage msg = make_call_result("u1", {{"status", "Accepted"}});
+    e.message = &msg;
+    REQUIRE(fmt::format("{}", LogPayload{e}) == R"({"status":"Accepted"})");
+
+    e.message = nullptr;
+    e.payload = {};
+    REQUIRE(fmt::format("{}", LogPayload{e}) == "null");
+}
@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/message_log.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace ocpp;
+
+TEST_CASE("SpscRing: bounded FIFO", "[ocpp][messagelog]")
+{
+    SpscRing<std::string> ring(3);
+    REQUIRE(ring.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(ring.try_push(std::to_string(i)));
+    std::string extra = "x";
+    REQUIRE_FALSE(ring.try_push(std::move(extra)));
+    REQUIRE(extra == "x");
+
+    REQUIRE(*ring.try_pop() == "0");
+    REQUIRE(ring.try_push("4"));
+    for (int i = 1; i <= 4; ++i)
+        REQUIRE(*ring.try_pop() == std::to_string(i));
+    REQUIRE_FALSE(ring.try_pop());
+}
+
+TEST_CASE("SpscRing: one producer and one consumer thread", "[ocpp][messagelog]")
+{
+    constexpr int kCount = 200000;
+    SpscRing<int> ring(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i)
+            while (!ring.try_push(int{i}))
+                std::this_thread::yield();
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        if (auto value = ring.try_pop()) {
+            ordered = ordered && *value == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    REQUIRE(ordered);
+}
+
+TEST_CASE("MessageLog: sampling per action", "[ocpp][messagelog]")
+{
+    MessageLog::Options options;
+    options.sample[action_index(Action::MeterValues)] = 100;
+    options.sample[action_index(Action::Heartbeat)] = 0;   // treated as 1
+    MessageLog log(options);
+
+    int meter_values = 0, heartbeats = 0;
+    for (int i = 0; i < 1000; ++i) {
+        meter_values += log.sample(Action::MeterValues);
+        heartbeats += log.sample(Action::Heartbeat);
+    }
+    REQUIRE(meter_values == 10);
+    REQUIRE(heartbeats == 1000);
+    REQUIRE(log.sample(Action::Unknown));
+    REQUIRE(log.counters().skipped == 990);
+}
+
+TEST_CASE("MessageLog: the writer thread appends every queued record", "[ocpp][messagelog]")
+{
+    char path[] = "/tmp/ocpp_message_log_XXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::close(fd);
+
+    MessageLog::Options options;
+    options.file  = path;
+    options.queue = 1 << 16;
+
+    {
+        MessageLog log(options);
+        log.start();
+        for (int i = 0; i < 1000; ++i)
+            log.push(R"({"n":)" + std::to_string(i) + "}");
+        log.stop();
+
+        auto counters = log.counters();
+        REQUIRE(counters.logged == 1000);
+        REQUIRE(counters.dropped == 0);
+        REQUIRE(counters.written == 1000);
+    }
+
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+    std::remove(path);
+
+    REQUIRE(lines.size() == 1000);
+    REQUIRE(lines.front() == R"({"n":0})");
+    REQUIRE(lines.back() == R"({"n":999})");
+}
+
+TEST_CASE("MessageLog: a full ring drops instead of blocking", "[ocpp][messagelog]")
+{
+    MessageLog::Options options;
+    options.queue = 8;
+    MessageLog log(options);   // no writer: nothing drains
+
+    for (int i = 0; i < 10; ++i)
+        log.push("record");
+    REQUIRE(log.counters().logged == 8);
+    REQUIRE(log.counters().dropped == 2);
+
+    options.file = "/nonexistent/dir/messages.log";
+    MessageLog broken(options);
+    REQUIRE_THROWS_AS(broken.start(), std::system_error);
+}
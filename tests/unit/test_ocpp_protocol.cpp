@@ -46,6 +46,125 @@ TEST_CASE("parse_ocpp_json: malformed JSON throws", "[ocpp][protocol]")
     REQUIRE_THROWS(parse_ocpp_json("not json at all"));
 }
 
+TEST_CASE("parse_ocpp_json: escaped envelope strings are decoded", "[ocpp][protocol]")
+{
+    auto msg = parse_ocpp_json(R"([2,"id\"1","Heartbeat",{}])");
+    REQUIRE(msg.unique_id == "id\"1");
+    REQUIRE(msg.action == "Heartbeat");
+}
+
+// ── parse_ocpp_frame ────────────────────────────────────────────────────────
+
+TEST_CASE("parse_ocpp_frame: Call keeps raw payload range", "[ocpp][protocol]")
+{
+    std::string text = R"( [2, "abc123" ,"MeterValues", {"connectorId":1,"meterValue":[{"v":"[]"}]} ] )";
+    auto frame = parse_ocpp_frame(text);
+
+    REQUIRE(frame.type == MessageType::Call);
+    REQUIRE(frame.unique_id == "abc123");
+    REQUIRE(frame.action == "MeterValues");
+    REQUIRE(frame.payload == R"({"connectorId":1,"meterValue":[{"v":"[]"}]})");
+    REQUIRE_FALSE(frame.escaped);
+
+    // Views point into the original buffer, nothing is copied
+    REQUIRE(frame.payload.data() >= text.data());
+    REQUIRE(frame.payload.data() < text.data() + text.size());
+
+    REQUIRE(frame.payload_json()["connectorId"] == 1);
+}
+
+TEST_CASE("parse_ocpp_frame: CallResult and CallError", "[ocpp][protocol]")
+{
+    auto res = parse_ocpp_frame(R"([3,"r1",{"status":"Accepted"}])");
+    REQUIRE(res.type == MessageType::CallResult);
+    REQUIRE(res.unique_id == "r1");
+    REQUIRE(res.payload == R"({"status":"Accepted"})");
+
+    auto err = parse_ocpp_frame(R"([4,"e1","GenericError","oops",{}])");
+    REQUIRE(err.type == MessageType::CallError);
+    REQUIRE(err.error_code == "GenericError");
+    REQUIRE(err.error_description == "oops");
+    REQUIRE(err.payload == "{}");
+}
+
+TEST_CASE("parse_ocpp_frame: malformed envelopes throw", "[ocpp][protocol]")
+{
+    REQUIRE_THROWS_AS(parse_ocpp_frame(R"({"a":1})"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_ocpp_frame(R"([2,"id","Heartbeat"])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_ocpp_frame(R"([2,1,"Heartbeat",{}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_ocpp_frame(R"([2,"id","Heartbeat",{"a":1})"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_ocpp_frame(R"([2,"id","Heartbeat",{}] x)"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_ocpp_frame(R"([4,"id","GenericError"])"), std::invalid_argument);
+}
+
+TEST_CASE("parse_ocpp_frame: invalid payload is only detected on demand", "[ocpp][protocol]")
+{
+    auto frame = parse_ocpp_frame(R"([2,"id","Heartbeat",{"a":tru}])");
+    REQUIRE(frame.payload == R"({"a":tru})");
+    REQUIRE_THROWS(frame.payload_json());
+}
+
+TEST_CASE("parse_ocpp_json: original payload bytes are kept", "[ocpp][protocol]")
+{
+    auto msg = parse_ocpp_json(R"([2,"m1","MeterValues",{"connectorId":1, "z":1.50,"a":[]}])");
+    REQUIRE(msg.raw_payload == R"({"connectorId":1, "z":1.50,"a":[]})");
+    REQUIRE(msg.payload_text() == msg.raw_payload);
+
+    auto built = make_call_result("r1", {{"status", "Accepted"}});
+    REQUIRE(built.raw_payload.empty());
+    REQUIRE(built.payload_text() == R"({"status":"Accepted"})");
+}
+
+TEST_CASE("OcppFrame::envelope: payload left as a view into the frame", "[ocpp][protocol]")
+{
+    const std::string text = R"([3,"id\"1",{"status":"Accepted"}])";
+    auto frame = parse_ocpp_frame(text);
+    auto msg = frame.envelope();
+
+    REQUIRE(msg.type == MessageType::CallResult);
+    REQUIRE(msg.unique_id == "id\"1");
+    REQUIRE(msg.payload.empty());
+    REQUIRE(msg.raw_payload.empty());
+    REQUIRE(msg.raw().data() == frame.payload.data());
+    REQUIRE(msg.payload_text() == R"({"status":"Accepted"})");
+
+    std::string out;
+    msg.append_payload(out);
+    REQUIRE(out == frame.payload);
+
+    // to_message() owns its bytes
+    auto owned = frame.to_message();
+    REQUIRE(owned.raw_view.empty());
+    REQUIRE(owned.raw() == frame.payload);
+    REQUIRE(owned.payload["status"] == "Accepted");
+}
+
+TEST_CASE("append_json: same text as dump(), nothing appended on error", "[ocpp][protocol]")
+{
+    std::string out = "x";
+    const nlohmann::json value = {{"status", "Accepted"}, {"n", 1.5}, {"a", nlohmann::json::array()}};
+    append_json(out, value);
+    REQUIRE(out == "x" + value.dump());
+
+    // Thrown after part of the object is written: rolled back
+    out = "x";
+    REQUIRE_THROWS(append_json(out, nlohmann::json{{"a", "ok"}, {"bad", "\xff"}}));
+    REQUIRE(out == "x");
+
+    // The per-thread serializer is still usable
+    append_json(out, value);
+    REQUIRE(out == "x" + value.dump());
+}
+
+TEST_CASE("append_json_string: escapes like nlohmann::json", "[ocpp][protocol]")
+{
+    for (std::string text : {"plain", "quote\"in", "back\\slash", "ctl\n\t\x01", "", "utf8 \xc3\xa9"}) {
+        std::string out;
+        append_json_string(out, text);
+        REQUIRE(out == nlohmann::json(text).dump());
+    }
+}
+
 // ── serialize_ocpp_json ─────────────────────────────────────────────────────
 
 TEST_CASE("serialize_ocpp_json: Call roundtrip", "[ocpp][protocol]")
@@ -100,6 +219,33 @@ TEST_CASE("serialize_ocpp_json: CallError", "[ocpp][protocol]")
     REQUIRE(parsed[4].is_object());
 }
 
+TEST_CASE("append_ocpp_frame: same bytes as a DOM array dump", "[ocpp][protocol]")
+{
+    const nlohmann::json payload = {
+        {"idTag", "tag \"1\"\n"},
+        {"meterValue", {{{"timestamp", "2024-01-01T00:00:00Z"},
+                         {"sampledValue", {{{"value", "12.5"}, {"unit", "kWh"}}}}}}},
+        {"price", 0.25},
+        {"name", "Z\u00fcrich"},
+        {"none", nullptr}
+    };
+
+    std::string out = "prefix";
+    append_ocpp_frame(out, MessageType::Call, "id\t1", "MeterValues", {}, {}, payload);
+    REQUIRE(out == "prefix" + nlohmann::json::array({2, "id\t1", "MeterValues", payload}).dump());
+
+    out.clear();
+    append_ocpp_frame(out, MessageType::CallResult, "r1", {}, {}, {}, payload);
+    REQUIRE(out == nlohmann::json::array({3, "r1", payload}).dump());
+
+    out.clear();
+    append_ocpp_frame(out, MessageType::CallError, "e1", {}, "FormationViolation",
+                      "At /idTag of \"x\" - unexpected instance type\n", nlohmann::json::object());
+    REQUIRE(out == nlohmann::json::array({4, "e1", "FormationViolation",
+                                          "At /idTag of \"x\" - unexpected instance type\n",
+                                          nlohmann::json::object()}).dump());
+}
+
 // ── Full roundtrip ──────────────────────────────────────────────────────────
 
 TEST_CASE("parse/serialize: Call roundtrip", "[ocpp][protocol]")
@@ -153,8 +299,85 @@ TEST_CASE("make_call_error: creates correct OcppMessage", "[ocpp][protocol]")
     REQUIRE(msg.error_description == "Not supported");
 }
 
+// ── parse_backend_reply ─────────────────────────────────────────────────────
+
+TEST_CASE("parse_backend_reply: one malformed row in a batch", "[ocpp][protocol]")
+{
+    // The rows of a batched ocpp.parse(), in order; the second one is broken
+    const char* rows[] = {
+        R"({"uniqueId":"a","messageTypeId":"CallResult","payload":{"status":"Accepted"}})",
+        R"({"uniqueId":"b","messageTypeId":"CallRes)",
+        R"({"uniqueId":"c","messageTypeId":"CallError","errorCode":"NotSupported","errorDescription":"no"})",
+        R"(["c"])",
+        R"({"uniqueId":42})",
+    };
+
+    auto a = parse_backend_reply(rows[0]);
+    REQUIRE(a);
+    REQUIRE(a->type == MessageType::CallResult);
+    REQUIRE(a->unique_id == "a");
+    REQUIRE(a->payload["status"] == "Accepted");
+
+    REQUIRE_FALSE(parse_backend_reply(rows[1]));
+
+    // The rows after the bad one are still answered
+    auto c = parse_backend_reply(rows[2]);
+    REQUIRE(c);
+    REQUIRE(c->type == MessageType::CallError);
+    REQUIRE(c->unique_id == "c");
+    REQUIRE(c->error_code == "NotSupported");
+    REQUIRE(c->error_description == "no");
+    REQUIRE(c->payload.is_object());
+
+    REQUIRE_FALSE(parse_backend_reply(rows[3]));
+    REQUIRE_FALSE(parse_backend_reply(rows[4]));
+}
+
 // ── OCPP enums ──────────────────────────────────────────────────────────────
 
+TEST_CASE("Action: every name interns to itself", "[ocpp][protocol]")
+{
+    for (std::size_t i = 1; i < kActionCount; ++i) {
+        auto action = static_cast<Action>(i);
+        auto name = action_name(action);
+        REQUIRE_FALSE(name.empty());
+        REQUIRE(action_from_string(name) == action);
+    }
+
+    STATIC_REQUIRE(action_from_string("Heartbeat") == Action::Heartbeat);
+    STATIC_REQUIRE(action_from_string("TransactionEvent") == Action::TransactionEvent);
+}
+
+TEST_CASE("Action: unknown names and version membership", "[ocpp][protocol]")
+{
+    REQUIRE(action_from_string("") == Action::Unknown);
+    REQUIRE(action_from_string("heartbeat") == Action::Unknown);
+    REQUIRE(action_from_string("HeartbeatX") == Action::Unknown);
+    REQUIRE(action_name(Action::Unknown).empty());
+
+    REQUIRE(action_in_version(Action::StartTransaction, "1.6"));
+    REQUIRE_FALSE(action_in_version(Action::StartTransaction, "2.0.1"));
+    REQUIRE(action_in_version(Action::TransactionEvent, "2.0.1"));
+    REQUIRE_FALSE(action_in_version(Action::TransactionEvent, "1.6"));
+    REQUIRE(action_in_version(Action::BootNotification, "1.6"));
+    REQUIRE(action_in_version(Action::BootNotification, "2.0.1"));
+}
+
+TEST_CASE("Action: interned when parsing and building calls", "[ocpp][protocol]")
+{
+    auto msg = parse_ocpp_json(R"([2,"u1","StatusNotification",{}])");
+    REQUIRE(msg.action_id == Action::StatusNotification);
+
+    auto custom = parse_ocpp_json(R"([2,"u2","VendorSpecific",{}])");
+    REQUIRE(custom.action_id == Action::Unknown);
+    REQUIRE(custom.action == "VendorSpecific");
+
+    auto call = make_call(Action::Reset, {{"type", "Hard"}});
+    REQUIRE(call.action == "Reset");
+    REQUIRE(call.action_id == Action::Reset);
+    REQUIRE(make_call("GetVariables", {}).action_id == Action::GetVariables);
+}
+
 TEST_CASE("ChargePointStatus: string conversion roundtrip", "[ocpp][protocol]")
 {
     REQUIRE(charge_point_status_to_string(ChargePointStatus::Available) == "Available");
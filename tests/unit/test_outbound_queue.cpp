@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/outbound_queue.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ocpp;
+using Result = OutboundQueue::Result;
+
+namespace
+{
+
+// A socket that accepts `room` bytes until drained
+struct FakeSocket {
+    std::size_t              room = 0;
+    int                      probes = 0;
+    std::vector<std::string> written;
+
+    auto probe() { return [this] { ++probes; return room; }; }
+    auto write()
+    {
+        return [this](std::string_view frame) {
+            written.emplace_back(frame);
+            room = room > frame.size() ? room - frame.size() : 0;
+        };
+    }
+};
+
+OutboundQueue::Options options(OutboundQueue::Policy policy)
+{
+    OutboundQueue::Options o;
+    o.high_water = 100;
+    o.low_water  = 40;
+    o.policy     = policy;
+    return o;
+}
+
+} // namespace
+
+TEST_CASE("OutboundQueue: writes through while the socket has room", "[ocpp][outbound]")
+{
+    OutboundQueue queue(options(OutboundQueue::Policy::Disconnect));
+    FakeSocket socket;
+    socket.room = 1000;
+
+    for (int i = 0; i < 10; ++i)
+        REQUIRE(queue.send("0123456789", socket.probe(), socket.write()) == Result::Sent);
+
+    REQUIRE(socket.written.size() == 10);
+    REQUIRE(socket.probes == 1);         // the credit covered the rest
+    REQUIRE(queue.empty());
+    REQUIRE(queue.counters().queued_frames == 0);
+}
+
+TEST_CASE("OutboundQueue: queues while full and flushes in order", "[ocpp][outbound]")
+{
+    OutboundQueue queue(options(OutboundQueue::Policy::Disconnect));
+    FakeSocket socket;
+    socket.room = 15;
+
+    REQUIRE(queue.send("aaaaaaaaaa", socket.probe(), socket.write()) == Result::Sent);
+    REQUIRE(queue.send("bbbbbbbbbb", socket.probe(), socket.write()) == Result::Sent);   // spills over
+    REQUIRE(queue.send("cccccccccc", socket.probe(), socket.write()) == Result::Queued);
+    REQUIRE(queue.send("dddddddddd", socket.probe(), socket.write()) == Result::Queued);  // behind c
+    REQUIRE(queue.queued_bytes() == 20);
+
+    socket.room = 10;
+    REQUIRE_FALSE(queue.flush(socket.probe(), socket.write()));
+    REQUIRE(socket.written.back() == "cccccccccc");
+
+    socket.room = 100;
+    REQUIRE(queue.flush(socket.probe(), socket.write()));
+    REQUIRE(socket.written.size() == 4);
+    REQUIRE(socket.written.back() == "dddddddddd");
+    REQUIRE(queue.queued_bytes() == 0);
+    REQUIRE(queue.counters().queued_frames == 2);
+    REQUIRE(queue.counters().peak_bytes == 20);
+}
+
+TEST_CASE("OutboundQueue: a slow station is evicted past high water", "[ocpp][outbound]")
+{
+    OutboundQueue queue(options(OutboundQueue::Policy::Disconnect));
+    FakeSocket socket;
+
+    for (int i = 0; i < 10; ++i)
+        REQUIRE(queue.send("0123456789", socket.probe(), socket.write()) == Result::Queued);
+    REQUIRE(queue.send("0123456789", socket.probe(), socket.write()) == Result::Evict);
+    REQUIRE(queue.counters().dropped_frames == 0);
+}
+
+TEST_CASE("OutboundQueue: a slow log subscriber loses the oldest frames", "[ocpp][outbound]")
+{
+    OutboundQueue queue(options(OutboundQueue::Policy::DropOldest));
+    FakeSocket socket;
+
+    for (int i = 0; i < 11; ++i)
+        REQUIRE(queue.send(std::string(10, static_cast<char>('a' + i)), socket.probe(), socket.write()) ==
+                Result::Queued);
+
+    // 110 > 100: dropped down to 40 bytes, the newest frames survive
+    REQUIRE(queue.queued_bytes() == 40);
+    REQUIRE(queue.counters().dropped_frames == 7);
+    REQUIRE(queue.counters().dropped_bytes == 70);
+
+    socket.room = 40;
+    REQUIRE(queue.flush(socket.probe(), socket.write()));
+    REQUIRE(socket.written.front() == std::string(10, 'h'));
+    REQUIRE(socket.written.back() == std::string(10, 'k'));
+
+    // An oversized frame is kept on its own
+    REQUIRE(queue.send(std::string(150, 'x'), socket.probe(), socket.write()) == Result::Queued);
+    REQUIRE(queue.queued_frames() == 1);
+}
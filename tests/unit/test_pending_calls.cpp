@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/pending_calls.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace ocpp;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+using Calls = PendingCalls<std::string>;
+
+const Calls::time_point t0{};
+
+std::vector<std::string> expire(Calls& calls, Calls::time_point now)
+{
+    std::vector<std::string> ids;
+    calls.expire(now, [&](Calls::Call& call) { ids.push_back(call.unique_id); });
+    return ids;
+}
+
+} // namespace
+
+TEST_CASE("PendingCalls: take resolves by uniqueId", "[ocpp][pending]")
+{
+    Calls calls;
+    const PointHandle cp{0, 1};
+
+    REQUIRE(calls.insert("a", cp, t0 + 30s, "Reset"));
+    REQUIRE_FALSE(calls.insert("a", cp, t0 + 10s, "Duplicate"));
+    REQUIRE(calls.size() == 1);
+
+    auto call = calls.take("a");
+    REQUIRE(call);
+    REQUIRE(call->value == "Reset");
+    REQUIRE(call->station == cp);
+    REQUIRE(call->deadline == t0 + 30s);
+
+    REQUIRE_FALSE(calls.take("a"));
+    REQUIRE(calls.empty());
+    REQUIRE_FALSE(calls.next_deadline());
+}
+
+TEST_CASE("PendingCalls: expire returns due calls in deadline order", "[ocpp][pending]")
+{
+    Calls calls;
+    const PointHandle cp{0, 1};
+
+    calls.insert("slow", cp, t0 + 120s, "GetDiagnostics");
+    calls.insert("fast", cp, t0 + 10s, "TriggerMessage");
+    calls.insert("mid",  cp, t0 + 30s, "Reset");
+    calls.insert("done", cp, t0 + 5s,  "ClearCache");
+
+    REQUIRE(calls.next_deadline() == t0 + 5s);
+
+    // Resolved calls are skipped when their deadline surfaces
+    REQUIRE(calls.take("done"));
+    REQUIRE(calls.next_deadline() == t0 + 10s);
+
+    REQUIRE(expire(calls, t0 + 9s).empty());
+    REQUIRE(expire(calls, t0 + 30s) == std::vector<std::string>{"fast", "mid"});
+    REQUIRE(calls.size() == 1);
+    REQUIRE(calls.next_deadline() == t0 + 120s);
+
+    REQUIRE(expire(calls, t0 + 120s) == std::vector<std::string>{"slow"});
+    REQUIRE(calls.empty());
+}
+
+TEST_CASE("PendingCalls: take_station fails only that station's calls", "[ocpp][pending]")
+{
+    Calls calls;
+    const PointHandle cp1{0, 1};
+    const PointHandle cp2{1, 1};
+    const PointHandle cp1_reused{0, 2};  // same slot, later station
+
+    for (int i = 0; i < 5; ++i) {
+        calls.insert(fmt::format("cp1-{}", i), cp1, t0 + 30s, "Reset");
+        calls.insert(fmt::format("cp2-{}", i), cp2, t0 + 30s, "Reset");
+    }
+    calls.insert("cp1-new", cp1_reused, t0 + 30s, "Reset");
+
+    // Unlink from the middle and the head of the station list
+    REQUIRE(calls.take("cp1-2"));
+    REQUIRE(calls.take("cp1-4"));
+
+    std::vector<std::string> failed;
+    REQUIRE(calls.take_station(cp1, [&](Calls::Call& call) { failed.push_back(call.unique_id); }) == 3);
+    std::sort(failed.begin(), failed.end());
+    REQUIRE(failed == std::vector<std::string>{"cp1-0", "cp1-1", "cp1-3"});
+
+    REQUIRE(calls.take_station(cp1, [](Calls::Call&) {}) == 0);
+    REQUIRE(calls.size() == 6);
+    REQUIRE(calls.take("cp1-new"));
+
+    // Expiry still finds the remaining station's calls
+    REQUIRE(expire(calls, t0 + 30s).size() == 5);
+    REQUIRE(calls.empty());
+}
+
+TEST_CASE("PendingCalls: slots are reused", "[ocpp][pending]")
+{
+    Calls calls;
+    const PointHandle cp{0, 1};
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 100; ++i)
+            calls.insert(fmt::format("{}-{}", round, i), cp, t0 + std::chrono::seconds(i), "Reset");
+
+        REQUIRE(calls.size() == 100);
+        REQUIRE(calls.take_station(cp, [](Calls::Call&) {}) == 100);
+        REQUIRE(calls.empty());
+    }
+
+    REQUIRE(expire(calls, t0 + 1000s).empty());
+}
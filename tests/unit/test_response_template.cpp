@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "ocpp/charging_point.hpp"
+#include "ocpp/response_template.hpp"
+#include "ocpp/time_utils.hpp"
+
+using namespace ocpp;
+using Slot = ResponseTemplate::Slot;
+
+TEST_CASE("ResponseTemplate: renders the same bytes as serialize_ocpp_json", "[ocpp][template]")
+{
+    ResponseTemplate tmpl(nlohmann::json{
+        {"idTagInfo", {{"status", "Accepted"}, {"expiryDate", ResponseTemplate::placeholder(Slot::ExpiryDate)}}},
+        {"currentTime", ResponseTemplate::placeholder(Slot::CurrentTime)},
+        {"transactionId", ResponseTemplate::placeholder(Slot::TransactionId)}
+    });
+
+    REQUIRE(tmpl.uses(Slot::CurrentTime));
+    REQUIRE(tmpl.uses(Slot::ExpiryDate));
+    REQUIRE(tmpl.uses(Slot::TransactionId));
+
+    ResponseTemplate::Values values;
+    values.current_time   = "2024-01-01T00:00:00.000Z";
+    values.expiry_date    = "2024-01-01T00:05:00.000Z";
+    values.transaction_id = 42;
+
+    std::string out;
+    tmpl.render(out, "uid \"1\"", values);
+
+    auto expected = make_call_result("uid \"1\"", {
+        {"idTagInfo", {{"status", "Accepted"}, {"expiryDate", "2024-01-01T00:05:00.000Z"}}},
+        {"currentTime", "2024-01-01T00:00:00.000Z"},
+        {"transactionId", 42}
+    });
+    REQUIRE(out == serialize_ocpp_json(expected));
+}
+
+TEST_CASE("ResponseTemplate: payload without slots", "[ocpp][template]")
+{
+    ResponseTemplate empty(nlohmann::json::object());
+    REQUIRE_FALSE(empty.uses(Slot::CurrentTime));
+
+    std::string out;
+    empty.render(out, "u1", {});
+    REQUIRE(out == R"([3,"u1",{}])");
+}
+
+TEST_CASE("CSChargingPoint: default responses per OCPP version", "[ocpp][template]")
+{
+    auto request = [](std::string_view action, nlohmann::json payload = nlohmann::json::object()) {
+        auto msg = make_call(action, std::move(payload));
+        msg.unique_id = "req-1";
+        return msg;
+    };
+    auto reply = [](std::string_view frame) {
+        auto msg = parse_ocpp_json(frame);
+        REQUIRE(msg.type == MessageType::CallResult);
+        REQUIRE(msg.unique_id == "req-1");
+        return msg.payload;
+    };
+
+    CSChargingPoint point("CP-1");
+
+    SECTION("1.6") {
+        auto boot = reply(point.send_default_response(request("BootNotification")));
+        REQUIRE(boot["status"] == "Accepted");
+        REQUIRE(boot["interval"] == 60);
+        REQUIRE(parse_iso_time(boot["currentTime"].get<std::string>()) != std::chrono::system_clock::time_point{});
+
+        auto start1 = reply(point.send_default_response(request("StartTransaction")));
+        auto start2 = reply(point.send_default_response(request("StartTransaction")));
+        REQUIRE(start1["idTagInfo"]["status"] == "Accepted");
+        REQUIRE(start1["idTagInfo"].contains("expiryDate"));
+        REQUIRE(start2["transactionId"].get<int>() == start1["transactionId"].get<int>() + 1);
+
+        REQUIRE(reply(point.send_default_response(request("MeterValues"))) == nlohmann::json::object());
+        REQUIRE(point.send_default_response(request("TransactionEvent")).empty());
+    }
+
+    SECTION("2.0.1") {
+        point.set_ocpp_version("2.0.1");
+
+        REQUIRE(reply(point.send_default_response(request("Authorize"))) ==
+                nlohmann::json{{"idTokenInfo", {{"status", "Accepted"}}}});
+        REQUIRE(reply(point.send_default_response(request("TransactionEvent", {{"eventType", "Started"}}))) ==
+                nlohmann::json{{"idTokenInfo", {{"status", "Accepted"}}}});
+        REQUIRE(reply(point.send_default_response(request("TransactionEvent", {{"eventType", "Updated"}}))) ==
+                nlohmann::json::object());
+        REQUIRE(point.send_default_response(request("StartTransaction")).empty());
+    }
+}
+
+// Run with: ocpp_tests "[benchmark]"
+TEST_CASE("ResponseTemplate: Heartbeat reply", "[.][benchmark][template]")
+{
+    ResponseTemplate heartbeat(nlohmann::json{{"currentTime", ResponseTemplate::placeholder(Slot::CurrentTime)}});
+    const std::string unique_id = "0123456789abcdef";
+    const std::string now = iso_time_now();
+    std::string buffer;
+
+    BENCHMARK("DOM + serialize_ocpp_json") {
+        return serialize_ocpp_json(make_call_result(unique_id, {{"currentTime", now}}));
+    };
+
+    BENCHMARK("template render into reused buffer") {
+        buffer.clear();
+        ResponseTemplate::Values values;
+        values.current_time = now;
+        heartbeat.render(buffer, unique_id, values);
+        return buffer.size();
+    };
+}
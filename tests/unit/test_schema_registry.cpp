@@ -0,0 +1,207 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "ocpp/schema_registry.hpp"
+
+#include <fmt/format.h>
+
+#include <fstream>
+#include <unordered_map>
+
+using namespace ocpp;
+
+namespace
+{
+
+const SchemaRegistry& shipped_schemas()
+{
+    static const SchemaRegistry registry = [] {
+        SchemaRegistry r;
+        r.load("1.6", std::filesystem::path(OCPP_SCHEMA_DIR) / "1.6");
+        r.load("2.0.1", std::filesystem::path(OCPP_SCHEMA_DIR) / "2.0.1");
+        return r;
+    }();
+    return registry;
+}
+
+const nlohmann::json kBootNotification16 = {
+    {"chargePointVendor", "Vendor"},
+    {"chargePointModel", "Model"},
+    {"firmwareVersion", "1.0.0"}
+};
+
+} // namespace
+
+TEST_CASE("SchemaRegistry: shipped schemas resolve by version, action and direction", "[ocpp][schema]")
+{
+    const auto& registry = shipped_schemas();
+    REQUIRE(registry.schema_count() > 0);
+
+    REQUIRE(registry.find(OcppVersion::V16, Action::BootNotification, SchemaDirection::Request));
+    REQUIRE(registry.find(OcppVersion::V16, Action::BootNotification, SchemaDirection::Response));
+    REQUIRE(registry.find(OcppVersion::V201, Action::TransactionEvent, SchemaDirection::Request));
+    REQUIRE_FALSE(registry.find(OcppVersion::V16, Action::TransactionEvent, SchemaDirection::Request));
+    REQUIRE_FALSE(registry.find(OcppVersion::V16, Action::Unknown, SchemaDirection::Request));
+
+    REQUIRE(registry.has_schema("1.6", "Heartbeat", "Request"));
+    REQUIRE(registry.has_schema("2.0.1", "NotifyReport", "Response"));
+    REQUIRE_FALSE(registry.has_schema("2.0.1", "StartTransaction", "Request"));
+    REQUIRE_FALSE(registry.has_schema("1.6", "VendorSpecific", "Request"));
+}
+
+TEST_CASE("SchemaRegistry: validate reports violations and passes unknown actions", "[ocpp][schema]")
+{
+    const auto& registry = shipped_schemas();
+
+    REQUIRE_FALSE(registry.validate(OcppVersion::V16, Action::BootNotification,
+                                    SchemaDirection::Request, kBootNotification16));
+
+    auto err = registry.validate(OcppVersion::V16, Action::BootNotification,
+                                 SchemaDirection::Request, nlohmann::json{{"chargePointVendor", "V"}});
+    REQUIRE(err);
+    REQUIRE(err->find("chargePointModel") != std::string::npos);
+
+    // The string form resolves to the same validator
+    REQUIRE(registry.validate("1.6", "BootNotification", "Request", nlohmann::json::object()) ==
+            registry.validate(OcppVersion::V16, Action::BootNotification,
+                              SchemaDirection::Request, nlohmann::json::object()));
+
+    // No schema: passthrough
+    REQUIRE_FALSE(registry.validate("1.6", "VendorSpecific", "Request", nlohmann::json::array()));
+    REQUIRE_FALSE(registry.validate(OcppVersion::V16, Action::Unknown,
+                                    SchemaDirection::Request, nlohmann::json::array()));
+}
+
+TEST_CASE("SchemaRegistry: hot schemas use compiled validators", "[ocpp][schema]")
+{
+    const auto& registry = shipped_schemas();
+
+    for (auto version : {OcppVersion::V16, OcppVersion::V201})
+        for (auto action : {Action::Heartbeat, Action::StatusNotification, Action::MeterValues})
+            for (auto direction : {SchemaDirection::Request, SchemaDirection::Response})
+                REQUIRE(registry.find(version, action, direction).compiled());
+
+    REQUIRE(registry.find(OcppVersion::V201, Action::TransactionEvent, SchemaDirection::Request).compiled());
+    REQUIRE_FALSE(registry.find(OcppVersion::V16, Action::BootNotification, SchemaDirection::Request).compiled());
+}
+
+TEST_CASE("SchemaRegistry: compiled validators report json_validator's error text", "[ocpp][schema]")
+{
+    const auto& registry = shipped_schemas();
+    auto validate = [&](OcppVersion version, Action action, const nlohmann::json& payload) {
+        return registry.validate(version, action, SchemaDirection::Request, payload);
+    };
+
+    nlohmann::json status = {
+        {"connectorId", 1},
+        {"errorCode", "NoError"},
+        {"status", "Available"},
+        {"timestamp", "2024-01-01T00:00:00Z"}
+    };
+    REQUIRE_FALSE(validate(OcppVersion::V16, Action::StatusNotification, status));
+    REQUIRE_FALSE(validate(OcppVersion::V16, Action::Heartbeat, nlohmann::json::object()));
+
+    auto missing = status;
+    missing.erase("connectorId");
+    REQUIRE(validate(OcppVersion::V16, Action::StatusNotification, missing) ==
+            "At  of " + missing.dump() + " - required property 'connectorId' not found in object\n");
+
+    auto wrong_type = status;
+    wrong_type["connectorId"] = "1";
+    REQUIRE(validate(OcppVersion::V16, Action::StatusNotification, wrong_type) ==
+            "At /connectorId of \"1\" - unexpected instance type\n");
+
+    auto bad_enum = status;
+    bad_enum["status"] = "Sleeping";
+    REQUIRE(validate(OcppVersion::V16, Action::StatusNotification, bad_enum) ==
+            "At /status of \"Sleeping\" - instance not found in required enum\n");
+
+    auto too_long = status;
+    too_long["info"] = std::string(51, 'x');
+    REQUIRE(validate(OcppVersion::V16, Action::StatusNotification, too_long) ==
+            "At /info of \"" + std::string(51, 'x') + "\" - instance is too long as per maxLength: 50\n");
+
+    // Code points, not bytes
+    too_long["info"] = "\u00e9" + std::string(49, 'x');
+    REQUIRE_FALSE(validate(OcppVersion::V16, Action::StatusNotification, too_long));
+
+    auto extra = status;
+    extra["vendor"] = "x";
+    REQUIRE(validate(OcppVersion::V16, Action::StatusNotification, extra) ==
+            "At  of " + extra.dump() +
+            " - validation failed for additional property 'vendor': instance invalid as per false-schema\n");
+
+    // Nested pointer through arrays
+    nlohmann::json meter = {
+        {"connectorId", 1},
+        {"meterValue", {{{"timestamp", "2024-01-01T00:00:00Z"},
+                         {"sampledValue", {{{"value", "10"}}, {{"value", 10}}}}}}}
+    };
+    REQUIRE(validate(OcppVersion::V16, Action::MeterValues, meter) ==
+            "At /meterValue/0/sampledValue/1/value of 10 - unexpected instance type\n");
+
+    meter["meterValue"][0]["sampledValue"][1]["value"] = "11";
+    REQUIRE_FALSE(validate(OcppVersion::V16, Action::MeterValues, meter));
+
+    nlohmann::json meter201 = {
+        {"evseId", 1},
+        {"meterValue", {{{"timestamp", "2024-01-01T00:00:00Z"}, {"sampledValue", nlohmann::json::array()}}}}
+    };
+    REQUIRE(validate(OcppVersion::V201, Action::MeterValues, meter201) ==
+            "At /meterValue/0/sampledValue of [] - array has too few items\n");
+}
+
+// Run with: ocpp_tests "[benchmark]"
+TEST_CASE("SchemaRegistry: validator lookup and validate", "[.][benchmark][schema]")
+{
+    const auto& registry = shipped_schemas();
+
+    // Previous layout: "version/ActionDirection" string keys built with fmt::format per call
+    std::unordered_map<std::string, const SchemaRegistry*> by_key;
+    for (std::size_t i = 1; i < kActionCount; ++i) {
+        auto action = static_cast<Action>(i);
+        for (const char* version : {"1.6", "2.0.1"})
+            if (registry.has_schema(version, action_name(action), "Request"))
+                by_key.emplace(fmt::format("{}/{}{}", version, action_name(action), "Request"), &registry);
+    }
+
+    const std::string version = "1.6";
+    const std::string action = "BootNotification";
+    const std::string direction = "Request";
+
+    BENCHMARK("lookup: fmt key + hash map (before)") {
+        return by_key.find(fmt::format("{}/{}{}", version, action, direction)) != by_key.end();
+    };
+
+    BENCHMARK("lookup: interned action table (after)") {
+        return static_cast<bool>(registry.find(OcppVersion::V16, Action::BootNotification,
+                                               SchemaDirection::Request));
+    };
+
+    BENCHMARK("validate: string API") {
+        return registry.validate(version, action, direction, kBootNotification16);
+    };
+
+    BENCHMARK("validate: resolved handle") {
+        return registry.validate(OcppVersion::V16, Action::BootNotification,
+                                 SchemaDirection::Request, kBootNotification16);
+    };
+    // Same StatusNotification schema through both validators
+    SchemaRegistry::Validator generic;
+    generic.set_root_schema(nlohmann::json::parse(
+        std::ifstream(std::filesystem::path(OCPP_SCHEMA_DIR) / "1.6" / "StatusNotification.json")));
+    const auto compiled = registry.find(OcppVersion::V16, Action::StatusNotification, SchemaDirection::Request);
+    const nlohmann::json status = {
+        {"connectorId", 1},
+        {"errorCode", "NoError"},
+        {"status", "Charging"},
+        {"timestamp", "2024-01-01T00:00:00Z"}
+    };
+
+    BENCHMARK("validate StatusNotification: json_validator") {
+        generic.validate(status);
+    };
+
+    BENCHMARK("validate StatusNotification: compiled") {
+        return compiled.validate(status);
+    };
+}
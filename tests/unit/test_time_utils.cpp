@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "ocpp/time_utils.hpp"
+
+#include <fmt/format.h>
+
+#include <ctime>
+
+using namespace ocpp;
+using namespace std::chrono;
+
+namespace
+{
+
+system_clock::time_point at(int64_t unix_ms)
+{
+    return system_clock::time_point(milliseconds(unix_ms));
+}
+
+// Previous implementation, kept as the reference for the formatter
+std::string reference_format(system_clock::time_point tp)
+{
+    auto tt = system_clock::to_time_t(tp);
+    auto ms = duration_cast<milliseconds>(tp.time_since_epoch()) % 1000;
+
+    std::tm utc{};
+    gmtime_r(&tt, &utc);
+
+    return fmt::format("{:04d}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}.{:03d}Z",
+        utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+        utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(ms.count()));
+}
+
+} // namespace
+
+TEST_CASE("format_iso_time: matches gmtime_r formatting", "[ocpp][time]")
+{
+    IsoTimeBuffer buf;
+
+    REQUIRE(format_iso_time(at(0), buf) == "1970-01-01T00:00:00.000Z");
+    REQUIRE(format_iso_time(at(951782400123), buf) == "2000-02-29T00:00:00.123Z");
+    REQUIRE(format_iso_time(at(1704067199999), buf) == "2023-12-31T23:59:59.999Z");
+
+    // Same second twice (cached prefix), then the next second
+    REQUIRE(format_iso_time(at(1704067200001), buf) == "2024-01-01T00:00:00.001Z");
+    REQUIRE(format_iso_time(at(1704067200999), buf) == "2024-01-01T00:00:00.999Z");
+    REQUIRE(format_iso_time(at(1704067201000), buf) == "2024-01-01T00:00:01.000Z");
+
+    for (int64_t ms = 0; ms < 86400000LL * 366 * 120; ms += 86400000LL * 7 + 3601007)
+        REQUIRE(format_iso_time(at(ms), buf) == reference_format(at(ms)));
+
+    // Before the epoch (the old formatter printed negative milliseconds here)
+    REQUIRE(format_iso_time(at(-1), buf) == "1969-12-31T23:59:59.999Z");
+
+    std::string out = "ts=";
+    append_iso_time(out, at(0));
+    REQUIRE(out == "ts=1970-01-01T00:00:00.000Z");
+
+    REQUIRE(iso_time_now().size() == kIsoTimeLength);
+}
+
+TEST_CASE("parse_rfc3339: keeps milliseconds and applies offsets", "[ocpp][time]")
+{
+    REQUIRE(parse_rfc3339("2024-01-01T00:00:00Z") == at(1704067200000));
+    REQUIRE(parse_rfc3339("2024-01-01T00:00:00.123Z") == at(1704067200123));
+    REQUIRE(parse_rfc3339("2024-01-01t00:00:00.5z") == at(1704067200500));
+    REQUIRE(parse_rfc3339("2024-01-01 02:30:00+02:30") == at(1704067200000));
+    REQUIRE(parse_rfc3339("2023-12-31T19:00:00.250-05:00") == at(1704067200250));
+    REQUIRE(parse_rfc3339("2024-02-29T12:00:00Z"));
+    REQUIRE(parse_rfc3339("1969-12-31T23:59:59.999Z") == at(-1));
+
+    // Sub-millisecond digits are kept to the clock's precision
+    REQUIRE(parse_rfc3339("2024-01-01T00:00:00.000001Z") ==
+            at(1704067200000) + duration_cast<system_clock::duration>(microseconds(1)));
+
+    // No offset: read as UTC
+    REQUIRE(parse_rfc3339("2024-01-01T00:00:00") == at(1704067200000));
+
+    // Round trip with the formatter
+    IsoTimeBuffer buf;
+    REQUIRE(parse_rfc3339(format_iso_time(at(1718900123456), buf)) == at(1718900123456));
+}
+
+TEST_CASE("parse_rfc3339: rejects malformed input", "[ocpp][time]")
+{
+    for (const char* bad : {"", "2024", "2024-01-01", "2024-01-01T00:00", "2024-13-01T00:00:00Z",
+                            "2023-02-29T00:00:00Z", "2024-04-31T00:00:00Z", "2024-01-01T24:00:00Z",
+                            "2024-01-01T00:00:00.Z", "2024-01-01T00:00:00+0200", "2024-01-01T00:00:00Zx",
+                            "2024-01-01X00:00:00Z", "24-01-01T00:00:00Z"})
+        REQUIRE_FALSE(parse_rfc3339(bad));
+
+    REQUIRE(parse_iso_time("not a date") == system_clock::time_point{});
+}
+
+// Run with: ocpp_tests "[benchmark]"
+TEST_CASE("Time: format and parse", "[.][benchmark][time]")
+{
+    const std::string text = "2024-06-20T16:15:23.456+02:00";
+
+    BENCHMARK("format now: gmtime_r + fmt::format (before)") {
+        return reference_format(system_clock::now());
+    };
+
+    BENCHMARK("format now: cached prefix into buffer") {
+        IsoTimeBuffer buf;
+        return format_iso_time(system_clock::now(), buf)[23];
+    };
+
+    BENCHMARK("iso_time_now() string") {
+        return iso_time_now();
+    };
+
+    BENCHMARK("parse: strptime + timegm (before)") {
+        std::tm tm{};
+        strptime(text.c_str(), "%Y-%m-%dT%H:%M:%S", &tm);
+        return timegm(&tm);
+    };
+
+    BENCHMARK("parse: parse_rfc3339") {
+        return parse_rfc3339(text);
+    };
+}
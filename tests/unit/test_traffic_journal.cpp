@@ -0,0 +1,162 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/traffic_journal.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace ocpp;
+using namespace std::chrono_literals;
+using Record = TrafficJournal::Record;
+
+namespace
+{
+
+struct TempDir {
+    std::string path;
+
+    TempDir()
+    {
+        char name[] = "/tmp/ocpp_journal_XXXXXX";
+        path = ::mkdtemp(name);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+
+    std::size_t files() const
+    {
+        std::size_t n = 0;
+        for ([[maybe_unused]] const auto& entry : std::filesystem::directory_iterator(path))
+            ++n;
+        return n;
+    }
+};
+
+const TrafficJournal::time_point kStart = TrafficJournal::time_point{} + 1'700'000'000s;
+
+Record frame(std::string_view identity, int second, std::string_view payload = R"({"a":1})")
+{
+    Record r;
+    r.time      = kStart + std::chrono::seconds(second);
+    r.identity  = identity;
+    r.direction = LogDirection::In;
+    r.type      = MessageType::Call;
+    r.action    = Action::Heartbeat;
+    r.unique_id = "u-" + std::string(identity);   // copied on append
+    r.payload   = payload;
+    return r;
+}
+
+std::vector<std::string> read_all(const std::string& dir, const TrafficJournal::Query& query = {})
+{
+    std::vector<std::string> out;
+    TrafficJournal::read(dir, query, [&](const Record& r) {
+        out.push_back(std::string(r.identity) + "@" +
+                      std::to_string(std::chrono::duration_cast<std::chrono::seconds>(r.time - kStart).count()));
+    });
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("TrafficJournal: records read back as written", "[ocpp][journal]")
+{
+    TempDir dir;
+    {
+        TrafficJournal journal({dir.path, 1 << 20, 4});
+        Record r = frame("CP1", 0, R"({"currentTime":"x"})");
+        std::string uid = "42";
+        r.unique_id = uid;
+        r.direction = LogDirection::Out;
+        r.type      = MessageType::CallResult;
+        r.action    = Action::BootNotification;
+        journal.append(r);
+        journal.append(frame("CP2", 1));
+        REQUIRE(journal.counters().records == 2);
+    }
+
+    std::vector<std::string> entries;
+    auto result = TrafficJournal::read(dir.path, {}, [&](const Record& r) {
+        std::string entry;
+        append_log_event(entry, to_log_event(r));
+        entries.push_back(entry);
+    });
+    REQUIRE(result.visited == 2);
+    REQUIRE(result.complete);
+
+    auto first = nlohmann::json::parse(entries[0]);
+    REQUIRE(first == nlohmann::json{{"action", "BootNotification"}, {"direction", "out"}, {"identity", "CP1"},
+                                    {"messageType", "CallResult"}, {"payload", {{"currentTime", "x"}}},
+                                    {"ts", "2023-11-14T22:13:20.000Z"}, {"uniqueId", "42"}});
+    REQUIRE(nlohmann::json::parse(entries[1])["identity"] == "CP2");
+}
+
+TEST_CASE("TrafficJournal: time and identity ranges", "[ocpp][journal]")
+{
+    TempDir dir;
+    {
+        TrafficJournal journal({dir.path, 1 << 20, 4});
+        for (int i = 0; i < 10; ++i)
+            journal.append(frame(i % 2 ? "CP-odd" : "CP-even", i));
+    }
+
+    TrafficJournal::Query query;
+    query.from = kStart + 3s;
+    query.to   = kStart + 6s;
+    REQUIRE(read_all(dir.path, query) == std::vector<std::string>{"CP-odd@3", "CP-even@4", "CP-odd@5", "CP-even@6"});
+
+    query.identity = "CP-even";
+    REQUIRE(read_all(dir.path, query) == std::vector<std::string>{"CP-even@4", "CP-even@6"});
+
+    // The scan budget stops the read, and says so
+    TrafficJournal::Query bounded;
+    bounded.max_scan = 200;
+    auto result = TrafficJournal::read(dir.path, bounded, [](const Record&) {});
+    REQUIRE_FALSE(result.complete);
+    REQUIRE(result.visited < 10);
+}
+
+TEST_CASE("TrafficJournal: rotation keeps the newest segments readable", "[ocpp][journal]")
+{
+    TempDir dir;
+    const std::string payload(1000, 'x');
+    const std::string json = "\"" + payload + "\"";
+
+    TrafficJournal journal({dir.path, 64 * 1024, 3});
+    for (int i = 0; i < 300; ++i)
+        journal.append(frame(i == 0 ? "CP-first" : "CP", i, json));
+
+    // ~60 records per 64 KiB segment
+    REQUIRE(journal.counters().segments >= 5);
+    REQUIRE(dir.files() == 3);
+
+    // Every segment defines its own identities; CP-first's segment is gone
+    auto entries = read_all(dir.path);   // the open segment is readable too
+    REQUIRE(!entries.empty());
+    REQUIRE(entries.back() == "CP@299");
+    for (const auto& e : entries)
+        REQUIRE(e.starts_with("CP@"));
+
+    // A record larger than a segment gets its own
+    journal.append(frame("CP-big", 400, "\"" + std::string(100 * 1024, 'y') + "\""));
+    TrafficJournal::Query query;
+    query.identity = "CP-big";
+    REQUIRE(read_all(dir.path, query) == std::vector<std::string>{"CP-big@400"});
+    REQUIRE(journal.counters().dropped == 0);
+}
+
+TEST_CASE("TrafficJournal: foreign files are ignored", "[ocpp][journal]")
+{
+    TempDir dir;
+    { std::FILE* f = std::fopen((dir.path + "/journal-0000000000000001-1.ocj").c_str(), "w");
+      std::fputs("not a journal, but long enough to hold a header......", f);
+      std::fclose(f); }
+    { std::FILE* f = std::fopen((dir.path + "/notes.txt").c_str(), "w"); std::fclose(f); }
+
+    TrafficJournal journal({dir.path, 1 << 20, 8});
+    journal.append(frame("CP1", 0));
+    REQUIRE(read_all(dir.path) == std::vector<std::string>{"CP1@0"});
+    REQUIRE(read_all(dir.path + "/missing").empty());
+}
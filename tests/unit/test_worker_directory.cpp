@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ocpp/worker_directory.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ocpp;
+
+namespace
+{
+
+struct ScopedDirectory {
+    std::string     name = fmt::format("/ocpp-test-directory.{}", ::getpid());
+    WorkerDirectory dir;
+
+    explicit ScopedDirectory(std::size_t capacity = 64, pid_t master = ::getppid())
+    {
+        WorkerDirectory::unlink(name);
+        dir.open(name, capacity, master);
+    }
+
+    ~ScopedDirectory() { WorkerDirectory::unlink(name); }
+};
+
+} // namespace
+
+TEST_CASE("WorkerDirectory: claim, lookup and release", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+    const pid_t self = ::getpid();
+
+    REQUIRE(d.dir.owner("CP1") == 0);
+    REQUIRE(d.dir.claim("CP1", self));
+    REQUIRE(d.dir.owner("CP1") == self);
+    REQUIRE(d.dir.owner("CP2") == 0);
+
+    d.dir.release("CP1", self);
+    REQUIRE(d.dir.owner("CP1") == 0);
+
+    // Reclaiming a released identity reuses its slot
+    REQUIRE(d.dir.claim("CP1", self));
+    REQUIRE(d.dir.owner("CP1") == self);
+}
+
+TEST_CASE("WorkerDirectory: release by a previous owner is ignored", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+    const pid_t self = ::getpid();
+    const pid_t parent = ::getppid();
+
+    REQUIRE(d.dir.claim("CP1", parent));
+    REQUIRE(d.dir.claim("CP1", self));   // station reconnected to another worker
+    d.dir.release("CP1", parent);        // old worker notices its socket closed
+    REQUIRE(d.dir.owner("CP1") == self);
+}
+
+TEST_CASE("WorkerDirectory: entries are shared between mappings", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+
+    WorkerDirectory other;
+    other.open(d.name, 1024, ::getppid());      // capacity comes from the segment
+    REQUIRE(other.capacity() == d.dir.capacity());
+
+    REQUIRE(d.dir.claim("STRK-ION-001", ::getpid()));
+    REQUIRE(other.owner("STRK-ION-001") == ::getpid());
+}
+
+TEST_CASE("WorkerDirectory: dead owners and foreign masters are not reported", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+
+    pid_t child = ::fork();
+    if (child == 0)
+        ::_exit(0);
+    ::waitpid(child, nullptr, 0);
+
+    REQUIRE(d.dir.claim("CP1", child));
+    REQUIRE(d.dir.owner("CP1") == 0);
+
+    WorkerDirectory restarted;
+    restarted.open(d.name, 64, ::getppid() + 1);
+    REQUIRE(d.dir.claim("CP2", ::getpid()));
+    REQUIRE(restarted.owner("CP2") == 0);
+}
+
+TEST_CASE("WorkerDirectory: owners lists each live worker once", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+    const pid_t self = ::getpid();
+    const pid_t parent = ::getppid();
+
+    REQUIRE(d.dir.owners().empty());
+
+    pid_t child = ::fork();
+    if (child == 0)
+        ::_exit(0);
+    ::waitpid(child, nullptr, 0);
+
+    REQUIRE(d.dir.claim("CP1", self));
+    REQUIRE(d.dir.claim("CP2", self));
+    REQUIRE(d.dir.claim("CP3", parent));
+    REQUIRE(d.dir.claim("CP4", child));      // exited
+    REQUIRE(d.dir.claim("CP5", self));
+    d.dir.release("CP5", self);
+
+    auto owners = d.dir.owners();
+    std::sort(owners.begin(), owners.end());
+    std::vector<pid_t> expected = {self, parent};
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(owners == expected);
+}
+
+TEST_CASE("WorkerDirectory: full table and oversized identities", "[ocpp][directory]")
+{
+    ScopedDirectory d(4);
+    const pid_t self = ::getpid();
+
+    REQUIRE(d.dir.capacity() == 4);
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(d.dir.claim(fmt::format("CP{}", i), self));
+    REQUIRE_FALSE(d.dir.claim("CP4", self));
+    REQUIRE(d.dir.owner("CP3") == self);
+
+    REQUIRE_FALSE(d.dir.claim(std::string(WorkerDirectory::kMaxIdentity + 1, 'x'), self));
+}
+
+TEST_CASE("WorkerDirectory: workers lists joined live workers", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+    const pid_t self = ::getpid();
+    const pid_t parent = ::getppid();
+
+    REQUIRE(d.dir.workers().empty());
+
+    pid_t child = ::fork();
+    if (child == 0)
+        ::_exit(0);
+    ::waitpid(child, nullptr, 0);
+
+    REQUIRE(d.dir.join(self));
+    REQUIRE(d.dir.join(self));          // joining twice keeps one entry
+    REQUIRE(d.dir.join(parent));
+    REQUIRE(d.dir.join(child));         // exited
+    REQUIRE(d.dir.claim("CP1", self));  // owning a station is not required
+
+    auto workers = d.dir.workers();
+    std::sort(workers.begin(), workers.end());
+    std::vector<pid_t> expected = {self, parent};
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(workers == expected);
+
+    d.dir.leave(parent);
+    REQUIRE(d.dir.workers() == std::vector<pid_t>{self});
+
+    WorkerDirectory restarted;
+    restarted.open(d.name, 64, parent + 1);
+    REQUIRE(restarted.workers().empty());
+}
+
+TEST_CASE("WorkerDirectory: worker entries of another master are reused", "[ocpp][directory]")
+{
+    ScopedDirectory d;
+
+    WorkerDirectory previous;
+    previous.open(d.name, 64, ::getppid() + 1);
+    for (std::size_t i = 0; i < WorkerDirectory::kMaxWorkers; ++i)
+        REQUIRE(previous.join(static_cast<pid_t>(i + 1)));
+
+    REQUIRE(d.dir.join(::getpid()));
+    REQUIRE(d.dir.workers() == std::vector<pid_t>{::getpid()});
+}
+
+TEST_CASE("WorkerDirectory: create replaces a segment of another size", "[ocpp][directory]")
+{
+    ScopedDirectory d(4);
+    REQUIRE(d.dir.claim("CP1", ::getpid()));
+
+    WorkerDirectory::create(d.name, 128);
+
+    WorkerDirectory fresh;
+    fresh.open(d.name, 4, ::getppid());
+    REQUIRE(fresh.capacity() == 128);
+    REQUIRE(fresh.owner("CP1") == 0);
+
+    // The old mapping is detached from the name, not cleared
+    REQUIRE(d.dir.owner("CP1") == ::getpid());
+}